@@ -0,0 +1,441 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CARRAY_CPP_INCLUDED
+#define SCRATCH_CARRAY_CPP_INCLUDED
+
+#include "CArray.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new> // for placement new and bad_alloc
+
+SCRATCH_NAMESPACE_BEGIN;
+
+template<class Type>
+Array<Type>::Array()
+{
+  // memory is only allocated once something is pushed
+  arr_pItems = NULL;
+  arr_ctSlots = 0;
+  arr_ctUsed = 0;
+  arr_pInline = NULL;
+  arr_ctInline = 0;
+}
+
+template<class Type>
+Array<Type>::Array(Type* pInline, INDEX ctInline)
+{
+  // nothing is allocated until the inline slots run out
+  arr_pItems = pInline;
+  arr_ctSlots = ctInline;
+  arr_ctUsed = 0;
+  arr_pInline = pInline;
+  arr_ctInline = ctInline;
+}
+
+template<class Type>
+Array<Type>::Array(const Array<Type> &copy)
+{
+  arr_pItems = NULL;
+  arr_ctSlots = 0;
+  arr_ctUsed = 0;
+  arr_pInline = NULL;
+  arr_ctInline = 0;
+  *this = copy;
+}
+
+template<class Type>
+Array<Type>::Array(Array<Type> &&move)
+{
+  arr_pItems = NULL;
+  arr_ctSlots = 0;
+  arr_ctUsed = 0;
+  arr_pInline = NULL;
+  arr_ctInline = 0;
+  *this = std::move(move);
+}
+
+template<class Type>
+Array<Type>::~Array()
+{
+  Free();
+}
+
+template<class Type>
+Array<Type>& Array<Type>::operator=(const Array<Type> &copy)
+{
+  if(this == &copy) {
+    return *this;
+  }
+
+  Clear();
+  Reserve(copy.arr_ctUsed);
+
+  if(arr_bTrivial) {
+    // copy all objects in one go
+    if(copy.arr_ctUsed > 0) {
+      memcpy((void*)arr_pItems, (const void*)copy.arr_pItems, sizeof(Type) * copy.arr_ctUsed);
+    }
+  } else {
+    for(INDEX i=0; i<copy.arr_ctUsed; i++) {
+      new(arr_pItems + i) Type(copy.arr_pItems[i]);
+    }
+  }
+  arr_ctUsed = copy.arr_ctUsed;
+
+  return *this;
+}
+
+template<class Type>
+Array<Type>& Array<Type>::operator=(Array<Type> &&move)
+{
+  if(this == &move) {
+    return *this;
+  }
+
+  if(move.HasHeapMemory()) {
+    // take over the memory of the other array
+    Free();
+    arr_pItems = move.arr_pItems;
+    arr_ctSlots = move.arr_ctSlots;
+    arr_ctUsed = move.arr_ctUsed;
+
+    // and leave it empty, back in its own inline slots
+    move.arr_pItems = move.arr_pInline;
+    move.arr_ctSlots = move.arr_ctInline;
+    move.arr_ctUsed = 0;
+    return *this;
+  }
+
+  // inline objects can't be taken over, so move them one by one into whatever room we have
+  Clear();
+  Reserve(move.arr_ctUsed);
+  if(arr_bTrivial) {
+    if(move.arr_ctUsed > 0) {
+      memcpy((void*)arr_pItems, (const void*)move.arr_pItems, sizeof(Type) * move.arr_ctUsed);
+    }
+  } else {
+    for(INDEX i=0; i<move.arr_ctUsed; i++) {
+      new(arr_pItems + i) Type(std::move(move.arr_pItems[i]));
+    }
+  }
+  arr_ctUsed = move.arr_ctUsed;
+  move.Clear();
+
+  return *this;
+}
+
+template<class Type>
+void Array<Type>::Grow(INDEX ctSlots)
+{
+  // grow geometrically, so pushing one by one only reallocates a logarithmic amount of times
+  INDEX ctNewSlots = Max(arr_ctSlots * 2, (INDEX)16);
+  if(ctNewSlots < ctSlots) {
+    ctNewSlots = ctSlots;
+  }
+  Reserve(ctNewSlots);
+}
+
+template<class Type>
+void Array<Type>::MoveTo(Type* pNewItems, INDEX ctNewSlots)
+{
+  // move the objects over to the new memory
+  if(arr_bTrivial) {
+    if(arr_ctUsed > 0) {
+      memcpy((void*)pNewItems, (const void*)arr_pItems, sizeof(Type) * arr_ctUsed);
+    }
+  } else {
+    for(INDEX i=0; i<arr_ctUsed; i++) {
+      new(pNewItems + i) Type(std::move(arr_pItems[i]));
+      arr_pItems[i].~Type();
+    }
+  }
+
+  // the inline slots are never freed
+  if(HasHeapMemory()) {
+    free(arr_pItems);
+  }
+  arr_pItems = pNewItems;
+  arr_ctSlots = ctNewSlots;
+}
+
+template<class Type>
+void Array<Type>::Reserve(INDEX ctSlots)
+{
+  if(ctSlots <= arr_ctSlots) {
+    return;
+  }
+
+  if(arr_bTrivial && HasHeapMemory()) {
+    // realloc can often grow the block in place, and copies the objects over when it can't.
+    // When it fails the old block is left alone, so keep it until we know it was replaced.
+    Type* pNewItems = (Type*)realloc((void*)arr_pItems, sizeof(Type) * ctSlots);
+    if(pNewItems == NULL) {
+      throw std::bad_alloc();
+    }
+    arr_pItems = pNewItems;
+    arr_ctSlots = ctSlots;
+    return;
+  }
+
+  Type* pNewItems = (Type*)malloc(sizeof(Type) * ctSlots);
+  if(pNewItems == NULL) {
+    throw std::bad_alloc();
+  }
+  MoveTo(pNewItems, ctSlots);
+}
+
+template<class Type>
+void Array<Type>::ShrinkToFit(void)
+{
+  if(!HasHeapMemory() || arr_ctUsed == arr_ctSlots) {
+    return;
+  }
+
+  // go back to the inline slots when everything fits, which leaves an empty array without any at no memory
+  if(arr_ctUsed <= arr_ctInline) {
+    MoveTo(arr_pInline, arr_ctInline);
+    return;
+  }
+
+  Type* pNewItems = (Type*)malloc(sizeof(Type) * arr_ctUsed);
+  if(pNewItems == NULL) {
+    throw std::bad_alloc();
+  }
+  MoveTo(pNewItems, arr_ctUsed);
+}
+
+template<class Type>
+void Array<Type>::Free(void)
+{
+  Clear();
+
+  // free allocated memory for data
+  if(HasHeapMemory()) {
+    free(arr_pItems);
+  }
+  arr_pItems = arr_pInline;
+  arr_ctSlots = arr_ctInline;
+}
+
+/// Push to the beginning of the array, return a reference to the newly made object
+template<class Type>
+Type& Array<Type>::PushBegin(void)
+{
+  if(arr_ctUsed >= arr_ctSlots) {
+    Grow(arr_ctUsed + 1);
+  }
+
+  // make some room
+  if(arr_bTrivial) {
+    memmove((void*)(arr_pItems + 1), (const void*)arr_pItems, sizeof(Type) * arr_ctUsed);
+  } else if(arr_ctUsed > 0) {
+    new(arr_pItems + arr_ctUsed) Type(std::move(arr_pItems[arr_ctUsed - 1]));
+    for(INDEX i=arr_ctUsed - 1; i>0; i--) {
+      arr_pItems[i] = std::move(arr_pItems[i - 1]);
+    }
+    arr_pItems[0].~Type();
+  }
+  arr_ctUsed++;
+
+  // create the new object at the beginning
+  return *new(arr_pItems) Type();
+}
+
+/// Push to the array, return a reference to the newly made object
+template<class Type>
+Type& Array<Type>::Push(void)
+{
+  if(arr_ctUsed >= arr_ctSlots) {
+    Grow(arr_ctUsed + 1);
+  }
+  return *new(arr_pItems + arr_ctUsed++) Type();
+}
+
+/// Copy an object onto the array, return a reference to the newly made object
+template<class Type>
+Type& Array<Type>::Push(const Type &obj)
+{
+  if(arr_ctUsed >= arr_ctSlots) {
+    // the object might be one of ours, so copy it before the memory moves
+    Type tCopy(obj);
+    Grow(arr_ctUsed + 1);
+    return *new(arr_pItems + arr_ctUsed++) Type(std::move(tCopy));
+  }
+  return *new(arr_pItems + arr_ctUsed++) Type(obj);
+}
+
+/// Move an object onto the array, return a reference to the newly made object
+template<class Type>
+Type& Array<Type>::Push(Type &&obj)
+{
+  if(arr_ctUsed >= arr_ctSlots) {
+    // the object might be one of ours, so take it out before the memory moves
+    Type tMoved(std::move(obj));
+    Grow(arr_ctUsed + 1);
+    return *new(arr_pItems + arr_ctUsed++) Type(std::move(tMoved));
+  }
+  return *new(arr_pItems + arr_ctUsed++) Type(std::move(obj));
+}
+
+/// Pop the top object from the array
+template<class Type>
+Type Array<Type>::Pop(void)
+{
+  ASSERT(arr_ctUsed > 0);
+
+  arr_ctUsed--;
+  Type tObject(std::move(arr_pItems[arr_ctUsed]));
+  arr_pItems[arr_ctUsed].~Type();
+  return tObject;
+}
+
+/// Pop a certain index from the array, moving the objects after it down
+template<class Type>
+Type Array<Type>::PopAt(INDEX iIndex)
+{
+  ASSERT(iIndex >= 0 && iIndex < arr_ctUsed);
+
+  Type tObject(std::move(arr_pItems[iIndex]));
+  arr_ctUsed--;
+
+  // close the gap
+  if(arr_bTrivial) {
+    memmove((void*)(arr_pItems + iIndex), (const void*)(arr_pItems + iIndex + 1), sizeof(Type) * (arr_ctUsed - iIndex));
+  } else {
+    for(INDEX i=iIndex; i<arr_ctUsed; i++) {
+      arr_pItems[i] = std::move(arr_pItems[i + 1]);
+    }
+    arr_pItems[arr_ctUsed].~Type();
+  }
+
+  return tObject;
+}
+
+/// Remove every object the condition holds for in a single pass, return how many were removed
+template<class Type>
+template<typename Func>
+INDEX Array<Type>::RemoveIf(Func f)
+{
+  // keep the objects that stay in order, moving them over the removed ones
+  INDEX iKeep = 0;
+  for(INDEX i=0; i<arr_ctUsed; i++) {
+    if(f(arr_pItems[i])) {
+      continue;
+    }
+    if(iKeep != i) {
+      arr_pItems[iKeep] = std::move(arr_pItems[i]);
+    }
+    iKeep++;
+  }
+
+  // then destroy what's left over at the end
+  INDEX ctRemoved = arr_ctUsed - iKeep;
+  if(!arr_bTrivial) {
+    for(INDEX i=iKeep; i<arr_ctUsed; i++) {
+      arr_pItems[i].~Type();
+    }
+  }
+  arr_ctUsed = iKeep;
+
+  return ctRemoved;
+}
+
+/// Destroy all objects in the array, keeping the memory around for reuse
+template<class Type>
+void Array<Type>::Clear(void)
+{
+  if(!arr_bTrivial) {
+    for(INDEX i=0; i<arr_ctUsed; i++) {
+      arr_pItems[i].~Type();
+    }
+  }
+  arr_ctUsed = 0;
+}
+
+/// Find the index of the given object in the array
+template<class Type>
+INDEX Array<Type>::Find(const Type &obj) const
+{
+  for(INDEX i=0; i<arr_ctUsed; i++) {
+    if(obj == arr_pItems[i]) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/// Find the index of the object at the given address in the array
+template<class Type>
+INDEX Array<Type>::FindPointer(const Type* pObj) const
+{
+  for(INDEX i=0; i<arr_ctUsed; i++) {
+    if(arr_pItems + i == pObj) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/// Find the index of the given condition in the array
+template<class Type>
+template<typename Func>
+INDEX Array<Type>::FindAny(Func f)
+{
+  for(INDEX i=0; i<arr_ctUsed; i++) {
+    if(f(arr_pItems[i])) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/// Returns whether the given object is currently in the array
+template<class Type>
+BOOL Array<Type>::Contains(const Type &obj) const
+{
+  return Find(obj) != -1;
+}
+
+/// Returns whether the object at the given address is currently in the array
+template<class Type>
+BOOL Array<Type>::ContainsPointer(const Type* pObj) const
+{
+  return FindPointer(pObj) != -1;
+}
+
+/// Returns whether the given condition is currently in the array
+template<class Type>
+template<typename Func>
+BOOL Array<Type>::ContainsAny(Func f)
+{
+  return FindAny(f) != -1;
+}
+
+SCRATCH_NAMESPACE_END;
+
+#endif
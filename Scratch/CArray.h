@@ -0,0 +1,150 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CARRAY_H_INCLUDED
+#define SCRATCH_CARRAY_H_INCLUDED
+
+#include "Common.h"
+
+#include <type_traits>
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/// Array that stores its objects next to each other, rather than a pointer to each of them like
+/// StackArray does. Pushing doesn't allocate until the capacity runs out, and walking over the
+/// objects doesn't chase pointers. Objects move when the array grows, so don't hold on to pointers
+/// or references to them while pushing. Like StackArray, it is not locked, so use ConcurrentArray for
+/// objects pushed from multiple threads.
+template<class Type>
+class SCRATCH_EXPORT Array
+{
+public:
+  Type* arr_pItems;
+  INDEX arr_ctSlots;
+  INDEX arr_ctUsed;
+
+protected:
+  Type* arr_pInline; // slots owned by a derived class that are used before any heap memory, or NULL
+  INDEX arr_ctInline;
+
+  /// Start out in the given slots, which are never freed. Used by SmallArray.
+  Array(Type* pInline, INDEX ctInline);
+
+public:
+  Array(void);
+  Array(const Array<Type> &copy);
+  Array(Array<Type> &&move);
+  ~Array(void);
+
+  Array<Type>& operator=(const Array<Type> &copy);
+  /// Take over the objects of another array, clearing this one first
+  Array<Type>& operator=(Array<Type> &&move);
+
+  /// Push to the beginning of the array, return a reference to the newly made object
+  Type& PushBegin(void);
+  /// Push to the array, return a reference to the newly made object
+  Type& Push(void);
+  /// Copy an object onto the array, return a reference to the newly made object
+  Type& Push(const Type &obj);
+  /// Move an object onto the array, return a reference to the newly made object
+  Type& Push(Type &&obj);
+  /// Pop the top object from the array
+  Type Pop(void);
+  /// Pop a certain index from the array, moving the objects after it down
+  Type PopAt(INDEX iIndex);
+
+  /// Remove every object the condition holds for in a single pass, return how many were removed
+  template<typename Func>
+  INDEX RemoveIf(Func f);
+
+  /// Destroy all objects in the array, keeping the memory around for reuse
+  void Clear(void);
+
+  /// Return how many objects there currently are in the array
+  inline INDEX Count(void) const { return arr_ctUsed; }
+  /// Return how many objects the array can hold without reallocating
+  inline INDEX Capacity(void) const { return arr_ctSlots; }
+  /// Make sure the array can hold at least the given amount of objects without reallocating
+  void Reserve(INDEX ctSlots);
+  /// Give back any heap memory the array currently doesn't use
+  void ShrinkToFit(void);
+  /// Return a pointer to the first object, the others follow right after it
+  inline Type* Data(void) { return arr_pItems; }
+  inline const Type* Data(void) const { return arr_pItems; }
+
+  /// Find the index of the given object in the array
+  INDEX Find(const Type &obj) const;
+  /// Find the index of the object at the given address in the array
+  INDEX FindPointer(const Type* pObj) const;
+  /// Find the index of the given condition in the array
+  template<typename Func>
+  INDEX FindAny(Func f);
+
+  /// Returns whether the given object is currently in the array
+  BOOL Contains(const Type &obj) const;
+  /// Returns whether the object at the given address is currently in the array
+  BOOL ContainsPointer(const Type* pObj) const;
+  /// Returns whether the given condition is currently in the array
+  template<typename Func>
+  BOOL ContainsAny(Func f);
+
+  inline Type& operator[](INDEX iIndex)
+  {
+    ASSERT(iIndex >= 0 && iIndex < arr_ctUsed);
+    return arr_pItems[iIndex];
+  }
+
+  inline const Type& operator[](INDEX iIndex) const
+  {
+    ASSERT(iIndex >= 0 && iIndex < arr_ctUsed);
+    return arr_pItems[iIndex];
+  }
+
+  /// Pointer to the first object, for range-for loops
+  inline Type* begin(void) { return arr_pItems; }
+  inline const Type* begin(void) const { return arr_pItems; }
+  /// Pointer after the last object
+  inline Type* end(void) { return arr_pItems + arr_ctUsed; }
+  inline const Type* end(void) const { return arr_pItems + arr_ctUsed; }
+
+protected:
+  /// Destroy all objects and give back the heap memory, going back to the inline slots if there are any
+  void Free(void);
+
+private:
+  /// Objects that can be copied with memcpy can also be moved around with realloc and memmove
+  static const bool arr_bTrivial = std::is_trivially_copyable<Type>::value;
+
+  inline bool HasHeapMemory(void) const { return arr_pItems != arr_pInline; }
+  void Grow(INDEX ctSlots);
+  void MoveTo(Type* pNewItems, INDEX ctNewSlots);
+};
+
+SCRATCH_NAMESPACE_END;
+
+#include "CArray.cpp"
+
+#endif // include once check
@@ -0,0 +1,227 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CCONCURRENTARRAY_CPP_INCLUDED
+#define SCRATCH_CCONCURRENTARRAY_CPP_INCLUDED
+
+#include "CConcurrentArray.h"
+
+#include <cstdlib>
+#include <new> // for placement new and bad_alloc
+#include <stdexcept> // for length_error
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+SCRATCH_NAMESPACE_BEGIN;
+
+template<class Type>
+ConcurrentArray<Type>::ConcurrentArray()
+{
+  // segments are only allocated once something is pushed into them
+  for(INDEX i=0; i<CCONCURRENTARRAY_SEGMENTS; i++) {
+    ca_apSegments[i].store(NULL, std::memory_order_relaxed);
+  }
+  ca_ctReserved.store(0, std::memory_order_relaxed);
+  ca_ctCommitted.store(0, std::memory_order_relaxed);
+}
+
+template<class Type>
+ConcurrentArray<Type>::~ConcurrentArray()
+{
+  Clear();
+}
+
+template<class Type>
+INDEX ConcurrentArray<Type>::SegmentSize(INDEX iSegment)
+{
+  return CCONCURRENTARRAY_FIRST_SEGMENT << iSegment;
+}
+
+template<class Type>
+INDEX ConcurrentArray<Type>::SegmentOf(INDEX iIndex, INDEX &iOffset)
+{
+  // Segment n starts at FIRST * (2^n - 1), so the highest bit of the index plus FIRST tells them apart
+  unsigned int ulShifted = (unsigned int)iIndex + CCONCURRENTARRAY_FIRST_SEGMENT;
+#ifdef _MSC_VER
+  unsigned long ulHighest;
+  _BitScanReverse(&ulHighest, ulShifted);
+  INDEX iHighest = (INDEX)ulHighest;
+#else
+  INDEX iHighest = 31 - __builtin_clz(ulShifted);
+#endif
+  INDEX iSegment = iHighest - CCONCURRENTARRAY_FIRST_SEGMENT_SHIFT;
+  iOffset = (INDEX)(ulShifted - (1u << iHighest));
+  return iSegment;
+}
+
+template<class Type>
+std::atomic<char>* ConcurrentArray<Type>::ReadyFlags(Type* pSegment, INDEX iSegment)
+{
+  // every segment has a flag per object after the objects themselves
+  return (std::atomic<char>*)(pSegment + SegmentSize(iSegment));
+}
+
+template<class Type>
+Type* ConcurrentArray<Type>::ReserveSlot(INDEX &iIndex)
+{
+  // claim an index, nobody else will get the same one
+  iIndex = ca_ctReserved.fetch_add(1, std::memory_order_relaxed);
+  if(iIndex < 0 || iIndex >= CCONCURRENTARRAY_MAX_COUNT) {
+    ca_ctReserved.fetch_sub(1, std::memory_order_relaxed);
+    throw std::length_error("ConcurrentArray is full");
+  }
+
+  INDEX iOffset;
+  INDEX iSegment = SegmentOf(iIndex, iOffset);
+  Type* pSegment = ca_apSegments[iSegment].load(std::memory_order_acquire);
+  if(pSegment == NULL) {
+    // the first thread to get here gets to install its segment, the others throw theirs away.
+    // calloc clears the ready flags for us.
+    INDEX ctSlots = SegmentSize(iSegment);
+    Type* pNewSegment = (Type*)calloc(1, sizeof(Type) * ctSlots + sizeof(std::atomic<char>) * ctSlots);
+    if(pNewSegment == NULL) {
+      // never publish a missing segment, but someone else might have managed to install one meanwhile
+      pSegment = ca_apSegments[iSegment].load(std::memory_order_acquire);
+      if(pSegment == NULL) {
+        throw std::bad_alloc();
+      }
+    } else if(ca_apSegments[iSegment].compare_exchange_strong(pSegment, pNewSegment, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      pSegment = pNewSegment;
+    } else {
+      free(pNewSegment);
+    }
+  }
+  return pSegment + iOffset;
+}
+
+template<class Type>
+void ConcurrentArray<Type>::Commit(INDEX iIndex)
+{
+  INDEX iOffset;
+  INDEX iSegment;
+
+  // When everything in front of us is done, simply move Count() past us. Otherwise leave a flag, so
+  // whoever finishes the objects in front of us moves Count() past ours too.
+  INDEX iCommitted = iIndex;
+  if(ca_ctCommitted.compare_exchange_strong(iCommitted, iIndex + 1)) {
+    iCommitted = iIndex + 1;
+  } else {
+    iSegment = SegmentOf(iIndex, iOffset);
+    ReadyFlags(ca_apSegments[iSegment].load(std::memory_order_relaxed), iSegment)[iOffset].store(1);
+    iCommitted = ca_ctCommitted.load();
+  }
+
+  // Move Count() past the objects that other threads finished while waiting on us
+  while(iCommitted < ca_ctReserved.load()) {
+    iSegment = SegmentOf(iCommitted, iOffset);
+    Type* pSegment = ca_apSegments[iSegment].load();
+    if(pSegment == NULL || !ReadyFlags(pSegment, iSegment)[iOffset].load()) {
+      break;
+    }
+    if(ca_ctCommitted.compare_exchange_weak(iCommitted, iCommitted + 1)) {
+      iCommitted++;
+    }
+  }
+}
+
+/// Push a default constructed object, return a reference to it
+template<class Type>
+Type& ConcurrentArray<Type>::Push(void)
+{
+  INDEX iIndex;
+  Type* pObject = new(ReserveSlot(iIndex)) Type();
+  Commit(iIndex);
+  return *pObject;
+}
+
+/// Copy an object onto the array, return a reference to it
+template<class Type>
+Type& ConcurrentArray<Type>::Push(const Type &obj)
+{
+  INDEX iIndex;
+  Type* pObject = new(ReserveSlot(iIndex)) Type(obj);
+  Commit(iIndex);
+  return *pObject;
+}
+
+/// Move an object onto the array, return a reference to it
+template<class Type>
+Type& ConcurrentArray<Type>::Push(Type &&obj)
+{
+  INDEX iIndex;
+  Type* pObject = new(ReserveSlot(iIndex)) Type(std::move(obj));
+  Commit(iIndex);
+  return *pObject;
+}
+
+/// Destroy all objects in the array and give back its memory, not thread safe
+template<class Type>
+void ConcurrentArray<Type>::Clear(void)
+{
+  INDEX ctObjects = ca_ctCommitted.load(std::memory_order_acquire);
+  for(INDEX iSegment=0; iSegment<CCONCURRENTARRAY_SEGMENTS; iSegment++) {
+    Type* pSegment = ca_apSegments[iSegment].load(std::memory_order_acquire);
+    if(pSegment == NULL) {
+      continue;
+    }
+
+    // destroy the objects that made it into this segment
+    INDEX iFirst = CCONCURRENTARRAY_FIRST_SEGMENT * ((1 << iSegment) - 1);
+    INDEX ctInSegment = Min(Max(ctObjects - iFirst, (INDEX)0), SegmentSize(iSegment));
+    for(INDEX i=0; i<ctInSegment; i++) {
+      pSegment[i].~Type();
+    }
+
+    free(pSegment);
+    ca_apSegments[iSegment].store(NULL, std::memory_order_relaxed);
+  }
+  ca_ctReserved.store(0, std::memory_order_relaxed);
+  ca_ctCommitted.store(0, std::memory_order_release);
+}
+
+template<class Type>
+Type& ConcurrentArray<Type>::operator[](INDEX iIndex)
+{
+  ASSERT(iIndex >= 0 && iIndex < Count());
+  INDEX iOffset;
+  INDEX iSegment = SegmentOf(iIndex, iOffset);
+  return ca_apSegments[iSegment].load(std::memory_order_relaxed)[iOffset];
+}
+
+template<class Type>
+const Type& ConcurrentArray<Type>::operator[](INDEX iIndex) const
+{
+  ASSERT(iIndex >= 0 && iIndex < Count());
+  INDEX iOffset;
+  INDEX iSegment = SegmentOf(iIndex, iOffset);
+  return ca_apSegments[iSegment].load(std::memory_order_relaxed)[iOffset];
+}
+
+SCRATCH_NAMESPACE_END;
+
+#endif
@@ -0,0 +1,102 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CCONCURRENTARRAY_H_INCLUDED
+#define SCRATCH_CCONCURRENTARRAY_H_INCLUDED
+
+#include "Common.h"
+
+#include <atomic>
+#include <cstddef> // for max_align_t
+
+// Amount of objects in the first segment, as a power of two. Every next segment is twice as big.
+#ifndef CCONCURRENTARRAY_FIRST_SEGMENT_SHIFT
+#define CCONCURRENTARRAY_FIRST_SEGMENT_SHIFT 6
+#endif
+#define CCONCURRENTARRAY_FIRST_SEGMENT (1 << CCONCURRENTARRAY_FIRST_SEGMENT_SHIFT)
+
+// Segments needed to get as close to the largest INDEX as doubling allows, the last one ends right below 2^31.
+#define CCONCURRENTARRAY_SEGMENTS (31 - CCONCURRENTARRAY_FIRST_SEGMENT_SHIFT)
+// Most objects all segments together can hold, FIRST * (2^SEGMENTS - 1).
+#define CCONCURRENTARRAY_MAX_COUNT ((INDEX)(((1u << CCONCURRENTARRAY_SEGMENTS) - 1) * CCONCURRENTARRAY_FIRST_SEGMENT))
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/// Append-only array that any amount of threads can push to and read from at the same time, without
+/// locking. Objects are stored in segments that each double in size and never move, so references to
+/// them stay valid until the array is cleared. Everything below Count() is fully constructed and safe
+/// to read from any thread. Pushing never waits on other threads: an object that's done before the ones
+/// in front of it is counted as soon as they're done too.
+/// Note: Clear and destruction are not thread safe, and constructors of the objects shouldn't throw. When a
+/// push throws because memory ran out, Count() doesn't move past the object that couldn't be pushed anymore.
+template<class Type>
+class SCRATCH_EXPORT ConcurrentArray
+{
+  // segments come straight from calloc, which only aligns for the fundamental types
+  static_assert(alignof(Type) <= alignof(std::max_align_t), "ConcurrentArray can't store over-aligned objects");
+
+private:
+  std::atomic<Type*> ca_apSegments[CCONCURRENTARRAY_SEGMENTS];
+  std::atomic<INDEX> ca_ctReserved;
+  std::atomic<INDEX> ca_ctCommitted;
+
+public:
+  ConcurrentArray(void);
+  ~ConcurrentArray(void);
+
+  /// Push a default constructed object, return a reference to it
+  Type& Push(void);
+  /// Copy an object onto the array, return a reference to it
+  Type& Push(const Type &obj);
+  /// Move an object onto the array, return a reference to it
+  Type& Push(Type &&obj);
+
+  /// Destroy all objects in the array and give back its memory, not thread safe
+  void Clear(void);
+
+  /// Return how many objects have been pushed and are ready to read
+  inline INDEX Count(void) const { return ca_ctCommitted.load(std::memory_order_acquire); }
+
+  Type& operator[](INDEX iIndex);
+  const Type& operator[](INDEX iIndex) const;
+
+private:
+  // not copyable, copying while others push couldn't be done right anyway
+  ConcurrentArray(const ConcurrentArray<Type> &copy);
+  ConcurrentArray<Type>& operator=(const ConcurrentArray<Type> &copy);
+
+  static INDEX SegmentSize(INDEX iSegment);
+  static INDEX SegmentOf(INDEX iIndex, INDEX &iOffset);
+  static std::atomic<char>* ReadyFlags(Type* pSegment, INDEX iSegment);
+  Type* ReserveSlot(INDEX &iIndex);
+  void Commit(INDEX iIndex);
+};
+
+SCRATCH_NAMESPACE_END;
+
+#include "CConcurrentArray.cpp"
+
+#endif // include once check
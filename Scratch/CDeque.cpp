@@ -0,0 +1,359 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CDEQUE_CPP_INCLUDED
+#define SCRATCH_CDEQUE_CPP_INCLUDED
+
+#include "CDeque.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new> // for placement new and bad_alloc
+
+SCRATCH_NAMESPACE_BEGIN;
+
+template<class Type>
+Deque<Type>::Deque()
+{
+  // memory is only allocated once something is pushed
+  deq_pItems = NULL;
+  deq_ctSlots = 0;
+  deq_iHead = 0;
+  deq_ctUsed = 0;
+}
+
+template<class Type>
+Deque<Type>::Deque(const Deque<Type> &copy)
+{
+  deq_pItems = NULL;
+  deq_ctSlots = 0;
+  deq_iHead = 0;
+  deq_ctUsed = 0;
+  *this = copy;
+}
+
+template<class Type>
+Deque<Type>::Deque(Deque<Type> &&move)
+{
+  // take over the memory of the other deque
+  deq_pItems = move.deq_pItems;
+  deq_ctSlots = move.deq_ctSlots;
+  deq_iHead = move.deq_iHead;
+  deq_ctUsed = move.deq_ctUsed;
+
+  // and leave it empty
+  move.deq_pItems = NULL;
+  move.deq_ctSlots = 0;
+  move.deq_iHead = 0;
+  move.deq_ctUsed = 0;
+}
+
+template<class Type>
+Deque<Type>::~Deque()
+{
+  Free();
+}
+
+template<class Type>
+Deque<Type>& Deque<Type>::operator=(const Deque<Type> &copy)
+{
+  if(this == &copy) {
+    return *this;
+  }
+
+  Clear();
+  Reserve(copy.deq_ctUsed);
+
+  // the copy starts at the beginning of our memory, without wrapping around
+  for(INDEX i=0; i<copy.deq_ctUsed; i++) {
+    new(deq_pItems + i) Type(copy[i]);
+  }
+  deq_iHead = 0;
+  deq_ctUsed = copy.deq_ctUsed;
+
+  return *this;
+}
+
+template<class Type>
+Deque<Type>& Deque<Type>::operator=(Deque<Type> &&move)
+{
+  if(this == &move) {
+    return *this;
+  }
+
+  // get rid of our own objects first
+  Free();
+
+  // take over the memory of the other deque
+  deq_pItems = move.deq_pItems;
+  deq_ctSlots = move.deq_ctSlots;
+  deq_iHead = move.deq_iHead;
+  deq_ctUsed = move.deq_ctUsed;
+
+  // and leave it empty
+  move.deq_pItems = NULL;
+  move.deq_ctSlots = 0;
+  move.deq_iHead = 0;
+  move.deq_ctUsed = 0;
+
+  return *this;
+}
+
+template<class Type>
+void Deque<Type>::Reserve(INDEX ctSlots)
+{
+  if(ctSlots <= deq_ctSlots) {
+    return;
+  }
+
+  // keep the amount of slots a power of two
+  INDEX ctNewSlots = 16;
+  while(ctNewSlots < ctSlots) {
+    ctNewSlots *= 2;
+  }
+
+  // unwrap the objects to the start of the new memory, leaving everything as it was if we can't get any
+  Type* pNewItems = (Type*)malloc(sizeof(Type) * ctNewSlots);
+  if(pNewItems == NULL) {
+    throw std::bad_alloc();
+  }
+  INDEX ctFirst = Min(deq_ctUsed, deq_ctSlots - deq_iHead);
+  if(deq_bTrivial) {
+    if(deq_ctUsed > 0) {
+      memcpy((void*)pNewItems, (const void*)(deq_pItems + deq_iHead), sizeof(Type) * ctFirst);
+      memcpy((void*)(pNewItems + ctFirst), (const void*)deq_pItems, sizeof(Type) * (deq_ctUsed - ctFirst));
+    }
+  } else {
+    for(INDEX i=0; i<deq_ctUsed; i++) {
+      Type &obj = (*this)[i];
+      new(pNewItems + i) Type(std::move(obj));
+      obj.~Type();
+    }
+  }
+
+  free(deq_pItems);
+  deq_pItems = pNewItems;
+  deq_ctSlots = ctNewSlots;
+  deq_iHead = 0;
+}
+
+template<class Type>
+void Deque<Type>::Free(void)
+{
+  Clear();
+
+  // free allocated memory for data
+  if(deq_pItems != NULL) {
+    free(deq_pItems);
+    deq_pItems = NULL;
+  }
+  deq_ctSlots = 0;
+}
+
+template<class Type>
+Type* Deque<Type>::SlotBegin(void)
+{
+  // grow geometrically when full, then step the head back one slot
+  if(deq_ctUsed >= deq_ctSlots) {
+    Reserve(Max(deq_ctSlots * 2, (INDEX)16));
+  }
+  deq_iHead = (deq_iHead - 1) & (deq_ctSlots - 1);
+  deq_ctUsed++;
+  return deq_pItems + deq_iHead;
+}
+
+template<class Type>
+Type* Deque<Type>::SlotEnd(void)
+{
+  // grow geometrically when full, then take the slot after the last object
+  if(deq_ctUsed >= deq_ctSlots) {
+    Reserve(Max(deq_ctSlots * 2, (INDEX)16));
+  }
+  Type* pSlot = deq_pItems + ((deq_iHead + deq_ctUsed) & (deq_ctSlots - 1));
+  deq_ctUsed++;
+  return pSlot;
+}
+
+/// Push to the beginning of the deque, return a reference to the newly made object
+template<class Type>
+Type& Deque<Type>::PushBegin(void)
+{
+  return *new(SlotBegin()) Type();
+}
+
+/// Copy an object onto the beginning of the deque, return a reference to the newly made object
+template<class Type>
+Type& Deque<Type>::PushBegin(const Type &obj)
+{
+  if(deq_ctUsed >= deq_ctSlots) {
+    // only a full deque reallocates, and obj could be stored in the memory that goes away
+    Type tCopy(obj);
+    return *new(SlotBegin()) Type(std::move(tCopy));
+  }
+  return *new(SlotBegin()) Type(obj);
+}
+
+/// Move an object onto the beginning of the deque, return a reference to the newly made object
+template<class Type>
+Type& Deque<Type>::PushBegin(Type &&obj)
+{
+  if(deq_ctUsed >= deq_ctSlots) {
+    Type tMoved(std::move(obj));
+    return *new(SlotBegin()) Type(std::move(tMoved));
+  }
+  return *new(SlotBegin()) Type(std::move(obj));
+}
+
+/// Push to the end of the deque, return a reference to the newly made object
+template<class Type>
+Type& Deque<Type>::Push(void)
+{
+  return *new(SlotEnd()) Type();
+}
+
+/// Copy an object onto the end of the deque, return a reference to the newly made object
+template<class Type>
+Type& Deque<Type>::Push(const Type &obj)
+{
+  if(deq_ctUsed >= deq_ctSlots) {
+    // only a full deque reallocates, and obj could be stored in the memory that goes away
+    Type tCopy(obj);
+    return *new(SlotEnd()) Type(std::move(tCopy));
+  }
+  return *new(SlotEnd()) Type(obj);
+}
+
+/// Move an object onto the end of the deque, return a reference to the newly made object
+template<class Type>
+Type& Deque<Type>::Push(Type &&obj)
+{
+  if(deq_ctUsed >= deq_ctSlots) {
+    Type tMoved(std::move(obj));
+    return *new(SlotEnd()) Type(std::move(tMoved));
+  }
+  return *new(SlotEnd()) Type(std::move(obj));
+}
+
+/// Pop the first object from the deque
+template<class Type>
+Type Deque<Type>::PopBegin(void)
+{
+  ASSERT(deq_ctUsed > 0);
+
+  Type &obj = deq_pItems[deq_iHead];
+  Type tObject(std::move(obj));
+  obj.~Type();
+  deq_iHead = (deq_iHead + 1) & (deq_ctSlots - 1);
+  deq_ctUsed--;
+  return tObject;
+}
+
+/// Pop the last object from the deque
+template<class Type>
+Type Deque<Type>::Pop(void)
+{
+  ASSERT(deq_ctUsed > 0);
+
+  Type &obj = (*this)[deq_ctUsed - 1];
+  Type tObject(std::move(obj));
+  obj.~Type();
+  deq_ctUsed--;
+  return tObject;
+}
+
+/// Destroy all objects in the deque, keeping the memory around for reuse
+template<class Type>
+void Deque<Type>::Clear(void)
+{
+  if(!deq_bTrivial) {
+    for(INDEX i=0; i<deq_ctUsed; i++) {
+      (*this)[i].~Type();
+    }
+  }
+  deq_iHead = 0;
+  deq_ctUsed = 0;
+}
+
+/// Call the given function with a pointer to and the amount of objects in each contiguous block, in order
+template<class Type>
+template<typename Func>
+void Deque<Type>::ForEachBlock(Func f)
+{
+  if(deq_ctUsed == 0) {
+    return;
+  }
+
+  // the objects wrap around to the start of the memory at most once
+  INDEX ctFirst = Min(deq_ctUsed, deq_ctSlots - deq_iHead);
+  f(deq_pItems + deq_iHead, ctFirst);
+  if(ctFirst < deq_ctUsed) {
+    f(deq_pItems, deq_ctUsed - ctFirst);
+  }
+}
+
+/// Find the index of the given object in the deque
+template<class Type>
+INDEX Deque<Type>::Find(const Type &obj) const
+{
+  for(INDEX i=0; i<deq_ctUsed; i++) {
+    if(obj == (*this)[i]) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/// Find the index of the given condition in the deque
+template<class Type>
+template<typename Func>
+INDEX Deque<Type>::FindAny(Func f)
+{
+  for(INDEX i=0; i<deq_ctUsed; i++) {
+    if(f((*this)[i])) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/// Returns whether the given object is currently in the deque
+template<class Type>
+BOOL Deque<Type>::Contains(const Type &obj) const
+{
+  return Find(obj) != -1;
+}
+
+/// Returns whether the given condition is currently in the deque
+template<class Type>
+template<typename Func>
+BOOL Deque<Type>::ContainsAny(Func f)
+{
+  return FindAny(f) != -1;
+}
+
+SCRATCH_NAMESPACE_END;
+
+#endif
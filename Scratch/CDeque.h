@@ -0,0 +1,126 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CDEQUE_H_INCLUDED
+#define SCRATCH_CDEQUE_H_INCLUDED
+
+#include "Common.h"
+
+#include <type_traits>
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/// Double ended queue, stored in a ring buffer so pushing and popping at either end never moves
+/// the other objects. The objects are contiguous in at most two blocks, see ForEachBlock. Like Array,
+/// objects move when the deque grows, and it is not locked for use by multiple threads.
+template<class Type>
+class SCRATCH_EXPORT Deque
+{
+public:
+  Type* deq_pItems;
+  INDEX deq_ctSlots; // always zero or a power of two, so indices can wrap with a mask
+  INDEX deq_iHead;
+  INDEX deq_ctUsed;
+
+public:
+  Deque(void);
+  Deque(const Deque<Type> &copy);
+  Deque(Deque<Type> &&move);
+  ~Deque(void);
+
+  Deque<Type>& operator=(const Deque<Type> &copy);
+  /// Take over the objects of another deque, clearing this one first
+  Deque<Type>& operator=(Deque<Type> &&move);
+
+  /// Push to the beginning of the deque, return a reference to the newly made object
+  Type& PushBegin(void);
+  /// Copy an object onto the beginning of the deque, return a reference to the newly made object
+  Type& PushBegin(const Type &obj);
+  /// Move an object onto the beginning of the deque, return a reference to the newly made object
+  Type& PushBegin(Type &&obj);
+  /// Push to the end of the deque, return a reference to the newly made object
+  Type& Push(void);
+  /// Copy an object onto the end of the deque, return a reference to the newly made object
+  Type& Push(const Type &obj);
+  /// Move an object onto the end of the deque, return a reference to the newly made object
+  Type& Push(Type &&obj);
+  /// Pop the first object from the deque
+  Type PopBegin(void);
+  /// Pop the last object from the deque
+  Type Pop(void);
+
+  /// Destroy all objects in the deque, keeping the memory around for reuse
+  void Clear(void);
+
+  /// Return how many objects there currently are in the deque
+  inline INDEX Count(void) const { return deq_ctUsed; }
+  /// Return how many objects the deque can hold without reallocating
+  inline INDEX Capacity(void) const { return deq_ctSlots; }
+  /// Make sure the deque can hold at least the given amount of objects without reallocating
+  void Reserve(INDEX ctSlots);
+
+  /// Call the given function with a pointer to and the amount of objects in each contiguous block, in order
+  template<typename Func>
+  void ForEachBlock(Func f);
+
+  /// Find the index of the given object in the deque
+  INDEX Find(const Type &obj) const;
+  /// Find the index of the given condition in the deque
+  template<typename Func>
+  INDEX FindAny(Func f);
+
+  /// Returns whether the given object is currently in the deque
+  BOOL Contains(const Type &obj) const;
+  /// Returns whether the given condition is currently in the deque
+  template<typename Func>
+  BOOL ContainsAny(Func f);
+
+  inline Type& operator[](INDEX iIndex)
+  {
+    ASSERT(iIndex >= 0 && iIndex < deq_ctUsed);
+    return deq_pItems[(deq_iHead + iIndex) & (deq_ctSlots - 1)];
+  }
+
+  inline const Type& operator[](INDEX iIndex) const
+  {
+    ASSERT(iIndex >= 0 && iIndex < deq_ctUsed);
+    return deq_pItems[(deq_iHead + iIndex) & (deq_ctSlots - 1)];
+  }
+
+private:
+  /// Objects that can be copied with memcpy can also be moved around with it
+  static const bool deq_bTrivial = std::is_trivially_copyable<Type>::value;
+
+  Type* SlotBegin(void);
+  Type* SlotEnd(void);
+  void Free(void);
+};
+
+SCRATCH_NAMESPACE_END;
+
+#include "CDeque.cpp"
+
+#endif // include once check
@@ -70,11 +70,28 @@ Dictionary<TKey, TValue>::Dictionary(const Dictionary<TKey, TValue> &copy)
   dic_bAllowDuplicateKeys = copy.dic_bAllowDuplicateKeys;
 }
 
+template<class TKey, class TValue>
+Dictionary<TKey, TValue>::Dictionary(Dictionary<TKey, TValue> &&move)
+  : dic_saKeys(std::move(move.dic_saKeys)),
+    dic_saValues(std::move(move.dic_saValues))
+{
+  dic_bAllowDuplicateKeys = move.dic_bAllowDuplicateKeys;
+}
+
 template<class TKey, class TValue>
 Dictionary<TKey, TValue>::~Dictionary(void)
 {
 }
 
+template<class TKey, class TValue>
+Dictionary<TKey, TValue>& Dictionary<TKey, TValue>::operator=(Dictionary<TKey, TValue> &&move)
+{
+  dic_saKeys = std::move(move.dic_saKeys);
+  dic_saValues = std::move(move.dic_saValues);
+  dic_bAllowDuplicateKeys = move.dic_bAllowDuplicateKeys;
+  return *this;
+}
+
 /// Add to the dictionary
 template<class TKey, class TValue>
 void Dictionary<TKey, TValue>::Add(const TKey &key, const TValue &value)
@@ -90,6 +107,21 @@ void Dictionary<TKey, TValue>::Add(const TKey &key, const TValue &value)
   dic_saValues.Push() = value;
 }
 
+/// Move a key and value into the dictionary
+template<class TKey, class TValue>
+void Dictionary<TKey, TValue>::Add(TKey &&key, TValue &&value)
+{
+  // if the key has already been added
+  if(!dic_bAllowDuplicateKeys && HasKey(key)) {
+    ASSERT(FALSE);
+    return;
+  }
+
+  // add it
+  dic_saKeys.Push(std::move(key));
+  dic_saValues.Push(std::move(value));
+}
+
 /// Push to the dictionary
 template<class TKey, class TValue>
 DictionaryPair<TKey, TValue> Dictionary<TKey, TValue>::Push(const TKey &key)
@@ -101,6 +133,16 @@ DictionaryPair<TKey, TValue> Dictionary<TKey, TValue>::Push(const TKey &key)
   return ret;
 }
 
+/// Move a key into the dictionary
+template<class TKey, class TValue>
+DictionaryPair<TKey, TValue> Dictionary<TKey, TValue>::Push(TKey &&key)
+{
+  DictionaryPair<TKey, TValue> ret;
+  ret.key = &(dic_saKeys.Push(std::move(key)));
+  ret.value = &(dic_saValues.Push());
+  return ret;
+}
+
 /// Get the index of the given key
 template<class TKey, class TValue>
 INDEX Dictionary<TKey, TValue>::IndexByKey(const TKey &key)
@@ -189,6 +231,38 @@ void Dictionary<TKey, TValue>::RemoveByValue(const TValue &value)
   RemoveByIndex(IndexByValue(value));
 }
 
+/// Remove every key and value the condition holds for in a single pass, return how many were removed
+template<class TKey, class TValue>
+template<typename Func>
+INDEX Dictionary<TKey, TValue>::RemoveIf(Func f)
+{
+  // keep the pairs that stay in order, so both stacks are compacted the same way
+  INDEX ctElements = Count();
+  INDEX iKeep = 0;
+  for(INDEX i=0; i<ctElements; i++) {
+    TKey* pKey = dic_saKeys.sa_pItems[i];
+    TValue* pValue = dic_saValues.sa_pItems[i];
+    if(f(*pKey, *pValue)) {
+      delete pKey;
+      delete pValue;
+    } else {
+      dic_saKeys.sa_pItems[iKeep] = pKey;
+      dic_saValues.sa_pItems[iKeep] = pValue;
+      iKeep++;
+    }
+  }
+
+  // the removed objects are already deleted, so set the remaining pointers to NULL (just to be sure)
+  INDEX ctRemoved = ctElements - iKeep;
+  for(INDEX i=iKeep; i<ctElements; i++) {
+    dic_saKeys.sa_pItems[i] = NULL;
+    dic_saValues.sa_pItems[i] = NULL;
+  }
+  dic_saKeys.sa_ctUsed = iKeep;
+  dic_saValues.sa_ctUsed = iKeep;
+  return ctRemoved;
+}
+
 /// Pop a value by its index
 template<class TKey, class TValue>
 DictionaryPair<TKey, TValue> Dictionary<TKey, TValue>::PopByIndex(const INDEX iIndex)
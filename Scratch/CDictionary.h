@@ -63,12 +63,20 @@ public:
 public:
 	Dictionary(void);
 	Dictionary(const Dictionary<TKey, TValue> &copy);
+	Dictionary(Dictionary<TKey, TValue> &&move);
 	~Dictionary(void);
 
+  /// Take over the items of another dictionary, clearing this one first
+  Dictionary<TKey, TValue>& operator=(Dictionary<TKey, TValue> &&move);
+
   /// Add to the dictionary
   void Add(const TKey &key, const TValue &value);
+  /// Move a key and value into the dictionary
+  void Add(TKey &&key, TValue &&value);
   /// Push to the dictionary
 	DictionaryPair<TKey, TValue> Push(const TKey &key);
+  /// Move a key into the dictionary
+	DictionaryPair<TKey, TValue> Push(TKey &&key);
 
   /// Get the index of the given key
   INDEX IndexByKey(const TKey &key);
@@ -86,6 +94,9 @@ public:
   void RemoveByKey(const TKey &key);
   /// Remove a value from the dictionary
   void RemoveByValue(const TValue &value);
+  /// Remove every key and value the condition holds for in a single pass, return how many were removed
+  template<typename Func>
+  INDEX RemoveIf(Func f);
 
   /// Pop a value by its index
 	DictionaryPair<TKey, TValue> PopByIndex(const INDEX iIndex);
@@ -108,6 +119,55 @@ public:
   TKey& GetKeyByIndex(const INDEX iIndex);
   /// Get a value from the dictionary using an index
   TValue& GetValueByIndex(const INDEX iIndex);
+
+  /// Walks the keys and values of a dictionary together, giving a pair of pointers to them
+  class Iterator
+  {
+  public:
+    /// Keeps the pair made by operator-> alive for the member access, as no pair is stored anywhere to point at
+    class PairProxy
+    {
+    public:
+      DictionaryPair<TKey, TValue> pp_pair;
+      inline const DictionaryPair<TKey, TValue>* operator->() const { return &pp_pair; }
+    };
+
+    // The pairs are made on the fly, so dereferencing gives a value rather than a reference, which only
+    // an input iterator is allowed to do. Walking over the dictionary more than once still works.
+    typedef std::input_iterator_tag iterator_category;
+    typedef DictionaryPair<TKey, TValue> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef PairProxy pointer;
+    typedef DictionaryPair<TKey, TValue> reference;
+
+    TKey** it_ppKey;
+    TValue** it_ppValue;
+
+    inline Iterator(TKey** ppKey, TValue** ppValue) : it_ppKey(ppKey), it_ppValue(ppValue) {}
+
+    inline DictionaryPair<TKey, TValue> operator*() const
+    {
+      DictionaryPair<TKey, TValue> pair;
+      pair.key = *it_ppKey;
+      pair.value = *it_ppValue;
+      return pair;
+    }
+    inline PairProxy operator->() const
+    {
+      PairProxy proxy;
+      proxy.pp_pair = **this;
+      return proxy;
+    }
+    inline Iterator& operator++() { it_ppKey++; it_ppValue++; return *this; }
+    inline Iterator operator++(int) { Iterator itOld = *this; ++(*this); return itOld; }
+    inline bool operator==(const Iterator &it) const { return it_ppKey == it.it_ppKey; }
+    inline bool operator!=(const Iterator &it) const { return it_ppKey != it.it_ppKey; }
+  };
+
+  /// Iterator at the first pair; adding or removing items invalidates it
+  inline Iterator begin(void) { return Iterator(dic_saKeys.sa_pItems, dic_saValues.sa_pItems); }
+  /// Iterator after the last pair
+  inline Iterator end(void) { return Iterator(dic_saKeys.sa_pItems + dic_saKeys.sa_ctUsed, dic_saValues.sa_pItems + dic_saValues.sa_ctUsed); }
 };
 
 SCRATCH_NAMESPACE_END;
@@ -34,33 +34,27 @@ SCRATCH_NAMESPACE_BEGIN;
 
 Filename::Filename()
 {
-  str_iInstances++;
-  // Create a new empty buffer
-  this->str_szBuffer = String::str_szEmpty;
 }
 
 Filename::Filename(const Filename &copy)
+  : String(copy)
 {
-  str_iInstances++;
-  // Create a new buffer and copy data into it.
-  this->str_szBuffer = String::str_szEmpty;
-  this->CopyToBuffer(copy);
 }
 
 Filename::Filename(const char* szStr)
+  : String(szStr)
 {
-  str_iInstances++;
-  // Create a new buffer and copy data into it.
-  this->str_szBuffer = String::str_szEmpty;
-  this->CopyToBuffer(szStr);
 }
 
 Filename::Filename(const String &str)
+  : String(str)
 {
-  str_iInstances++;
-  // Create a new buffer and copy data into it.
-  this->str_szBuffer = String::str_szEmpty;
-  this->CopyToBuffer(str.str_szBuffer);
+}
+
+Filename& Filename::operator=(const Filename &copy)
+{
+  String::operator=(copy);
+  return *this;
 }
 
 String Filename::Extension() const
@@ -39,6 +39,8 @@ public:
 	Filename(const char* szStr);
 	Filename(const String &str);
 
+  Filename& operator=(const Filename &copy);
+
   String Extension() const;
   String Path() const;
 	String Name() const;
@@ -46,6 +48,11 @@ public:
   void FromHome(const String &strPath);
 };
 
+template<>
+struct Hasher<Filename> : Hasher<String>
+{
+};
+
 SCRATCH_NAMESPACE_END;
 
 #endif
@@ -49,11 +49,52 @@ MemoryStream::MemoryStream(const MemoryStream &copy)
   strm_ulUsed = copy.strm_ulUsed;
 }
 
+MemoryStream::MemoryStream(MemoryStream &&move)
+  : Stream(move)
+{
+  // take over the buffer of the other stream
+  strm_pubBuffer = move.strm_pubBuffer;
+  strm_ulPosition = move.strm_ulPosition;
+  strm_ulSize = move.strm_ulSize;
+  strm_ulUsed = move.strm_ulUsed;
+
+  // and leave it empty
+  move.strm_pubBuffer = NULL;
+  move.strm_ulPosition = 0;
+  move.strm_ulSize = 0;
+  move.strm_ulUsed = 0;
+}
+
 MemoryStream::~MemoryStream(void)
 {
   delete[] strm_pubBuffer;
 }
 
+MemoryStream& MemoryStream::operator=(MemoryStream &&move)
+{
+  if(this == &move) {
+    return *this;
+  }
+
+  // get rid of our own buffer
+  delete[] strm_pubBuffer;
+
+  // take over the buffer of the other stream
+  strm_nlmNewLineMode = move.strm_nlmNewLineMode;
+  strm_pubBuffer = move.strm_pubBuffer;
+  strm_ulPosition = move.strm_ulPosition;
+  strm_ulSize = move.strm_ulSize;
+  strm_ulUsed = move.strm_ulUsed;
+
+  // and leave it empty
+  move.strm_pubBuffer = NULL;
+  move.strm_ulPosition = 0;
+  move.strm_ulSize = 0;
+  move.strm_ulUsed = 0;
+
+  return *this;
+}
+
 ULONG MemoryStream::Size()
 {
   return strm_ulUsed;
@@ -43,8 +43,12 @@ public:
 public:
 	MemoryStream(void);
 	MemoryStream(const MemoryStream &copy);
+	MemoryStream(MemoryStream &&move);
 	~MemoryStream(void);
 
+  /// Take over the buffer of another memory stream
+  MemoryStream& operator=(MemoryStream &&move);
+
   ULONG Size();
   ULONG Location();
   void Seek(ULONG ulPos, INDEX iOrigin);
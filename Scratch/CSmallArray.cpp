@@ -0,0 +1,106 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CSMALLARRAY_CPP_INCLUDED
+#define SCRATCH_CSMALLARRAY_CPP_INCLUDED
+
+#include "CSmallArray.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+template<class Type, INDEX ctInline>
+SmallArray<Type, ctInline>::SmallArray()
+  : Array<Type>((Type*)sma_aubInline, ctInline)
+{
+}
+
+template<class Type, INDEX ctInline>
+SmallArray<Type, ctInline>::SmallArray(const SmallArray<Type, ctInline> &copy)
+  : Array<Type>((Type*)sma_aubInline, ctInline)
+{
+  Array<Type>::operator=(copy);
+}
+
+template<class Type, INDEX ctInline>
+SmallArray<Type, ctInline>::SmallArray(SmallArray<Type, ctInline> &&move)
+  : Array<Type>((Type*)sma_aubInline, ctInline)
+{
+  Array<Type>::operator=(std::move(move));
+}
+
+template<class Type, INDEX ctInline>
+SmallArray<Type, ctInline>::~SmallArray()
+{
+  // the inline objects have to go while our slots are still around
+  this->Free();
+}
+
+template<class Type, INDEX ctInline>
+SmallArray<Type, ctInline>& SmallArray<Type, ctInline>::operator=(const SmallArray<Type, ctInline> &copy)
+{
+  Array<Type>::operator=(copy);
+  return *this;
+}
+
+template<class Type, INDEX ctInline>
+SmallArray<Type, ctInline>& SmallArray<Type, ctInline>::operator=(SmallArray<Type, ctInline> &&move)
+{
+  Array<Type>::operator=(std::move(move));
+  return *this;
+}
+
+/// Take over an object made with new, like StackArray does; it's moved into the array and deleted
+template<class Type, INDEX ctInline>
+void SmallArray<Type, ctInline>::Push(Type* pObj)
+{
+  Push(std::move(*pObj));
+  delete pObj;
+}
+
+/// Pop the top object from the array, as a new object that the caller deletes like with StackArray
+template<class Type, INDEX ctInline>
+Type* SmallArray<Type, ctInline>::Pop(void)
+{
+  return new Type(Array<Type>::Pop());
+}
+
+/// Pop a certain index from the array, as a new object that the caller deletes like with StackArray
+template<class Type, INDEX ctInline>
+Type* SmallArray<Type, ctInline>::PopAt(INDEX iIndex)
+{
+  return new Type(Array<Type>::PopAt(iIndex));
+}
+
+/// Pop all objects from the array. They live inside the array, so they're destroyed rather than handed back.
+template<class Type, INDEX ctInline>
+void SmallArray<Type, ctInline>::PopAll(void)
+{
+  this->Clear();
+}
+
+SCRATCH_NAMESPACE_END;
+
+#endif
@@ -0,0 +1,76 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CSMALLARRAY_H_INCLUDED
+#define SCRATCH_CSMALLARRAY_H_INCLUDED
+
+#include "Common.h"
+#include "CArray.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/// Array that stores its first ctInline objects inside itself, so a small amount of objects lives on
+/// the stack or inside the owning object and doesn't allocate at all. Only when more are pushed do
+/// the objects move to the heap; the storage and growing is shared with Array. On top of that it has
+/// the Push, Pop, PopAll, Find and RemoveIf functions of StackArray, so code written for a StackArray
+/// works on it. Objects move when the array grows, and it is not locked for use by multiple threads.
+template<class Type, INDEX ctInline>
+class SCRATCH_EXPORT SmallArray : public Array<Type>
+{
+  static_assert(ctInline > 0, "SmallArray needs room for at least one inline object");
+
+private:
+  alignas(Type) unsigned char sma_aubInline[sizeof(Type) * ctInline];
+
+public:
+  SmallArray(void);
+  SmallArray(const SmallArray<Type, ctInline> &copy);
+  SmallArray(SmallArray<Type, ctInline> &&move);
+  ~SmallArray(void);
+
+  SmallArray<Type, ctInline>& operator=(const SmallArray<Type, ctInline> &copy);
+  /// Take over the objects of another array, clearing this one first
+  SmallArray<Type, ctInline>& operator=(SmallArray<Type, ctInline> &&move);
+
+  using Array<Type>::Push;
+  /// Take over an object made with new, like StackArray does; it's moved into the array and deleted
+  void Push(Type* pObj);
+  /// Pop the top object from the array, as a new object that the caller deletes like with StackArray
+  Type* Pop(void);
+  /// Pop a certain index from the array, as a new object that the caller deletes like with StackArray
+  Type* PopAt(INDEX iIndex);
+  /// Pop all objects from the array. They live inside the array, so they're destroyed rather than handed back.
+  void PopAll(void);
+
+  /// Returns whether the objects are still stored inside the array itself
+  inline BOOL IsInline(void) const { return this->arr_pItems == (const Type*)sma_aubInline; }
+};
+
+SCRATCH_NAMESPACE_END;
+
+#include "CSmallArray.cpp"
+
+#endif // include once check
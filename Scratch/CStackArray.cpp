@@ -31,6 +31,8 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
+#include <new> // for bad_alloc
 
 SCRATCH_NAMESPACE_BEGIN;
 
@@ -41,7 +43,6 @@ StackArray<Type>::StackArray()
   sa_ctSlots = 0;
   sa_ctUsed = 0;
   sa_bOnlyPop = FALSE;
-  AllocateSlots(256);
 }
 
 template<class Type>
@@ -52,21 +53,35 @@ StackArray<Type>::StackArray(const StackArray<Type> &copy)
   sa_ctUsed = 0;
   sa_bOnlyPop = copy.sa_bOnlyPop;
 
-  AllocateSlots(copy.sa_ctSlots);
+  if(copy.sa_ctUsed > 0) {
+    AllocateSlots(copy.sa_ctUsed);
+  }
 
   // copy meta information
   sa_ctUsed = copy.sa_ctUsed;
 
   // copy data to other slots
   for(INDEX i=0; i<sa_ctUsed; i++) {
-    // allocate memory for it
-    sa_pItems[i] = new Type;
-
-    // this should call the copy constructor
-    *sa_pItems[i] = *copy.sa_pItems[i];
+    // allocate memory for it using the copy constructor
+    sa_pItems[i] = new Type(*copy.sa_pItems[i]);
   }
 }
 
+template<class Type>
+StackArray<Type>::StackArray(StackArray<Type> &&move)
+{
+  // take over the slots of the other stack
+  sa_pItems = move.sa_pItems;
+  sa_ctSlots = move.sa_ctSlots;
+  sa_ctUsed = move.sa_ctUsed;
+  sa_bOnlyPop = move.sa_bOnlyPop;
+
+  // and leave it empty
+  move.sa_pItems = NULL;
+  move.sa_ctSlots = 0;
+  move.sa_ctUsed = 0;
+}
+
 template<class Type>
 StackArray<Type>::~StackArray()
 {
@@ -83,46 +98,73 @@ StackArray<Type>::~StackArray()
 }
 
 template<class Type>
-void StackArray<Type>::AllocateSlots(INDEX ctSlots)
+StackArray<Type>& StackArray<Type>::operator=(StackArray<Type> &&move)
 {
-  // allocate some memory
-  sa_ctSlots += ctSlots;
-  Type** pNewMem = (Type**)malloc(sizeof(Type*) * sa_ctSlots);
+  if(this == &move) {
+    return *this;
+  }
 
-  // if we allocated memory before
+  // get rid of our own objects first
+  if(sa_bOnlyPop) {
+    PopAll();
+  } else {
+    Clear();
+  }
   if(sa_pItems != NULL) {
-    // copy data to the new memory
-    memcpy(pNewMem, sa_pItems, sizeof(Type*) * (sa_ctSlots - ctSlots));
-    // free previously allocated memory
     free(sa_pItems);
   }
 
-  // update the pointer
-  sa_pItems = pNewMem;
+  // take over the slots of the other stack
+  sa_pItems = move.sa_pItems;
+  sa_ctSlots = move.sa_ctSlots;
+  sa_ctUsed = move.sa_ctUsed;
+  sa_bOnlyPop = move.sa_bOnlyPop;
+
+  // and leave it empty
+  move.sa_pItems = NULL;
+  move.sa_ctSlots = 0;
+  move.sa_ctUsed = 0;
+
+  return *this;
+}
+
+template<class Type>
+void StackArray<Type>::AllocateSlots(INDEX ctSlots)
+{
+  // resize the memory, realloc keeps the pointers we already have, and leaves them alone if it fails
+  Type** pNewItems = (Type**)realloc(sa_pItems, sizeof(Type*) * ctSlots);
+  if(pNewItems == NULL) {
+    throw std::bad_alloc();
+  }
+  sa_pItems = pNewItems;
+  sa_ctSlots = ctSlots;
+}
+
+template<class Type>
+void StackArray<Type>::GrowSlots(void)
+{
+  // grow geometrically, so pushing one by one only reallocates a logarithmic amount of times
+  AllocateSlots(Max(sa_ctSlots * 2, (INDEX)16));
 }
 
 /// Push to the beginning of the stack, return a reference to the newly made object
 template<class Type>
 Type& StackArray<Type>::PushBegin(void)
 {
-  MutexWait wait(sa_mutex);
-
   // PushBegin() in combination with sa_bOnlyPop will cause memory leaking if not manually Clear()'d
   ASSERT(!sa_bOnlyPop);
 
   // if we need more slots
   if(sa_ctUsed >= sa_ctSlots) {
     // allocate some more
-    AllocateSlots(256);
+    GrowSlots();
   }
 
   // create the new object
   Type* tNewObject = new Type;
 
   // make some room
-  for(int i=sa_ctUsed; i>0; i--) {
-    sa_pItems[i] = sa_pItems[i-1];
-  }
+  memmove(sa_pItems + 1, sa_pItems, sizeof(Type*) * sa_ctUsed);
 
   // push it onto the beginning of the stack
   sa_pItems[0] = tNewObject;
@@ -138,15 +180,13 @@ Type& StackArray<Type>::PushBegin(void)
 template<class Type>
 Type& StackArray<Type>::Push(void)
 {
-  MutexWait wait(sa_mutex);
-
   // Push() in combination with sa_bOnlyPop will cause memory leaking if not manually Clear()'d
   ASSERT(!sa_bOnlyPop);
 
   // if we need more slots
   if(sa_ctUsed >= sa_ctSlots) {
     // allocate some more
-    AllocateSlots(256);
+    GrowSlots();
   }
 
   // create the new object
@@ -166,12 +206,10 @@ Type& StackArray<Type>::Push(void)
 template<class Type>
 void StackArray<Type>::Push(Type* pObj)
 {
-  MutexWait wait(sa_mutex);
-
   // if we need more slots
   if(sa_ctUsed >= sa_ctSlots) {
     // allocate some more
-    AllocateSlots(256);
+    GrowSlots();
   }
 
   // push it onto the stack
@@ -181,12 +219,36 @@ void StackArray<Type>::Push(Type* pObj)
   sa_ctUsed++;
 }
 
+/// Move an object onto the stack, return a reference to the newly made object
+template<class Type>
+Type& StackArray<Type>::Push(Type &&obj)
+{
+  // Push() in combination with sa_bOnlyPop will cause memory leaking if not manually Clear()'d
+  ASSERT(!sa_bOnlyPop);
+
+  // if we need more slots
+  if(sa_ctUsed >= sa_ctSlots) {
+    // allocate some more
+    GrowSlots();
+  }
+
+  // create the new object using the move constructor
+  Type* tNewObject = new Type(std::move(obj));
+
+  // push it onto the stack
+  sa_pItems[sa_ctUsed] = tNewObject;
+
+  // increase iterator
+  sa_ctUsed++;
+
+  // return new object
+  return *tNewObject;
+}
+
 /// Pop top object from the stack
 template<class Type>
 Type* StackArray<Type>::Pop(void)
 {
-  MutexWait wait(sa_mutex);
-
   ASSERT(sa_ctUsed > 0);
 
   // decrease iterator
@@ -206,8 +268,6 @@ Type* StackArray<Type>::Pop(void)
 template<class Type>
 Type* StackArray<Type>::PopAt(INDEX iIndex)
 {
-  MutexWait wait(sa_mutex);
-
   ASSERT(iIndex < sa_ctUsed);
 
   // decrease iterator
@@ -217,10 +277,7 @@ Type* StackArray<Type>::PopAt(INDEX iIndex)
   Type* tObject = sa_pItems[iIndex];
 
   // move pointers at the right one point to the left
-  for(INDEX i=iIndex; i<sa_ctUsed; i++) {
-    // set pointer to next one in stack
-    sa_pItems[i] = sa_pItems[i + 1];
-  }
+  memmove(sa_pItems + iIndex, sa_pItems + iIndex + 1, sizeof(Type*) * (sa_ctUsed - iIndex));
 
   // set last pointer to NULL (just in case)
   sa_pItems[sa_ctUsed] = NULL;
@@ -229,12 +286,79 @@ Type* StackArray<Type>::PopAt(INDEX iIndex)
   return tObject;
 }
 
+/// Remove every object the condition holds for in a single pass, return how many were removed
+template<class Type>
+template<typename Func>
+INDEX StackArray<Type>::RemoveIf(Func f)
+{
+  // keep the pointers that stay in order, writing them over the removed ones
+  INDEX iKeep = 0;
+  for(INDEX i=0; i<sa_ctUsed; i++) {
+    Type* pObj = sa_pItems[i];
+    if(f(*pObj)) {
+      // only delete objects we own
+      if(!sa_bOnlyPop) {
+        delete pObj;
+      }
+    } else {
+      sa_pItems[iKeep++] = pObj;
+    }
+  }
+
+  // set the remaining pointers to NULL (just to be sure)
+  INDEX ctRemoved = sa_ctUsed - iKeep;
+  for(INDEX i=iKeep; i<sa_ctUsed; i++) {
+    sa_pItems[i] = NULL;
+  }
+  sa_ctUsed = iKeep;
+
+  return ctRemoved;
+}
+
+/// Remove a certain index by moving the top object into its place, which doesn't keep the order
+template<class Type>
+void StackArray<Type>::SwapRemoveAt(INDEX iIndex)
+{
+  ASSERT(iIndex >= 0 && iIndex < sa_ctUsed);
+
+  // only delete objects we own
+  if(!sa_bOnlyPop) {
+    delete sa_pItems[iIndex];
+  }
+
+  // decrease iterator and fill the hole with the top object
+  sa_ctUsed--;
+  sa_pItems[iIndex] = sa_pItems[sa_ctUsed];
+  sa_pItems[sa_ctUsed] = NULL;
+}
+
+/// Remove a range of objects, moving the objects after it only once
+template<class Type>
+void StackArray<Type>::RemoveRange(INDEX iStart, INDEX ct)
+{
+  ASSERT(iStart >= 0 && ct >= 0 && iStart + ct <= sa_ctUsed);
+
+  // only delete objects we own
+  if(!sa_bOnlyPop) {
+    for(INDEX i=iStart; i<iStart + ct; i++) {
+      delete sa_pItems[i];
+    }
+  }
+
+  // move the pointers after the range to its start
+  memmove(sa_pItems + iStart, sa_pItems + iStart + ct, sizeof(Type*) * (sa_ctUsed - iStart - ct));
+
+  // set the remaining pointers to NULL (just to be sure)
+  sa_ctUsed -= ct;
+  for(INDEX i=sa_ctUsed; i<sa_ctUsed + ct; i++) {
+    sa_pItems[i] = NULL;
+  }
+}
+
 /// Pop all objects from the stack
 template<class Type>
 void StackArray<Type>::PopAll(void)
 {
-  MutexWait wait(sa_mutex);
-
   // for every object
   for(INDEX i=0; i<sa_ctUsed; i++) {
     // set remaining pointer to NULL (just to be sure)
@@ -249,8 +373,6 @@ void StackArray<Type>::PopAll(void)
 template<class Type>
 void StackArray<Type>::Clear(void)
 {
-  MutexWait wait(sa_mutex);
-
   // for every object
   for(INDEX i=0; i<sa_ctUsed; i++) {
     // delete it
@@ -265,18 +387,128 @@ void StackArray<Type>::Clear(void)
 
 /// Return how many objects there currently are in the stack
 template<class Type>
-INDEX StackArray<Type>::Count(void)
+INDEX StackArray<Type>::Count(void) const
 {
-  MutexWait wait(sa_mutex);
   return sa_ctUsed;
 }
 
+/// Return how many objects the stack can hold without reallocating
+template<class Type>
+INDEX StackArray<Type>::Capacity(void)
+{
+  return sa_ctSlots;
+}
+
+/// Make sure the stack can hold at least the given amount of objects without reallocating
+template<class Type>
+void StackArray<Type>::Reserve(INDEX ctSlots)
+{
+  if(ctSlots > sa_ctSlots) {
+    AllocateSlots(ctSlots);
+  }
+}
+
+/// Give back any slots the stack currently doesn't use
+template<class Type>
+void StackArray<Type>::ShrinkToFit(void)
+{
+  if(sa_ctUsed == sa_ctSlots) {
+    return;
+  }
+
+  if(sa_ctUsed == 0) {
+    free(sa_pItems);
+    sa_pItems = NULL;
+    sa_ctSlots = 0;
+  } else {
+    AllocateSlots(sa_ctUsed);
+  }
+}
+
+/// Sort the stack by moving the pointers around, using the less than operator of the objects
+template<class Type>
+void StackArray<Type>::Sort(void)
+{
+  Sort([](const Type &obj1, const Type &obj2) { return obj1 < obj2; });
+}
+
+/// Sort the stack by moving the pointers around, using the given less than function
+template<class Type>
+template<typename Func>
+void StackArray<Type>::Sort(Func fLess)
+{
+  // only the pointers move, the objects stay where they are
+  std::sort(sa_pItems, sa_pItems + sa_ctUsed, [&fLess](const Type* p1, const Type* p2) {
+    return fLess(*p1, *p2);
+  });
+}
+
+/// Sort the stack, keeping equal objects in the order they were in
+template<class Type>
+void StackArray<Type>::StableSort(void)
+{
+  StableSort([](const Type &obj1, const Type &obj2) { return obj1 < obj2; });
+}
+
+/// Sort the stack with the given less than function, keeping equal objects in the order they were in
+template<class Type>
+template<typename Func>
+void StackArray<Type>::StableSort(Func fLess)
+{
+  std::stable_sort(sa_pItems, sa_pItems + sa_ctUsed, [&fLess](const Type* p1, const Type* p2) {
+    return fLess(*p1, *p2);
+  });
+}
+
+/// Find the index of the first object in a sorted stack that isn't less than the given object
+template<class Type>
+INDEX StackArray<Type>::LowerBound(const Type &obj)
+{
+  return LowerBound(obj, [](const Type &obj1, const Type &obj2) { return obj1 < obj2; });
+}
+
+/// Find the index of the first object in a sorted stack that isn't less than the given object, using the given less than function
+template<class Type>
+template<typename Func>
+INDEX StackArray<Type>::LowerBound(const Type &obj, Func fLess)
+{
+  INDEX iLow = 0;
+  INDEX iHigh = sa_ctUsed;
+  while(iLow < iHigh) {
+    INDEX iMiddle = iLow + (iHigh - iLow) / 2;
+    if(fLess(*sa_pItems[iMiddle], obj)) {
+      iLow = iMiddle + 1;
+    } else {
+      iHigh = iMiddle;
+    }
+  }
+  return iLow;
+}
+
+/// Find the index of the given object in a sorted stack
+template<class Type>
+INDEX StackArray<Type>::BinarySearch(const Type &obj)
+{
+  return BinarySearch(obj, [](const Type &obj1, const Type &obj2) { return obj1 < obj2; });
+}
+
+/// Find the index of the given object in a stack sorted with the given less than function
+template<class Type>
+template<typename Func>
+INDEX StackArray<Type>::BinarySearch(const Type &obj, Func fLess)
+{
+  // the lower bound is the object we're looking for, unless it's greater
+  INDEX iIndex = LowerBound(obj, fLess);
+  if(iIndex < sa_ctUsed && !fLess(obj, *sa_pItems[iIndex])) {
+    return iIndex;
+  }
+  return -1;
+}
+
 /// Find the index of the given object in the stack
 template<class Type>
 INDEX StackArray<Type>::Find(const Type &obj)
 {
-  MutexWait wait(sa_mutex);
-
   // for every object
   for(INDEX i=0; i<sa_ctUsed; i++) {
     // test if it's the given one
@@ -292,8 +524,6 @@ INDEX StackArray<Type>::Find(const Type &obj)
 template<class Type>
 INDEX StackArray<Type>::FindPointer(const Type* pObj)
 {
-  MutexWait wait(sa_mutex);
-
   // for every object
   for(INDEX i=0; i<sa_ctUsed; i++) {
     // test if it's the given one
@@ -310,8 +540,6 @@ template<class Type>
 template<typename Func>
 INDEX StackArray<Type>::FindAny(Func f)
 {
-  MutexWait wait(sa_mutex);
-
   // for every object
   for(INDEX i=0; i<sa_ctUsed; i++) {
     // test with function
@@ -347,7 +575,13 @@ BOOL StackArray<Type>::ContainsAny(Func f)
 template<class Type>
 Type& StackArray<Type>::operator[](INDEX iIndex)
 {
-  MutexWait wait(sa_mutex);
+  ASSERT(iIndex >= 0 && iIndex < sa_ctUsed);
+  return *sa_pItems[iIndex];
+}
+
+template<class Type>
+const Type& StackArray<Type>::operator[](INDEX iIndex) const
+{
   ASSERT(iIndex >= 0 && iIndex < sa_ctUsed);
   return *sa_pItems[iIndex];
 }
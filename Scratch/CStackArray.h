@@ -27,10 +27,15 @@
 #ifndef SCRATCH_CSTACKARRAY_H_INCLUDED
 #define SCRATCH_CSTACKARRAY_H_INCLUDED
 
-#include "CMutex.h"
+#include "Common.h"
+
+#include <cstddef>
+#include <iterator>
 
 SCRATCH_NAMESPACE_BEGIN;
 
+/// Array of pointers to objects. It is not locked, so a StackArray that's modified by one thread
+/// can't be used by others at the same time. Use ConcurrentArray for objects pushed from multiple threads.
 template<class Type>
 class SCRATCH_EXPORT StackArray
 {
@@ -39,31 +44,50 @@ public:
   INDEX sa_ctSlots;
   INDEX sa_ctUsed;
   BOOL sa_bOnlyPop;
-  Mutex sa_mutex;
 
 public:
 	StackArray(void);
 	StackArray(const StackArray<Type> &copy); // Note: If this ever gets called, you're most likely writing bad code.
+	StackArray(StackArray<Type> &&move);
 	~StackArray(void);
 
+  /// Take over the objects of another stack, clearing this one first
+  StackArray<Type>& operator=(StackArray<Type> &&move);
+
   /// Push to the beginning of the stack, return a reference to the newly made object
   Type& PushBegin(void);
   /// Push to the stack, return a reference to the newly made object
   Type& Push(void);
   /// Push a pointer to the stack
   void Push(Type* pObj);
+  /// Move an object onto the stack, return a reference to the newly made object
+  Type& Push(Type &&obj);
   /// Pop top object from the stack
   Type* Pop(void);
   /// Pop a certain index from the stack
   Type* PopAt(INDEX iIndex);
 
+  /// Remove every object the condition holds for in a single pass, return how many were removed
+  template<typename Func>
+  INDEX RemoveIf(Func f);
+  /// Remove a certain index by moving the top object into its place, which doesn't keep the order
+  void SwapRemoveAt(INDEX iIndex);
+  /// Remove a range of objects, moving the objects after it only once
+  void RemoveRange(INDEX iStart, INDEX ct);
+
   /// Pop all objects from the stack
   void PopAll(void);
   /// Clear all objects in the stack
   void Clear(void);
 
   /// Return how many objects there currently are in the stack
-  INDEX Count(void);
+  INDEX Count(void) const;
+  /// Return how many objects the stack can hold without reallocating
+  INDEX Capacity(void);
+  /// Make sure the stack can hold at least the given amount of objects without reallocating
+  void Reserve(INDEX ctSlots);
+  /// Give back any slots the stack currently doesn't use
+  void ShrinkToFit(void);
 
   /// Find the index of the given object in the stack
   INDEX Find(const Type &obj);
@@ -73,6 +97,28 @@ public:
   template<typename Func>
   INDEX FindAny(Func f);
 
+  /// Sort the stack by moving the pointers around, using the less than operator of the objects
+  void Sort(void);
+  /// Sort the stack by moving the pointers around, using the given less than function
+  template<typename Func>
+  void Sort(Func fLess);
+  /// Sort the stack, keeping equal objects in the order they were in
+  void StableSort(void);
+  /// Sort the stack with the given less than function, keeping equal objects in the order they were in
+  template<typename Func>
+  void StableSort(Func fLess);
+
+  /// Find the index of the first object in a sorted stack that isn't less than the given object
+  INDEX LowerBound(const Type &obj);
+  /// Find the index of the first object in a sorted stack that isn't less than the given object, using the given less than function
+  template<typename Func>
+  INDEX LowerBound(const Type &obj, Func fLess);
+  /// Find the index of the given object in a sorted stack
+  INDEX BinarySearch(const Type &obj);
+  /// Find the index of the given object in a stack sorted with the given less than function
+  template<typename Func>
+  INDEX BinarySearch(const Type &obj, Func fLess);
+
   /// Returns whether the given object is currently in the stack
   BOOL Contains(const Type &obj);
   /// Returns whether the given pointer is currently in the stack
@@ -82,9 +128,38 @@ public:
   BOOL ContainsAny(Func f);
 
   Type& operator[](INDEX iIndex);
+  const Type& operator[](INDEX iIndex) const;
+
+  /// Walks the pointers of a stack directly, for range-for loops and standard algorithms
+  class Iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Type* pointer;
+    typedef Type& reference;
+
+    Type** it_ppItem;
+
+    inline Iterator(Type** ppItem) : it_ppItem(ppItem) {}
+
+    inline Type& operator*() const { return **it_ppItem; }
+    inline Type* operator->() const { return *it_ppItem; }
+    inline Iterator& operator++() { it_ppItem++; return *this; }
+    inline Iterator operator++(int) { Iterator itOld = *this; it_ppItem++; return itOld; }
+    inline bool operator==(const Iterator &it) const { return it_ppItem == it.it_ppItem; }
+    inline bool operator!=(const Iterator &it) const { return it_ppItem != it.it_ppItem; }
+  };
+
+  /// Iterator at the first object; pushing or removing objects invalidates it
+  inline Iterator begin(void) { return Iterator(sa_pItems); }
+  /// Iterator after the last object
+  inline Iterator end(void) { return Iterator(sa_pItems + sa_ctUsed); }
 
 private:
   void AllocateSlots(INDEX ctSlots);
+  void GrowSlots(void);
 };
 
 SCRATCH_NAMESPACE_END;
@@ -44,7 +44,7 @@ void Stream::Close(void)
 
 void Stream::WriteString(const String &str)
 {
-  Write((const char*)str, strlen(str) + 1);
+  Write((const char*)str, str.Length() + 1);
 }
 
 void Stream::WriteStream(Stream &strm)
@@ -99,7 +99,7 @@ String Stream::ReadString(void)
 
 bool Stream::Expect(const String &str)
 {
-  int iLen = strlen(str);
+  int iLen = str.Length();
 
   char* szBuffer = new char[iLen+1];
   szBuffer[iLen] = '\0';
@@ -134,7 +134,7 @@ char Stream::ReadUntil(String &strOut, const String &strCharacters)
 void Stream::WriteText(const String &str)
 {
   // write text
-  Write((const char*)str, strlen(str));
+  Write((const char*)str, str.Length());
 }
 
 void Stream::WriteLine(const String &str)
@@ -27,55 +27,201 @@
 #include <cstdio> // for vsprintf
 #include <cstdarg> // for va_list
 #include <cstring> // for strlen and strcmp
+#include <cstdlib> // for malloc and realloc
+#include <atomic>
+#include <new> // for placement new and bad_alloc
 #include <ctype.h>
 
 #include "CString.h"
+#include "StringSearch.h"
+#include "StringConvert.h"
+#include "StringUtf8.h"
+#include "Hash.h"
 
 SCRATCH_NAMESPACE_BEGIN;
 
-int String::str_iInstances = 0;
+std::atomic<int> String::str_iInstances(0);
 char* String::str_szEmpty = (char*)"";
 
-void String::CopyToBuffer(const char* szSrc)
+// Heap buffers are preceded by a reference count, so copies of a string can share its buffer
+// until one of them is modified. Once a reference into the buffer has been handed out, the
+// owner could write through it at any time, so the buffer is never shared again.
+struct StringHeapHeader
 {
-  // Validate the source string
-  if(szSrc == NULL) {
+  std::atomic<int> shh_ctRefs;
+  bool shh_bUnshareable;
+};
+
+static inline StringHeapHeader* HeapHeader(const char* szBuffer)
+{
+  return (StringHeapHeader*)(szBuffer - sizeof(StringHeapHeader));
+}
+
+static char* AllocateHeap(int iCapacity)
+{
+  char* pMemory = new char[sizeof(StringHeapHeader) + iCapacity + 1];
+  new(pMemory) StringHeapHeader;
+  ((StringHeapHeader*)pMemory)->shh_ctRefs.store(1, std::memory_order_relaxed);
+  ((StringHeapHeader*)pMemory)->shh_bUnshareable = false;
+  return pMemory + sizeof(StringHeapHeader);
+}
+
+void String::ReleaseBuffer(char* szHeap)
+{
+  if(szHeap == NULL) {
     return;
   }
 
-  int iLen = strlen(szSrc);
-  if(iLen == 0) {
-    // Clean up
-    if(this->str_szBuffer != String::str_szEmpty) {
-      delete[] this->str_szBuffer;
-    }
+  // The last string to let go of a buffer frees it
+  StringHeapHeader* pHeader = HeapHeader(szHeap);
+  if(pHeader->shh_ctRefs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    pHeader->~StringHeapHeader();
+    delete[] (char*)pHeader;
+  }
+}
+
+bool String::IsSharedBuffer() const
+{
+  return this->IsHeapBuffer() && HeapHeader(this->str_szBuffer)->shh_ctRefs.load(std::memory_order_acquire) > 1;
+}
+
+void String::UnshareBuffer()
+{
+  // Get a private copy of the buffer before writing to it
+  if(this->IsSharedBuffer()) {
+    ReleaseBuffer(this->SwapBuffer(this->str_iCapacity));
+  }
+}
+
+void String::ShareBuffer(const String &strSrc)
+{
+  // Our own buffer should've been cleaned up already.
+  ASSERT(!this->IsHeapBuffer());
+
+  if(strSrc.IsHeapBuffer() && !HeapHeader(strSrc.str_szBuffer)->shh_bUnshareable) {
+    // Heap buffers get another owner
+    HeapHeader(strSrc.str_szBuffer)->shh_ctRefs.fetch_add(1, std::memory_order_relaxed);
+    this->str_szBuffer = strSrc.str_szBuffer;
+    this->str_iLength = strSrc.str_iLength;
+    this->str_iCapacity = strSrc.str_iCapacity;
+  } else {
+    // Short strings are cheaper to copy than to share, and unshareable ones must be copied
+    this->CopyToBuffer(strSrc.str_szBuffer, strSrc.str_iLength);
+  }
+}
+
+void String::FreeBuffer()
+{
+  // Only heap buffers have to be cleaned up, the inline buffer lives inside the object.
+  if(this->IsHeapBuffer()) {
+    ReleaseBuffer(this->str_szBuffer);
+  }
 
-    // Set to empty char*
+  // Set to empty char*
+  this->str_szBuffer = String::str_szEmpty;
+  this->str_iLength = 0;
+  this->str_iCapacity = 0;
+}
+
+char* String::SwapBuffer(int iCapacity)
+{
+  // The caller is responsible for releasing the old heap buffer, so that it can
+  // still read from it (for example when appending a string to itself).
+  char* szOldBuffer = this->str_szBuffer;
+  char* szOldHeap = this->IsHeapBuffer() ? szOldBuffer : NULL;
+
+  if(iCapacity <= 0) {
+    // Nothing to hold, use the empty char*
+    ASSERT(this->str_iLength == 0);
     this->str_szBuffer = String::str_szEmpty;
+    this->str_iCapacity = 0;
+
+  } else if(iCapacity < CSTRING_INLINE_BUFFER_SIZE) {
+    // Short strings go into the inline buffer.
+    if(szOldBuffer != this->str_acInline) {
+      memcpy(this->str_acInline, szOldBuffer, this->str_iLength + 1);
+    }
+    this->str_szBuffer = this->str_acInline;
+    this->str_iCapacity = CSTRING_INLINE_BUFFER_SIZE - 1;
+
+  } else {
+    // Allocate new memory and copy the current data (including the null terminator) to it.
+    this->str_szBuffer = AllocateHeap(iCapacity);
+    memcpy(this->str_szBuffer, szOldBuffer, this->str_iLength + 1);
+    this->str_iCapacity = iCapacity;
+  }
+
+  return szOldHeap;
+}
+
+void String::GrowBuffer(int iCapacity)
+{
+  // Check if we need to make more room, a shared buffer is about to be written to so it's copied either way.
+  if(iCapacity <= this->str_iCapacity) {
+    this->UnshareBuffer();
+    return;
+  }
+
+  // Grow geometrically so appending one character at a time stays amortized O(1).
+  ReleaseBuffer(this->SwapBuffer(Max(iCapacity, this->str_iCapacity * 2)));
+}
+
+void String::CopyToBuffer(const char* szSrc)
+{
+  // Validate the source string
+  if(szSrc == NULL) {
     return;
   }
 
-  // Find the current size and the required size for the string.
-  int iBufLen = strlen(this->str_szBuffer) + 1;
-  int iReqLen = iLen + 1;
+  this->CopyToBuffer(szSrc, strlen(szSrc));
+}
 
-  // Check if we need to make more room.
-  if(iReqLen > iBufLen) {
-    // Get rid of the previously allocated space and allocate new memory.
-    if(this->str_szBuffer != String::str_szEmpty) {
-      delete[] this->str_szBuffer;
-    }
-    this->str_szBuffer = new char[iReqLen];
+void String::CopyToBuffer(const char* szSrc, int iLen)
+{
+  if(iLen <= 0) {
+    // Clean up
+    this->FreeBuffer();
+    return;
   }
 
-  // Copy data to the buffer.
-  int i = 0;
-  for(; i<iLen; i++) {
-    this->str_szBuffer[i] = szSrc[i];
+  if(iLen > this->str_iCapacity || this->IsSharedBuffer()) {
+    // The old contents are getting overwritten, so don't bother copying them over.
+    this->str_iLength = 0;
+    // Keep the old buffer around until we're done, the source might point into it.
+    char* szOldHeap = this->SwapBuffer(iLen);
+    memcpy(this->str_szBuffer, szSrc, iLen);
+    ReleaseBuffer(szOldHeap);
+  } else {
+    memmove(this->str_szBuffer, szSrc, iLen);
   }
 
   // Always end with a null terminator.
-  this->str_szBuffer[i] = '\0';
+  this->str_szBuffer[iLen] = '\0';
+  this->str_iLength = iLen;
+}
+
+void String::TakeBuffer(String &strSrc)
+{
+  // Our own buffer should've been cleaned up already.
+  ASSERT(!this->IsHeapBuffer());
+
+  if(strSrc.IsHeapBuffer()) {
+    // Heap buffers simply change owner.
+    this->str_szBuffer = strSrc.str_szBuffer;
+  } else if(strSrc.str_szBuffer == strSrc.str_acInline) {
+    // The inline buffer lives inside the other object, so it has to be copied.
+    memcpy(this->str_acInline, strSrc.str_acInline, strSrc.str_iLength + 1);
+    this->str_szBuffer = this->str_acInline;
+  } else {
+    this->str_szBuffer = String::str_szEmpty;
+  }
+  this->str_iLength = strSrc.str_iLength;
+  this->str_iCapacity = strSrc.str_iCapacity;
+
+  // Leave the other string empty.
+  strSrc.str_szBuffer = String::str_szEmpty;
+  strSrc.str_iLength = 0;
+  strSrc.str_iCapacity = 0;
 }
 
 void String::AppendToBuffer(const char* szSrc)
@@ -94,33 +240,21 @@ void String::AppendToBuffer(const char* szSrc, int iCount)
     return;
   }
 
-  // Keep track of our previous buffer pointer so we can use it later for appending.
-  char* szOldBuffer = this->str_szBuffer;
-
-  // Find the current size and the required size for the string.
-  int iBufLen = strlen(this->str_szBuffer);
+  int iNewLen = this->str_iLength + iCount;
 
-  // Get ourselves a new buffer
-  this->str_szBuffer = new char[iBufLen + iCount + 1];
-
-  // Copy the buffers
-  int iOffset = 0;
-
-  for(int i=0; i<iBufLen; i++) {
-    this->str_szBuffer[iOffset++] = szOldBuffer[i];
-  }
-
-  for(int i=0; i<iCount; i++) {
-    this->str_szBuffer[iOffset++] = szSrc[i];
+  if(iNewLen > this->str_iCapacity || this->IsSharedBuffer()) {
+    // Grow geometrically, but keep the old buffer around until we're done
+    // because the source might point into it.
+    char* szOldHeap = this->SwapBuffer(Max(iNewLen, this->str_iCapacity * 2));
+    memcpy(this->str_szBuffer + this->str_iLength, szSrc, iCount);
+    ReleaseBuffer(szOldHeap);
+  } else {
+    memmove(this->str_szBuffer + this->str_iLength, szSrc, iCount);
   }
 
   // Always end with a null terminator.
-  this->str_szBuffer[iOffset] = '\0';
-
-  // Clean up
-  if(szOldBuffer != String::str_szEmpty) {
-    delete[] szOldBuffer;
-  }
+  this->str_szBuffer[iNewLen] = '\0';
+  this->str_iLength = iNewLen;
 }
 
 void String::AppendToBuffer(const char cSrc)
@@ -130,85 +264,133 @@ void String::AppendToBuffer(const char cSrc)
     return;
   }
 
-  // Keep track of our previous buffer pointer so we can use it later for appending.
-  char* szOldBuffer = this->str_szBuffer;
-
-  // Find the current size and the required size for the string.
-  int iBufLen = strlen(this->str_szBuffer);
-
-  // Get ourselves a new buffer
-  this->str_szBuffer = new char[iBufLen + 2];
-
-  // Copy the buffer
-  int iOffset = 0;
-
-  for(int i=0; i<iBufLen; i++) {
-    this->str_szBuffer[iOffset++] = szOldBuffer[i];
-  }
-
-  // Append the new character
-  this->str_szBuffer[iOffset++] = cSrc;
+  // Make room for one more character
+  this->GrowBuffer(this->str_iLength + 1);
 
-  // Always end with a null terminator.
-  this->str_szBuffer[iOffset] = '\0';
-
-  // Clean up
-  if(szOldBuffer != String::str_szEmpty) {
-    delete[] szOldBuffer;
-  }
+  this->str_szBuffer[this->str_iLength++] = cSrc;
+  this->str_szBuffer[this->str_iLength] = '\0';
 }
 
 String::String()
 {
-  str_iInstances++;
+  str_iInstances.fetch_add(1, std::memory_order_relaxed);
   // Create a new empty buffer
   this->str_szBuffer = String::str_szEmpty;
+  this->str_iLength = 0;
+  this->str_iCapacity = 0;
 }
 
 String::String(const char* szStr)
 {
-  str_iInstances++;
+  str_iInstances.fetch_add(1, std::memory_order_relaxed);
   // Create a new buffer and copy data into it.
   this->str_szBuffer = String::str_szEmpty;
+  this->str_iLength = 0;
+  this->str_iCapacity = 0;
   this->CopyToBuffer(szStr);
 }
 
 String::String(const char* szValue, int iStart, int iLength)
 {
-  str_iInstances++;
+  str_iInstances.fetch_add(1, std::memory_order_relaxed);
   // Create a new buffer and copy data into it.
   this->str_szBuffer = String::str_szEmpty;
-  this->AppendToBuffer(szValue + iStart, iLength);
+  this->str_iLength = 0;
+  this->str_iCapacity = 0;
+  this->CopyToBuffer(szValue + iStart, iLength);
 }
 
 String::String(const String &copy)
 {
-  str_iInstances++;
-  MutexWait wait(copy.str_mutex);
-  // Create a new buffer and copy data into it.
+  str_iInstances.fetch_add(1, std::memory_order_relaxed);
+  // Share the other string's buffer until one of us changes.
+  this->str_szBuffer = String::str_szEmpty;
+  this->str_iLength = 0;
+  this->str_iCapacity = 0;
+  this->ShareBuffer(copy);
+}
+
+String::String(String &&strMove)
+{
+  str_iInstances.fetch_add(1, std::memory_order_relaxed);
+  // Take over the other string's buffer instead of copying it.
   this->str_szBuffer = String::str_szEmpty;
-  this->CopyToBuffer(copy);
+  this->str_iLength = 0;
+  this->str_iCapacity = 0;
+  this->TakeBuffer(strMove);
+}
+
+String::String(const StringView &strView)
+{
+  str_iInstances.fetch_add(1, std::memory_order_relaxed);
+  // Create a new buffer and copy the viewed characters into it.
+  this->str_szBuffer = String::str_szEmpty;
+  this->str_iLength = 0;
+  this->str_iCapacity = 0;
+  this->CopyToBuffer(strView.sv_szBuffer, strView.sv_iLength);
 }
 
 String::~String()
 {
-  str_iInstances--;
+  str_iInstances.fetch_sub(1, std::memory_order_relaxed);
   // Clean up
-  if(this->str_szBuffer != String::str_szEmpty) {
-    delete[] this->str_szBuffer;
-  }
+  this->FreeBuffer();
 }
 
 int String::Length() const
 {
-  MutexWait wait(str_mutex);
-  return strlen(this->str_szBuffer);
+  return this->str_iLength;
 }
 
-void String::SetF(const char* szFormat, ...)
+int String::Capacity() const
+{
+  return this->str_iCapacity;
+}
+
+void String::Reserve(int ctChars)
+{
+  // Writing into the reserved room must not change other strings sharing the buffer
+  if(ctChars > this->str_iCapacity) {
+    ReleaseBuffer(this->SwapBuffer(ctChars));
+  } else {
+    this->UnshareBuffer();
+  }
+}
+
+void String::ShrinkToFit()
+{
+  // Only heap buffers can have room to spare that's worth giving back
+  if(this->IsHeapBuffer() && this->str_iLength < this->str_iCapacity) {
+    ReleaseBuffer(this->SwapBuffer(this->str_iLength));
+  }
+}
+
+void String::Clear()
+{
+  // Don't write into a buffer someone else is looking at
+  if(this->IsSharedBuffer()) {
+    this->FreeBuffer();
+    return;
+  }
+
+  if(this->str_iLength > 0) {
+    this->str_szBuffer[0] = '\0';
+    this->str_iLength = 0;
+  }
+}
+
+StringView String::View() const
+{
+  return StringView(this->str_szBuffer, this->str_iLength);
+}
+
+StringView String::View(int iStart, int iLen) const
 {
-  MutexWait wait(str_mutex);
+  return this->View().SubString(iStart, iLen);
+}
 
+void String::SetF(const char* szFormat, ...)
+{
   int iSize = CSTRING_FORMAT_BUFFER_SIZE;
   char* szBuffer = new char[iSize];
 
@@ -235,8 +417,6 @@ void String::SetF(const char* szFormat, ...)
 
 void String::AppendF(const char* szFormat, ...)
 {
-  MutexWait wait(str_mutex);
-
   int iSize = CSTRING_FORMAT_BUFFER_SIZE;
   char* szBuffer = new char[iSize];
 
@@ -261,6 +441,299 @@ void String::AppendF(const char* szFormat, ...)
   delete[] szBuffer;
 }
 
+void String::AppendInt(long long iValue)
+{
+  char acBuffer[STRINGCONVERT_MAX_CHARS];
+  this->AppendToBuffer(acBuffer, strFromInt(acBuffer, iValue));
+}
+
+void String::AppendUInt(unsigned long long ulValue)
+{
+  char acBuffer[STRINGCONVERT_MAX_CHARS];
+  this->AppendToBuffer(acBuffer, strFromUInt(acBuffer, ulValue));
+}
+
+void String::AppendFloat(float fValue)
+{
+  char acBuffer[STRINGCONVERT_MAX_CHARS];
+  this->AppendToBuffer(acBuffer, strFromFloat(acBuffer, fValue));
+}
+
+void String::AppendDouble(double dValue)
+{
+  char acBuffer[STRINGCONVERT_MAX_CHARS];
+  this->AppendToBuffer(acBuffer, strFromDouble(acBuffer, dValue));
+}
+
+void String::AppendHex(unsigned long long ulValue)
+{
+  char acBuffer[STRINGCONVERT_MAX_CHARS];
+  this->AppendToBuffer(acBuffer, strFromHex(acBuffer, ulValue));
+}
+
+const char* String::AppendFormatLiteral(const char* szFormat, FormatSpec &spec)
+{
+  for(;;) {
+    // Copy everything up to the next placeholder as is
+    const char* szPercent = strchr(szFormat, '%');
+    if(szPercent == NULL) {
+      this->AppendToBuffer(szFormat);
+      return NULL;
+    }
+    this->AppendToBuffer(szFormat, szPercent - szFormat);
+
+    if(szPercent[1] == '%') {
+      this->AppendToBuffer('%');
+      szFormat = szPercent + 2;
+      continue;
+    }
+
+    // Flags, width, precision and length modifiers, in that order
+    const char* sz = szPercent + 1;
+    spec.fs_bLeftAlign = false;
+    spec.fs_bZeroPad = false;
+    spec.fs_iWidth = 0;
+    spec.fs_iPrecision = -1;
+    for(; *sz == '-' || *sz == '0'; sz++) {
+      if(*sz == '-') {
+        spec.fs_bLeftAlign = true;
+      } else {
+        spec.fs_bZeroPad = true;
+      }
+    }
+    for(; *sz >= '0' && *sz <= '9'; sz++) {
+      spec.fs_iWidth = spec.fs_iWidth * 10 + (*sz - '0');
+    }
+    if(*sz == '.') {
+      spec.fs_iPrecision = 0;
+      for(sz++; *sz >= '0' && *sz <= '9'; sz++) {
+        spec.fs_iPrecision = spec.fs_iPrecision * 10 + (*sz - '0');
+      }
+    }
+    while(*sz == 'h' || *sz == 'l' || *sz == 'z') {
+      sz++;
+    }
+
+    // A lone '%' at the very end has nothing to format
+    if(*sz == '\0') {
+      return NULL;
+    }
+    spec.fs_cType = *sz;
+    return sz + 1;
+  }
+}
+
+void String::AppendFormatArgs(const char* szFormat)
+{
+  // Out of arguments, so only the text remains and any placeholders left are dropped
+  FormatSpec spec;
+  while(szFormat != NULL) {
+    szFormat = this->AppendFormatLiteral(szFormat, spec);
+  }
+}
+
+void String::AppendFormatPadded(const FormatSpec &spec, const char* szValue, int iLen, bool bNumber)
+{
+  int ctPad = spec.fs_iWidth - iLen;
+  if(ctPad <= 0) {
+    this->AppendToBuffer(szValue, iLen);
+    return;
+  }
+
+  // Keep the old buffer around until we're done, the value might point into it
+  int iNewLen = this->str_iLength + spec.fs_iWidth;
+  char* szOldHeap = NULL;
+  if(iNewLen > this->str_iCapacity || this->IsSharedBuffer()) {
+    szOldHeap = this->SwapBuffer(Max(iNewLen, this->str_iCapacity * 2));
+  }
+
+  char* szDst = this->str_szBuffer + this->str_iLength;
+  if(spec.fs_bLeftAlign) {
+    memcpy(szDst, szValue, iLen);
+    memset(szDst + iLen, ' ', ctPad);
+  } else {
+    // Zeros go between the sign and the digits, and only in front of actual digits
+    int ctSign = (iLen > 0 && (szValue[0] == '-' || szValue[0] == '+')) ? 1 : 0;
+    if(spec.fs_bZeroPad && bNumber && ctSign < iLen && isdigit((UBYTE)szValue[ctSign])) {
+      memcpy(szDst, szValue, ctSign);
+      memset(szDst + ctSign, '0', ctPad);
+      memcpy(szDst + ctSign + ctPad, szValue + ctSign, iLen - ctSign);
+    } else {
+      memset(szDst, ' ', ctPad);
+      memcpy(szDst + ctPad, szValue, iLen);
+    }
+  }
+  ReleaseBuffer(szOldHeap);
+
+  // Always end with a null terminator.
+  this->str_szBuffer[iNewLen] = '\0';
+  this->str_iLength = iNewLen;
+}
+
+void String::AppendFormatValue(const FormatSpec &spec, long long iValue)
+{
+  char acBuffer[STRINGCONVERT_MAX_CHARS];
+  int iLen;
+
+  if(spec.fs_cType == 'c') {
+    this->AppendFormatValue(spec, (char)iValue);
+    return;
+  } else if(spec.fs_cType == 'x' || spec.fs_cType == 'X' || spec.fs_cType == 'u') {
+    // Negative numbers wrap around at the size of the argument, like they do with printf
+    unsigned long long ulValue = (unsigned long long)iValue;
+    if(spec.fs_iArgSize < (int)sizeof(ulValue)) {
+      ulValue &= (1ULL << (spec.fs_iArgSize * 8)) - 1;
+    }
+    this->AppendFormatValue(spec, ulValue);
+    return;
+  } else {
+    iLen = strFromInt(acBuffer, iValue);
+  }
+
+  this->AppendFormatPadded(spec, acBuffer, iLen, true);
+}
+
+void String::AppendFormatValue(const FormatSpec &spec, unsigned long long ulValue)
+{
+  char acBuffer[STRINGCONVERT_MAX_CHARS];
+  int iLen;
+
+  if(spec.fs_cType == 'c') {
+    this->AppendFormatValue(spec, (char)ulValue);
+    return;
+  } else if(spec.fs_cType == 'x' || spec.fs_cType == 'X') {
+    iLen = strFromHex(acBuffer, ulValue);
+    if(spec.fs_cType == 'X') {
+      for(int i=0; i<iLen; i++) {
+        acBuffer[i] = toupper(acBuffer[i]);
+      }
+    }
+  } else {
+    iLen = strFromUInt(acBuffer, ulValue);
+  }
+
+  this->AppendFormatPadded(spec, acBuffer, iLen, true);
+}
+
+void String::AppendFormatValue(const FormatSpec &spec, float fValue)
+{
+  // A precision needs the same rounding as a double
+  if(spec.fs_iPrecision >= 0) {
+    this->AppendFormatValue(spec, (double)fValue);
+    return;
+  }
+
+  char acBuffer[STRINGCONVERT_MAX_CHARS];
+  this->AppendFormatPadded(spec, acBuffer, strFromFloat(acBuffer, fValue), true);
+}
+
+// Write a double with a fixed amount of decimals for the common case of small numbers
+// and precisions, returns -1 when it's up to the C library instead. Scaling by a power of
+// ten is off by at most one rounding step, which only matters very close to a tie.
+static int FormatFixed(char* szDst, double dValue, int iPrecision)
+{
+  static const double _adPowers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+  if(iPrecision > 9 || !(fabs(dValue) < 1e9)) {
+    return -1;
+  }
+
+  double dScaled = fabs(dValue) * _adPowers[iPrecision];
+  double dWhole = floor(dScaled);
+  double dFraction = dScaled - dWhole;
+  if(fabs(dFraction - 0.5) <= dScaled * 1e-15) {
+    return -1;
+  }
+  unsigned long long ulScaled = (unsigned long long)dWhole + (dFraction > 0.5 ? 1 : 0);
+  unsigned long long ulPower = (unsigned long long)_adPowers[iPrecision];
+
+  int iLen = 0;
+  if(std::signbit(dValue)) {
+    szDst[iLen++] = '-';
+  }
+  iLen += strFromUInt(szDst + iLen, ulScaled / ulPower);
+  if(iPrecision > 0) {
+    szDst[iLen++] = '.';
+    unsigned long long ulDecimals = ulScaled % ulPower;
+    for(int i=iPrecision - 1; i>=0; i--) {
+      szDst[iLen + i] = '0' + (ulDecimals % 10);
+      ulDecimals /= 10;
+    }
+    iLen += iPrecision;
+  }
+  return iLen;
+}
+
+void String::AppendFormatValue(const FormatSpec &spec, double dValue)
+{
+  if(spec.fs_iPrecision < 0 || (spec.fs_cType != 'f' && spec.fs_cType != 'e' && spec.fs_cType != 'g')) {
+    char acBuffer[STRINGCONVERT_MAX_CHARS];
+    this->AppendFormatPadded(spec, acBuffer, strFromDouble(acBuffer, dValue), true);
+    return;
+  }
+
+  if(spec.fs_cType == 'f') {
+    char acBuffer[STRINGCONVERT_MAX_CHARS];
+    int iLen = FormatFixed(acBuffer, dValue, spec.fs_iPrecision);
+    if(iLen >= 0) {
+      this->AppendFormatPadded(spec, acBuffer, iLen, true);
+      return;
+    }
+  }
+
+  // Anything else is rounded by the C library, on the stack. The largest double
+  // takes 309 digits before the point, so the precision is capped to fit the buffer.
+  char acFormat[] = "%.*f";
+  acFormat[3] = spec.fs_cType;
+  char acBuffer[400];
+  int iLen = snprintf(acBuffer, sizeof(acBuffer), acFormat, Min(spec.fs_iPrecision, 64), dValue);
+  this->AppendFormatPadded(spec, acBuffer, Min(iLen, (int)sizeof(acBuffer) - 1), true);
+}
+
+void String::AppendFormatValue(const FormatSpec &spec, char cValue)
+{
+  // Numeric placeholders write the character code
+  if(spec.fs_cType == 'd' || spec.fs_cType == 'i' || spec.fs_cType == 'u' || spec.fs_cType == 'x' || spec.fs_cType == 'X') {
+    this->AppendFormatValue(spec, (long long)cValue);
+    return;
+  }
+  this->AppendFormatPadded(spec, &cValue, 1, false);
+}
+
+void String::AppendFormatValue(const FormatSpec &spec, const StringView &strValue)
+{
+  // A precision limits how many characters are written
+  int iLen = strValue.sv_iLength;
+  if(spec.fs_iPrecision >= 0 && spec.fs_iPrecision < iLen) {
+    iLen = spec.fs_iPrecision;
+  }
+  this->AppendFormatPadded(spec, strValue.sv_szBuffer, iLen, false);
+}
+
+bool String::ParseInt(int &iValue) const
+{
+  long long iParsed;
+  if(!strToInt(this->str_szBuffer, this->str_iLength, iParsed) || iParsed != (int)iParsed) {
+    return false;
+  }
+  iValue = (int)iParsed;
+  return true;
+}
+
+bool String::ParseInt(long long &iValue) const
+{
+  return strToInt(this->str_szBuffer, this->str_iLength, iValue);
+}
+
+bool String::ParseFloat(float &fValue) const
+{
+  return strToFloat(this->str_szBuffer, this->str_iLength, fValue);
+}
+
+bool String::ParseFloat(double &dValue) const
+{
+  return strToDouble(this->str_szBuffer, this->str_iLength, dValue);
+}
+
 void String::Split(const String &strNeedle, StackArray<String> &astrResult) const
 {
   Split(strNeedle, astrResult, FALSE);
@@ -268,291 +741,500 @@ void String::Split(const String &strNeedle, StackArray<String> &astrResult) cons
 
 void String::Split(const String &strNeedle, StackArray<String> &astrResult, BOOL bTrimAll) const
 {
-  MutexWait wait(str_mutex);
-  MutexWait wait2(strNeedle.str_mutex);
-
   // Keep a pointer to the current offset and a "previous offset"
   char* szOffset = str_szBuffer;
   char* szOffsetPrev = szOffset;
+  char* szEnd = str_szBuffer + str_iLength;
+  int iNeedleLen = strNeedle.str_iLength;
   int iCount = 1;
 
   do {
-    // Find the needle from the string in the current offset pointer
-    szOffset = strstr(szOffset, strNeedle);
+    // Find the needle from the string in the current offset pointer (an empty needle never matches)
+    szOffset = iNeedleLen > 0 ? (char*)strFind(szOffset, szEnd - szOffset, strNeedle.str_szBuffer, iNeedleLen) : NULL;
 
     // If the needle is found
     if(szOffset != NULL) {
       // Get the length for the string
       int iLen = szOffset - szOffsetPrev;
 
-      // And get a buffer started
-      char* szPart = new char[iLen + 1];
-
-      // Copy over the characters to the part buffer
-      int i = 0;
-      for(; i<iLen; i++) {
-        szPart[i] = *(szOffset - (iLen - i));
-      }
-      szPart[i] = '\0';
-
-      // Add it to the return array
-      astrResult.Push() = szPart;
-      delete[] szPart;
+      // Add it to the return array, copying the part straight from our buffer
+      astrResult.Push().AppendToBuffer(szOffsetPrev, iLen);
 
       // Keep a seperate count
       iCount++;
 
       // Increase the offset pointer by the needle length
-      szOffset += strlen(strNeedle);
+      szOffset += iNeedleLen;
 
       // Keep track of the pointer
       szOffsetPrev = szOffset;
     } else {
-      // Get the length for the string
-      int iLen = strlen(szOffsetPrev);
-
-      // And get a buffer started
-      char* szPart = new char[iLen + 1];
-
-      // Copy over the characters to the part buffer
-      int i = 0;
-      for(; i<iLen; i++) {
-        szPart[i] = szOffsetPrev[i];
-      }
-      szPart[i] = '\0';
-
-      // Add it to the return vector
+      // Add the remaining part to the return vector
       String &strAdd = astrResult.Push();
-      strAdd = szPart;
+      strAdd.AppendToBuffer(szOffsetPrev, szEnd - szOffsetPrev);
       if(bTrimAll) {
         strAdd = strAdd.Trim();
       }
-      delete[] szPart;
     }
   } while(szOffset != NULL);
 }
 
 void String::CommandLineSplit(StackArray<String> &astrResult) const
 {
-  MutexWait wait(str_mutex);
-
-  char* sz = str_szBuffer;
-  bool bInString = false;
-  String strBuffer;
-
-  do {
-    char c = *sz;
-    char cn = *(sz + 1);
-
-    if(c == '\\') {
-      strBuffer += *(++sz);
-      continue;
-    }
-
-    if(bInString) {
-      if(c == '"' && (cn == ' ' || cn == '\0')) {
-        bInString = false;
-        continue;
-      }
-    } else {
-      if(c == '"' && strBuffer.Length() == 0) {
-        bInString = true;
-        continue;
-      }
-      if(c == ' ' && strBuffer.Length() != 0) {
-        astrResult.Push() = strBuffer;
-        strBuffer = "";
-        continue;
-      }
-    }
-
-    strBuffer += c;
-  } while(*(++sz) != '\0');
-
-  if(strBuffer.Length() != 0) {
-    astrResult.Push() = strBuffer;
-  }
+  this->CommandLineSplit([&astrResult](const StringView &strArgument) {
+    astrResult.Push() = strArgument;
+  });
 }
 
 String String::InternalTrim(bool bLeft, bool bRight, char c) const
 {
-  // Copy ourselves into a new buffer
-  char* szBuffer = new char[strlen(this->str_szBuffer) + 1];
-  strcpy(szBuffer, this->str_szBuffer);
-
-  // Keep a pointer to the current offset
-  char* szOffset = szBuffer;
+  // Keep pointers to the start and end of the part we want to keep
+  const char* szStart = this->str_szBuffer;
+  const char* szEnd = szStart + this->str_iLength;
 
   if(bLeft) {
-    // While there's a space, keep incrementing the offset
-    while(*szOffset == c) {
+    // While there's a space, keep incrementing the start
+    while(szStart < szEnd && *szStart == c) {
       // This way, we'll trim all the spaces on the left
-      szOffset++;
+      szStart++;
     }
   }
 
   if(bRight) {
-    // Loop from right to left in the string
-    for(int i=strlen(szOffset)-1; i>=0; i--) {
-      // When we find something other than a space
-      if(szOffset[i] != c) {
-        // Put a null terminator to trim the right part
-        szOffset[i + 1] = '\0';
-
-        // Stop reading
-        break;
-      }
+    // Loop from right to left in the string until we find something other than a space
+    while(szEnd > szStart && *(szEnd - 1) == c) {
+      szEnd--;
     }
   }
 
   // Return
-  String ret(szOffset);
-  delete[] szBuffer;
-  return ret;
+  return String(szStart, 0, szEnd - szStart);
 }
 
 String String::Trim() const
 {
-  MutexWait wait(str_mutex);
   return InternalTrim(true, true);
 }
 
 String String::Trim(char c) const
 {
-  MutexWait wait(str_mutex);
   return InternalTrim(true, true, c);
 }
 
 String String::TrimLeft() const
 {
-  MutexWait wait(str_mutex);
   return InternalTrim(true, false);
 }
 
 String String::TrimLeft(char c) const
 {
-  MutexWait wait(str_mutex);
   return InternalTrim(true, false, c);
 }
 
 String String::TrimRight() const
 {
-  MutexWait wait(str_mutex);
   return InternalTrim(false, true);
 }
 
 String String::TrimRight(char c) const
 {
-  MutexWait wait(str_mutex);
   return InternalTrim(false, true, c);
 }
 
 String String::Replace(const String &strNeedle, const String &strReplace) const
 {
-  MutexWait wait(str_mutex);
-  MutexWait wait2(strNeedle.str_mutex);
-  MutexWait wait3(strReplace.str_mutex);
+  const char* szEnd = this->str_szBuffer + this->str_iLength;
+  int iNeedleLen = strNeedle.str_iLength;
+  int iReplaceLen = strReplace.str_iLength;
 
-  String strRet("");
+  // An empty needle never matches
+  if(iNeedleLen == 0) {
+    return *this;
+  }
 
-  // Keep a pointer to the current offset and a "previous offset"
-  char* szOffset = this->str_szBuffer;
-  char* szOffsetPrev = szOffset;
+  // Count the matches first so the result can be allocated exactly once
+  int ctMatches = 0;
+  for(const char* sz = this->str_szBuffer; (sz = strFind(sz, szEnd - sz, strNeedle.str_szBuffer, iNeedleLen)) != NULL; sz += iNeedleLen) {
+    ctMatches++;
+  }
+  if(ctMatches == 0) {
+    return *this;
+  }
 
-  do {
-    // Find the offset of the needle
-    szOffset = strstr(szOffset, strNeedle);
+  String strRet;
+  int iNewLen = this->str_iLength + ctMatches * (iReplaceLen - iNeedleLen);
+  if(iNewLen == 0) {
+    return strRet;
+  }
+  strRet.Reserve(iNewLen);
+
+  // Copy everything in between the matches and the replacements straight into the result
+  char* szDst = strRet.str_szBuffer;
+  const char* szOffsetPrev = this->str_szBuffer;
+  for(int iMatch=0; iMatch<ctMatches; iMatch++) {
+    const char* szOffset = strFind(szOffsetPrev, szEnd - szOffsetPrev, strNeedle.str_szBuffer, iNeedleLen);
+    memcpy(szDst, szOffsetPrev, szOffset - szOffsetPrev);
+    szDst += szOffset - szOffsetPrev;
+    memcpy(szDst, strReplace.str_szBuffer, iReplaceLen);
+    szDst += iReplaceLen;
+    szOffsetPrev = szOffset + iNeedleLen;
+  }
+  memcpy(szDst, szOffsetPrev, szEnd - szOffsetPrev);
 
-    // If it's found
-    if(szOffset != NULL) {
-      // Append everything before the needle of the original characters to the return value
-      strRet.AppendToBuffer(szOffsetPrev, szOffset - szOffsetPrev);
+  strRet.str_iLength = iNewLen;
+  strRet.str_szBuffer[iNewLen] = '\0';
+  return strRet;
+}
 
-      // Append the replace value
-      strRet += strReplace;
+// Aho-Corasick automaton used by ReplaceAll to look for all needles in a single pass.
+// Transitions are stored as a full table, but only for characters that actually appear
+// in the needles; all other characters share a single class that leads back to the root.
+// States are referred to by the offset of their row in the table, so a transition is a
+// single lookup, and each row ends with some extra columns describing the state.
+struct ReplaceAutomaton
+{
+  enum {
+    RA_DEPTH,  // length of the text matched when in this state
+    RA_NEEDLE, // index of the needle ending in this state, or -1
+    RA_MATCH,  // longest state on the suffix chain (including this one) that ends a needle, or -1
+    RA_FINAL,  // 1 if this state ends a needle that no other needle continues, 0 otherwise
+    RA_EXTRA_COLUMNS,
+  };
+
+  int ra_aiClass[256];
+  int ra_ctClasses;
+  int ra_ctColumns;
+  int* ra_aiTable;
+  int ra_iFirstChar; // the character all needles start with, or -1 if they start with different ones
+
+  ReplaceAutomaton(const StackArray<String> &astrNeedles)
+  {
+    INDEX ctNeedles = astrNeedles.Count();
+
+    // Give every character used in a needle its own class
+    memset(ra_aiClass, 0, sizeof(ra_aiClass));
+    ra_ctClasses = 1;
+    ra_iFirstChar = -1;
+    int ctMaxStates = 1;
+    for(INDEX i=0; i<ctNeedles; i++) {
+      const String &strNeedle = astrNeedles[i];
+      const char* szNeedle = strNeedle;
+      for(int j=0; j<strNeedle.Length(); j++) {
+        UBYTE ub = (UBYTE)szNeedle[j];
+        if(ra_aiClass[ub] == 0) {
+          ra_aiClass[ub] = ra_ctClasses++;
+        }
+      }
+      if(strNeedle.Length() > 0) {
+        UBYTE ubFirst = (UBYTE)szNeedle[0];
+        ra_iFirstChar = (ctMaxStates == 1 || ra_iFirstChar == ubFirst) ? ubFirst : -2;
+      }
+      ctMaxStates += strNeedle.Length();
+    }
+    if(ra_iFirstChar < 0) {
+      ra_iFirstChar = -1;
+    }
 
-      // Increase the offset pointer by the needle length
-      szOffset += strlen(strNeedle);
+    ra_ctColumns = ra_ctClasses + RA_EXTRA_COLUMNS;
+    ra_aiTable = new int[ctMaxStates * ra_ctColumns];
+    memset(ra_aiTable, 0xFF, sizeof(int) * ctMaxStates * ra_ctColumns);
+
+    // Build the trie, the first of any duplicate needles wins
+    int ctStates = 1;
+    ra_aiTable[ra_ctClasses + RA_DEPTH] = 0;
+    for(INDEX i=0; i<ctNeedles; i++) {
+      const String &strNeedle = astrNeedles[i];
+      const char* szNeedle = strNeedle;
+      if(strNeedle.Length() == 0) {
+        continue;
+      }
+      int iState = 0;
+      for(int j=0; j<strNeedle.Length(); j++) {
+        int &iNext = ra_aiTable[iState + ra_aiClass[(UBYTE)szNeedle[j]]];
+        if(iNext == -1) {
+          iNext = ctStates++ * ra_ctColumns;
+          ra_aiTable[iNext + ra_ctClasses + RA_DEPTH] = j + 1;
+        }
+        iState = iNext;
+      }
+      if(ra_aiTable[iState + ra_ctClasses + RA_NEEDLE] == -1) {
+        ra_aiTable[iState + ra_ctClasses + RA_NEEDLE] = i;
+      }
+    }
 
-      // Keep track of the pointer
-      szOffsetPrev = szOffset;
-    } else {
-      // Append the remaining part of the source string
-      strRet.AppendToBuffer(szOffsetPrev, strlen(szOffsetPrev));
+    // Walk the trie breadth first to fill in the failure transitions
+    int* aiFail = new int[ctStates];
+    int* aiQueue = new int[ctStates];
+    int iQueueHead = 0;
+    int iQueueTail = 0;
+    aiFail[0] = 0;
+    aiQueue[iQueueTail++] = 0;
+    while(iQueueHead < iQueueTail) {
+      int iState = aiQueue[iQueueHead++];
+      int iFailState = aiFail[iState / ra_ctColumns];
+      int* aiRow = ra_aiTable + iState;
+      int* aiFailRow = ra_aiTable + iFailState;
+
+      // Remember the longest needle ending here, which is either our own or the one of our failure state
+      aiRow[ra_ctClasses + RA_MATCH] = aiRow[ra_ctClasses + RA_NEEDLE] != -1 ? iState :
+        (iState == 0 ? -1 : aiFailRow[ra_ctClasses + RA_MATCH]);
+
+      BOOL bHasChildren = FALSE;
+      for(int c=0; c<ra_ctClasses; c++) {
+        if(aiRow[c] == -1) {
+          // No edge in the trie, go where the longest matching suffix would go
+          aiRow[c] = iState == 0 ? 0 : aiFailRow[c];
+          continue;
+        }
+        int iChild = aiRow[c];
+        aiFail[iChild / ra_ctColumns] = iState == 0 ? 0 : aiFailRow[c];
+        aiQueue[iQueueTail++] = iChild;
+        bHasChildren = TRUE;
+      }
+      aiRow[ra_ctClasses + RA_FINAL] = aiRow[ra_ctClasses + RA_NEEDLE] != -1 && !bHasChildren;
     }
-  } while(szOffset != NULL);
+    delete[] aiFail;
+    delete[] aiQueue;
+  }
+
+  ~ReplaceAutomaton()
+  {
+    delete[] ra_aiTable;
+  }
+
+  /// Call f(iStart, iLength, iNeedle) for every leftmost longest match, without overlaps
+  template<typename Func>
+  void Scan(const char* sz, int iLen, Func f) const
+  {
+    // Keep everything the loop needs in locals, so writes done by f don't force reloads
+    const int* aiTable = ra_aiTable;
+    const int* aiClass = ra_aiClass;
+    const int ctClasses = ra_ctClasses;
+    const int iFirstChar = ra_iFirstChar;
+
+    int iState = 0;
+    int iMatchStart = 0;
+    int iMatchLen = 0;
+    int iMatchNeedle = -1;
+
+    for(int i=0; ; i++) {
+      // From the root, skip straight to the next place a needle could start
+      if(iState == 0 && iFirstChar != -1 && i < iLen) {
+        const char* szFirst = strFindChar(sz + i, iLen - i, (char)iFirstChar);
+        i = szFirst != NULL ? szFirst - sz : iLen;
+      }
+
+      if(i < iLen) {
+        iState = aiTable[iState + aiClass[(UBYTE)sz[i]]];
+        const int* aiInfo = aiTable + iState + ctClasses;
+
+        // As long as a match starting at or before the pending one is possible, keep looking
+        if(iMatchNeedle == -1 || i + 1 - aiInfo[RA_DEPTH] <= iMatchStart) {
+          int iFound = aiInfo[RA_MATCH];
+          if(iFound != -1) {
+            const int* aiFoundInfo = aiTable + iFound + ctClasses;
+            int iStart = i + 1 - aiFoundInfo[RA_DEPTH];
+            if(iFound == iState && aiInfo[RA_FINAL]) {
+              // Nothing can start earlier or be longer than a needle that can't be continued, so
+              // this match can be reported right away
+              f(iStart, aiFoundInfo[RA_DEPTH], aiFoundInfo[RA_NEEDLE]);
+              iState = 0;
+              iMatchNeedle = -1;
+            } else if(iMatchNeedle == -1 || iStart <= iMatchStart) {
+              iMatchStart = iStart;
+              iMatchLen = aiFoundInfo[RA_DEPTH];
+              iMatchNeedle = aiFoundInfo[RA_NEEDLE];
+            }
+          }
+          continue;
+        }
+      } else if(iMatchNeedle == -1) {
+        break;
+      }
+
+      // The pending match can't be beaten anymore, report it and start over right after it
+      f(iMatchStart, iMatchLen, iMatchNeedle);
+      i = iMatchStart + iMatchLen - 1;
+      iState = 0;
+      iMatchNeedle = -1;
+    }
+  }
+};
+
+String String::ReplaceAll(const StackArray<String> &astrNeedles, const StackArray<String> &astrReplaces) const
+{
+  ASSERT(astrNeedles.Count() == astrReplaces.Count());
+
+  ReplaceAutomaton ra(astrNeedles);
+  const char* szSrc = this->str_szBuffer;
+
+  // Look the replacements up once instead of going through the array for every match
+  INDEX ctReplaces = astrReplaces.Count();
+  StringView* aReplaces = new StringView[ctReplaces > 0 ? ctReplaces : 1];
+  for(INDEX i=0; i<ctReplaces; i++) {
+    aReplaces[i] = astrReplaces[i].View();
+  }
+
+  // Scan once, remembering where the matches are and how long the result is going to be
+  int ctMatches = 0;
+  int ctMatchSlots = 64;
+  int* aiMatches = (int*)malloc(sizeof(int) * ctMatchSlots * 3);
+  if(aiMatches == NULL) {
+    delete[] aReplaces;
+    throw std::bad_alloc();
+  }
+  int iNewLen = this->str_iLength;
+  ra.Scan(szSrc, this->str_iLength, [&](int iStart, int iLen, int iNeedle) {
+    if(ctMatches == ctMatchSlots) {
+      // realloc can often grow large blocks in place, and leaves the old block alone when it fails
+      int* aiGrown = (int*)realloc(aiMatches, sizeof(int) * ctMatchSlots * 2 * 3);
+      if(aiGrown == NULL) {
+        free(aiMatches);
+        delete[] aReplaces;
+        throw std::bad_alloc();
+      }
+      aiMatches = aiGrown;
+      ctMatchSlots *= 2;
+    }
+    int* aiMatch = aiMatches + ctMatches++ * 3;
+    aiMatch[0] = iStart;
+    aiMatch[1] = iLen;
+    aiMatch[2] = iNeedle;
+    iNewLen += aReplaces[iNeedle].Length() - iLen;
+  });
+
+  String strRet;
+  if(ctMatches == 0) {
+    strRet = *this;
+  } else if(iNewLen > 0) {
+    // Allocate exactly once, then copy everything in between the matches and the replacements straight into it
+    strRet.Reserve(iNewLen);
+    char* szDst = strRet.str_szBuffer;
+    int iCopied = 0;
+    for(int iMatch=0; iMatch<ctMatches; iMatch++) {
+      const int* aiMatch = aiMatches + iMatch * 3;
+      const StringView &strReplace = aReplaces[aiMatch[2]];
+      memcpy(szDst, szSrc + iCopied, aiMatch[0] - iCopied);
+      szDst += aiMatch[0] - iCopied;
+      memcpy(szDst, strReplace.Data(), strReplace.Length());
+      szDst += strReplace.Length();
+      iCopied = aiMatch[0] + aiMatch[1];
+    }
+    memcpy(szDst, szSrc + iCopied, this->str_iLength - iCopied);
 
+    strRet.str_iLength = iNewLen;
+    strRet.str_szBuffer[iNewLen] = '\0';
+  }
+
+  free(aiMatches);
+  delete[] aReplaces;
   return strRet;
 }
 
 String String::SubString(int iStart) const
 {
-  MutexWait wait(str_mutex);
-  return String(this->str_szBuffer + iStart);
+  return String(this->str_szBuffer, iStart, this->str_iLength - iStart);
 }
 
 String String::SubString(int iStart, int iLen) const
 {
-  MutexWait wait(str_mutex);
-
   // Empty strings
   if(iStart < 0 || iLen <= 0) {
     return "";
   }
 
-  // Get the first offset
-  String strRet(this->str_szBuffer + iStart);
-
   // Check for stupid developers
-  if((ULONG)iLen > strlen(strRet)) {
-    return strRet;
+  int iAvailable = this->str_iLength - iStart;
+  if(iLen > iAvailable) {
+    iLen = iAvailable;
   }
 
-  // Then set the null terminator at the length the user wants
-  strRet[iLen] = '\0';
+  // Copy only the part the user wants
+  return String(this->str_szBuffer, iStart, iLen);
+}
 
-  // Return
-  return strRet;
+bool String::IsValidUtf8() const
+{
+  return strUtf8Validate(this->str_szBuffer, this->str_iLength) == this->str_iLength;
 }
 
-#if !WINDOWS
-void strlwr(char* sz)
+int String::Utf8Length() const
 {
-  int len = strlen(sz);
-  for(int i=0; i<len; i++) {
-    sz[i] = tolower(sz[i]);
-  }
+  return strUtf8Count(this->str_szBuffer, this->str_iLength);
 }
 
-void strupr(char* sz)
+String String::Utf8SubString(int iStart) const
 {
-  int len = strlen(sz);
-  for(int i=0; i<len; i++) {
-    sz[i] = toupper(sz[i]);
-  }
+  return String(this->View().Utf8SubString(iStart));
+}
+
+String String::Utf8SubString(int iStart, int iLen) const
+{
+  return String(this->View().Utf8SubString(iStart, iLen));
+}
+
+String String::Utf8Trim() const
+{
+  return String(this->View().Utf8Trim());
+}
+
+String String::Utf8TrimLeft() const
+{
+  return String(this->View().Utf8TrimLeft());
+}
+
+String String::Utf8TrimRight() const
+{
+  return String(this->View().Utf8TrimRight());
+}
+
+void String::AppendCodepoint(unsigned int iCodepoint)
+{
+  char acBuffer[STRINGUTF8_MAX_BYTES];
+  this->AppendToBuffer(acBuffer, strUtf8Encode(acBuffer, iCodepoint));
 }
-#endif
 
 String String::ToLower() const
 {
-  MutexWait wait(str_mutex);
-  String strRet(this->str_szBuffer);
-  strlwr(strRet.str_szBuffer);
+  // Fold straight into the new buffer instead of copying first
+  String strRet;
+  if(this->str_iLength > 0) {
+    strRet.Reserve(this->str_iLength);
+    strToLower(strRet.str_szBuffer, this->str_szBuffer, this->str_iLength);
+    strRet.str_szBuffer[this->str_iLength] = '\0';
+    strRet.str_iLength = this->str_iLength;
+  }
   return strRet;
 }
 
 String String::ToUpper() const
 {
-  MutexWait wait(str_mutex);
-  String strRet(this->str_szBuffer);
-  strupr(strRet.str_szBuffer);
+  // Fold straight into the new buffer instead of copying first
+  String strRet;
+  if(this->str_iLength > 0) {
+    strRet.Reserve(this->str_iLength);
+    strToUpper(strRet.str_szBuffer, this->str_szBuffer, this->str_iLength);
+    strRet.str_szBuffer[this->str_iLength] = '\0';
+    strRet.str_iLength = this->str_iLength;
+  }
   return strRet;
 }
 
+void String::ToLowerInPlace()
+{
+  this->UnshareBuffer();
+  strToLower(this->str_szBuffer, this->str_szBuffer, this->str_iLength);
+}
+
+void String::ToUpperInPlace()
+{
+  this->UnshareBuffer();
+  strToUpper(this->str_szBuffer, this->str_szBuffer, this->str_iLength);
+}
+
 int String::IndexOf(char c) const
 {
-  MutexWait wait(str_mutex);
-  const char* sz = strchr(this->str_szBuffer, c);
+  const char* sz = strFindChar(this->str_szBuffer, this->str_iLength, c);
   if(sz != NULL) {
     return sz - this->str_szBuffer;
   }
@@ -561,8 +1243,7 @@ int String::IndexOf(char c) const
 
 int String::IndexOf(const String &strNeedle) const
 {
-  MutexWait wait(str_mutex);
-  const char* sz = strstr(this->str_szBuffer, strNeedle);
+  const char* sz = strFind(this->str_szBuffer, this->str_iLength, strNeedle.str_szBuffer, strNeedle.str_iLength);
   if(sz != NULL) {
     return sz - this->str_szBuffer;
   }
@@ -571,42 +1252,16 @@ int String::IndexOf(const String &strNeedle) const
 
 int String::IndexOfLast(char c) const
 {
-  MutexWait wait(str_mutex);
-  const char* sz = strrchr(this->str_szBuffer, c);
+  const char* sz = strFindCharLast(this->str_szBuffer, this->str_iLength, c);
   if(sz != NULL) {
     return sz - this->str_szBuffer;
   }
   return -1;
 }
 
-// strrstr taken from: http://stuff.mit.edu/afs/sipb/user/cordelia/Diplomacy/mapit/strrstr.c
-static char* strrstr(const char* s1, const char* s2)
-{
-  const char *sc2, *psc1, *ps1;
-
-  if(*s2 == '\0') {
-    return (char*)s1;
-  }
-
-  ps1 = s1 + strlen(s1);
-
-  while(ps1 != s1) {
-    --ps1;
-    for(psc1 = ps1, sc2 = s2; ; ) {
-      if(*(psc1++) != *(sc2++)) {
-        break;
-      } else if(*sc2 == '\0') {
-        return (char*)ps1;
-      }
-    }
-  }
-  return NULL;
-}
-
 int String::IndexOfLast(const String &strNeedle) const
 {
-  MutexWait wait(str_mutex);
-  const char* sz = strrstr(this->str_szBuffer, strNeedle);
+  const char* sz = strFindLast(this->str_szBuffer, this->str_iLength, strNeedle.str_szBuffer, strNeedle.str_iLength);
   if(sz != NULL) {
     return sz - this->str_szBuffer;
   }
@@ -615,54 +1270,95 @@ int String::IndexOfLast(const String &strNeedle) const
 
 void String::Fill(char c, int ct)
 {
-  MutexWait wait(str_mutex);
-  char* szBuffer = new char[ct + 1];
-  memset(szBuffer, c, ct);
-  szBuffer[ct] = '\0';
-  CopyToBuffer(szBuffer);
+  if(ct <= 0) {
+    FreeBuffer();
+    return;
+  }
+
+  // The old contents are getting overwritten, so don't bother copying them over.
+  if(ct > this->str_iCapacity || this->IsSharedBuffer()) {
+    this->str_iLength = 0;
+    ReleaseBuffer(SwapBuffer(ct));
+  }
+
+  memset(this->str_szBuffer, c, ct);
+  this->str_szBuffer[ct] = '\0';
+  this->str_iLength = ct;
 }
 
 bool String::Contains(const String &strNeedle)
 {
-  MutexWait wait(str_mutex);
-  MutexWait wait2(strNeedle.str_mutex);
-  return strstr(this->str_szBuffer, strNeedle) != NULL;
+  return strFind(this->str_szBuffer, this->str_iLength, strNeedle.str_szBuffer, strNeedle.str_iLength) != NULL;
 }
 
 bool String::Contains(char c) const
 {
-  MutexWait wait(str_mutex);
-  int iLen = strlen(str_szBuffer);
-  for(int i=0; i<iLen; i++) {
-    if(str_szBuffer[i] == c) {
-      return true;
-    }
-  }
-  return false;
+  return strFindChar(str_szBuffer, str_iLength, c) != NULL;
 }
 
 bool String::StartsWith(const String &strNeedle)
 {
-  MutexWait wait(str_mutex);
-  MutexWait wait2(strNeedle.str_mutex);
-  return strstr(this->str_szBuffer, strNeedle) == this->str_szBuffer;
+  // Only compare the characters at the start
+  int iNeedleLen = strNeedle.str_iLength;
+  if(iNeedleLen > this->str_iLength) {
+    return false;
+  }
+  return !memcmp(this->str_szBuffer, strNeedle.str_szBuffer, iNeedleLen);
 }
 
 bool String::EndsWith(const String &strNeedle)
 {
-  MutexWait wait(str_mutex);
-  MutexWait wait2(strNeedle.str_mutex);
+  // Only compare the characters at the end
+  int iNeedleLen = strNeedle.str_iLength;
+  if(iNeedleLen > this->str_iLength) {
+    return false;
+  }
+  return !memcmp(this->str_szBuffer + this->str_iLength - iNeedleLen, strNeedle.str_szBuffer, iNeedleLen);
+}
+
+static inline UBYTE LowerChar(char c)
+{
+  return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+bool String::EqualsIgnoreCase(const StringView &strOther) const
+{
+  if(strOther.sv_iLength != this->str_iLength) {
+    return false;
+  }
+  return strMismatchIgnoreCase(this->str_szBuffer, strOther.sv_szBuffer, this->str_iLength) == this->str_iLength;
+}
 
-  // Get the offset
-  const char* szTemp = strstr(this->str_szBuffer, strNeedle);
+int String::CompareIgnoreCase(const StringView &strOther) const
+{
+  // Order by the first character that differs, or else by length
+  int iLen = Min(this->str_iLength, strOther.sv_iLength);
+  int i = strMismatchIgnoreCase(this->str_szBuffer, strOther.sv_szBuffer, iLen);
+  if(i < iLen) {
+    return LowerChar(this->str_szBuffer[i]) < LowerChar(strOther.sv_szBuffer[i]) ? -1 : 1;
+  }
+  if(this->str_iLength == strOther.sv_iLength) {
+    return 0;
+  }
+  return this->str_iLength < strOther.sv_iLength ? -1 : 1;
+}
 
-  // Make sure the needle is found
-  if(szTemp == NULL) {
+bool String::StartsWithIgnoreCase(const StringView &strNeedle) const
+{
+  if(strNeedle.sv_iLength > this->str_iLength) {
     return false;
   }
+  return strMismatchIgnoreCase(this->str_szBuffer, strNeedle.sv_szBuffer, strNeedle.sv_iLength) == strNeedle.sv_iLength;
+}
 
-  // Then compare the offset with our needle
-  return !strcmp(strNeedle, szTemp);
+unsigned long long String::Hash(unsigned long long ulSeed) const
+{
+  return hashBytes(this->str_szBuffer, this->str_iLength, ulSeed);
+}
+
+unsigned long long String::HashIgnoreCase(unsigned long long ulSeed) const
+{
+  return hashBytesIgnoreCase(this->str_szBuffer, this->str_iLength, ulSeed);
 }
 
 String::operator const char *()
@@ -677,7 +1373,6 @@ String::operator const char *() const
 
 String& String::operator=(char* src)
 {
-  MutexWait wait(str_mutex);
   // Copy the right hand side to the buffer.
   this->CopyToBuffer(src);
   return *this;
@@ -685,7 +1380,6 @@ String& String::operator=(char* src)
 
 String& String::operator=(const char* src)
 {
-  MutexWait wait(str_mutex);
   // Copy the right hand side to the buffer.
   this->CopyToBuffer(src);
   return *this;
@@ -693,27 +1387,60 @@ String& String::operator=(const char* src)
 
 String& String::operator=(const String &strSrc)
 {
-  MutexWait wait(str_mutex);
-  MutexWait wait2(strSrc.str_mutex);
+  // If the right hand side is not the left hand side...
+  if(this != &strSrc && this->str_szBuffer != strSrc.str_szBuffer) {
+    // Share the right hand side's buffer, or copy it if it's short enough to be inline.
+    if(strSrc.IsHeapBuffer()) {
+      this->FreeBuffer();
+      this->ShareBuffer(strSrc);
+    } else {
+      this->CopyToBuffer(strSrc.str_szBuffer, strSrc.str_iLength);
+    }
+  }
+  return *this;
+}
+
+String& String::operator=(String &&strSrc)
+{
   // If the right hand side is not the left hand side...
   if(this != &strSrc) {
-    // Copy the right hand side to the buffer.
-    this->CopyToBuffer(strSrc);
+    // Take over the right hand side's buffer.
+    this->FreeBuffer();
+    this->TakeBuffer(strSrc);
   }
   return *this;
 }
 
+String& String::operator=(const StringView &strSrc)
+{
+  // Copy the viewed characters to the buffer. The view might point into our own buffer, which is fine.
+  this->CopyToBuffer(strSrc.sv_szBuffer, strSrc.sv_iLength);
+  return *this;
+}
+
 String& String::operator+=(const char* szSrc)
 {
-  MutexWait wait(str_mutex);
   // Append the right hand side to the buffer.
   this->AppendToBuffer(szSrc);
   return *this;
 }
 
+String& String::operator+=(const String &strSrc)
+{
+  // Append the right hand side to the buffer.
+  this->AppendToBuffer(strSrc.str_szBuffer, strSrc.str_iLength);
+  return *this;
+}
+
+String& String::operator+=(const StringView &strSrc)
+{
+  // Append the viewed characters to the buffer.
+  this->AppendToBuffer(strSrc.sv_szBuffer, strSrc.sv_iLength);
+  return *this;
+}
+
 String& String::operator+=(const char cSrc)
 {
-  MutexWait wait(str_mutex);
   // Append the right hand side to the buffer.
   this->AppendToBuffer(cSrc);
   return *this;
@@ -721,60 +1448,153 @@ String& String::operator+=(const char cSrc)
 
 String& String::operator*=(int ctRepeat)
 {
-  String strOriginal = *this;
-  MutexWait wait(str_mutex);
+  // Make room for all the copies at once
+  int iLen = this->str_iLength;
+  if(ctRepeat > 1) {
+    GrowBuffer(iLen * ctRepeat);
+  }
+
+  // Appending a string to itself is fine, the buffer won't move anymore
   for(int i=1; i<ctRepeat; i++) {
-    this->AppendToBuffer(strOriginal);
+    this->AppendToBuffer(this->str_szBuffer, iLen);
   }
   return *this;
 }
 
 bool String::operator==(const char* szSrc) const
 {
-  MutexWait wait(str_mutex);
   return !strcmp(this->str_szBuffer, szSrc);
 }
 
 bool String::operator!=(const char* szSrc) const
 {
-  MutexWait wait(str_mutex);
   return strcmp(this->str_szBuffer, szSrc) != 0;
 }
 
+bool String::operator==(const String &strSrc) const
+{
+  return this->View() == strSrc.View();
+}
+
+bool String::operator!=(const String &strSrc) const
+{
+  return !(*this == strSrc);
+}
+
+bool String::operator==(const StringView &strSrc) const
+{
+  return this->View() == strSrc;
+}
+
+bool String::operator!=(const StringView &strSrc) const
+{
+  return !(*this == strSrc);
+}
+
+bool String::operator<(const String &strSrc) const
+{
+  // Order by the first byte that differs, or else by length
+  int iLen = Min(this->str_iLength, strSrc.str_iLength);
+  int iCompare = memcmp(this->str_szBuffer, strSrc.str_szBuffer, iLen);
+  if(iCompare != 0) {
+    return iCompare < 0;
+  }
+  return this->str_iLength < strSrc.str_iLength;
+}
+
 char& String::operator[](int iIndex)
 {
-  MutexWait wait(str_mutex);
+  // The caller might write through the reference, now or after the string has been copied
+  this->UnshareBuffer();
+  if(this->IsHeapBuffer()) {
+    HeapHeader(this->str_szBuffer)->shh_bUnshareable = true;
+  }
+  return this->str_szBuffer[iIndex];
+}
+
+char String::operator[](int iIndex) const
+{
   return this->str_szBuffer[iIndex];
 }
 
+String operator+(const String &strLHS, const String &strRHS)
+{
+  // Make room for both sides at once
+  String strRet;
+  strRet.Reserve(strLHS.Length() + strRHS.Length());
+  strRet += strLHS;
+  strRet += strRHS;
+  return strRet;
+}
+
 String operator+(const String &strLHS, const char* szRHS)
 {
-  return String(strLHS) += szRHS;
+  // Make room for both sides at once
+  String strRet;
+  strRet.Reserve(strLHS.Length() + strlen(szRHS));
+  strRet += strLHS;
+  strRet += szRHS;
+  return strRet;
 }
 
 String operator+(const String &strLHS, const char cRHS)
 {
-  return String(strLHS) += cRHS;
+  String strRet;
+  strRet.Reserve(strLHS.Length() + 1);
+  strRet += strLHS;
+  strRet += cRHS;
+  return strRet;
+}
+
+String operator+(String &&strLHS, const String &strRHS)
+{
+  // The left hand side is a temporary, so we can append to it directly
+  strLHS += strRHS;
+  return std::move(strLHS);
+}
+
+String operator+(String &&strLHS, const char* szRHS)
+{
+  strLHS += szRHS;
+  return std::move(strLHS);
 }
 
-String operator+(const char* szLHS, String &strRHS)
+String operator+(String &&strLHS, const char cRHS)
 {
-  return String(szLHS) += strRHS;
+  strLHS += cRHS;
+  return std::move(strLHS);
 }
 
-String operator+(const char cLHS, String &strRHS)
+String operator+(const char* szLHS, const String &strRHS)
 {
-  return String(strRHS) += cLHS;
+  String strRet;
+  strRet.Reserve(strlen(szLHS) + strRHS.Length());
+  strRet += szLHS;
+  strRet += strRHS;
+  return strRet;
+}
+
+String operator+(const char cLHS, const String &strRHS)
+{
+  String strRet;
+  strRet.Reserve(1 + strRHS.Length());
+  strRet += cLHS;
+  strRet += strRHS;
+  return strRet;
 }
 
 String operator*(const String &strLHS, int ctRepeat)
 {
-  return String(strLHS) *= ctRepeat;
+  String strRet(strLHS);
+  strRet *= ctRepeat;
+  return strRet;
 }
 
 String operator*(int ctRepeat, const String &strRHS)
 {
-  return String(strRHS) *= ctRepeat;
+  String strRet(strRHS);
+  strRet *= ctRepeat;
+  return strRet;
 }
 
 String strPrintF(const char* szFormat, ...)
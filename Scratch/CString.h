@@ -28,44 +28,202 @@
 #define SCRATCH_CSTRING_H_INCLUDED
 
 #include "CStackArray.h"
-#include "CMutex.h"
+#include "CSmallArray.h"
+#include "CStringView.h"
+#include "StringFormat.h"
+
+#include <atomic>
 
 #ifndef CSTRING_FORMAT_BUFFER_SIZE
 #define CSTRING_FORMAT_BUFFER_SIZE 1024
 #endif
 
+// Strings shorter than this (including the null terminator) are stored inside
+// the String object itself and never touch the heap.
+#ifndef CSTRING_INLINE_BUFFER_SIZE
+#define CSTRING_INLINE_BUFFER_SIZE 24
+#endif
+
 SCRATCH_NAMESPACE_BEGIN;
 
 class SCRATCH_EXPORT String
 {
 	friend class Filename;
+	friend class StringBuilder;
 protected:
   char* str_szBuffer;
-  Mutex str_mutex;
+  int str_iLength;
+  int str_iCapacity;
+  char str_acInline[CSTRING_INLINE_BUFFER_SIZE];
+
+  inline bool IsHeapBuffer() const { return str_szBuffer != String::str_szEmpty && str_szBuffer != str_acInline; }
+  bool IsSharedBuffer() const;
+  static void ReleaseBuffer(char* szHeap);
+  void UnshareBuffer();
+  void ShareBuffer(const String &strSrc);
+  void FreeBuffer();
+  char* SwapBuffer(int iCapacity);
+  void GrowBuffer(int iCapacity);
 
   void CopyToBuffer(const char* szSrc);
+  void CopyToBuffer(const char* szSrc, int iLen);
+  void TakeBuffer(String &strSrc);
   void AppendToBuffer(const char* szSrc);
   void AppendToBuffer(const char* szSrc, int iCount);
   void AppendToBuffer(const char cSrc);
 
+  void AppendFormatPadded(const FormatSpec &spec, const char* szValue, int iLen, bool bNumber);
+  void AppendFormatValue(const FormatSpec &spec, long long iValue);
+  void AppendFormatValue(const FormatSpec &spec, unsigned long long ulValue);
+  void AppendFormatValue(const FormatSpec &spec, float fValue);
+  void AppendFormatValue(const FormatSpec &spec, double dValue);
+  void AppendFormatValue(const FormatSpec &spec, char cValue);
+  void AppendFormatValue(const FormatSpec &spec, const StringView &strValue);
+  void AppendFormatArgs(const char* szFormat);
+
+  template<typename T, typename... Rest>
+  void AppendFormatArgs(const char* szFormat, const T &arg, const Rest &... rest)
+  {
+    typedef typename std::decay<T>::type Decayed;
+    static_assert(FormatArg<Decayed>::Kind != EFAK_UNSUPPORTED, "Type of format argument is not supported");
+
+    // Copy the text up to the next placeholder, then write the argument straight into our buffer
+    FormatSpec spec;
+    szFormat = this->AppendFormatLiteral(szFormat, spec);
+    if(szFormat == NULL) {
+      return;
+    }
+    spec.fs_iArgSize = sizeof(Decayed);
+    this->AppendFormatValue(spec, (typename FormatArg<Decayed>::Type)arg);
+    this->AppendFormatArgs(szFormat, rest...);
+  }
+  const char* AppendFormatLiteral(const char* szFormat, FormatSpec &spec);
+
+  static inline int FormatSizeHint() { return 0; }
+  template<typename T, typename... Rest>
+  static inline int FormatSizeHint(const T &arg, const Rest &... rest)
+  {
+    return strFormatSizeHint((typename FormatArg<typename std::decay<T>::type>::Type)arg) + FormatSizeHint(rest...);
+  }
+
+  static inline bool FormatPointsInto(const char*, const char*) { return false; }
+  template<typename T, typename... Rest>
+  static inline bool FormatPointsInto(const char* szBegin, const char* szEnd, const T &arg, const Rest &... rest)
+  {
+    return strFormatPointsInto(szBegin, szEnd, (typename FormatArg<typename std::decay<T>::type>::Type)arg) || FormatPointsInto(szBegin, szEnd, rest...);
+  }
+
 public:
   static char* str_szEmpty;
-  static int str_iInstances;
+  static std::atomic<int> str_iInstances; // atomic, since strings are made and destroyed on any thread
 
 	String();
 	String(const char* szValue);
 	String(const char* szValue, int iStart, int iLength);
 	String(const String &strCopy);
+	String(String &&strMove);
+	explicit String(const StringView &strView);
 	virtual ~String();
 
+  /// Return the amount of characters in the string
   int Length() const;
+  /// Return the amount of characters the string can hold without reallocating
+  int Capacity() const;
+  /// Make sure the string can hold at least the given amount of characters without reallocating
+  void Reserve(int ctChars);
+  /// Give back any memory the string currently doesn't need
+  void ShrinkToFit();
+  /// Make the string empty, but keep its memory around for reuse
+  void Clear();
+
+  /// Return a view on the whole string, which stays valid until the string is modified
+  StringView View() const;
+  /// Return a view on part of the string, which stays valid until the string is modified
+  StringView View(int iStart, int iLen) const;
 
   void SetF(const char* szFormat, ...);
   void AppendF(const char* szFormat, ...);
 
+  /// Append an integer in decimal
+  void AppendInt(long long iValue);
+  /// Append an unsigned integer in decimal
+  void AppendUInt(unsigned long long ulValue);
+  /// Append a float in the shortest form that reads back as exactly the same value
+  void AppendFloat(float fValue);
+  /// Append a double in the shortest form that reads back as exactly the same value
+  void AppendDouble(double dValue);
+  /// Append an unsigned integer in lowercase hexadecimal, without a prefix
+  void AppendHex(unsigned long long ulValue);
+
+  /// Parse the whole string as a decimal integer, returns false if it isn't one or if it doesn't fit
+  bool ParseInt(int &iValue) const;
+  bool ParseInt(long long &iValue) const;
+  /// Parse the whole string as a decimal number, returns false if it isn't one or if it doesn't fit
+  bool ParseFloat(float &fValue) const;
+  bool ParseFloat(double &dValue) const;
+
+  /// Replace the contents with the formatted arguments, see StringFormat.h for the placeholders.
+  /// The format string is only parsed at runtime: a mismatched placeholder writes the argument as its own type,
+  /// extra arguments are dropped and so are placeholders without one. Use SCRATCH_FORMAT to check it at compile time.
+  template<typename... Args>
+  void Format(const char* szFormat, const Args &... args)
+  {
+    // Format into a new string, so the arguments may point into this one
+    String strResult;
+    strResult.AppendFormat(szFormat, args...);
+    *this = std::move(strResult);
+  }
+
+  /// Append the formatted arguments, reserving room for all of them up front. Like Format this isn't checked
+  /// at compile time, use SCRATCH_APPEND_FORMAT for that.
+  template<typename... Args>
+  void AppendFormat(const char* szFormat, const Args &... args)
+  {
+    // Arguments that point into this string are formatted separately, so they all see it as it was
+    if(this->str_iLength > 0 && FormatPointsInto(this->str_szBuffer, this->str_szBuffer + this->str_iLength, args...)) {
+      String strAppend;
+      strAppend.AppendFormat(szFormat, args...);
+      this->AppendToBuffer(strAppend.str_szBuffer, strAppend.str_iLength);
+      return;
+    }
+
+    this->Reserve(this->str_iLength + strlen(szFormat) + FormatSizeHint(args...));
+    this->AppendFormatArgs(szFormat, args...);
+  }
+
 	void Split(const String &strNeedle, StackArray<String> &astrResult) const;
 	void Split(const String &strNeedle, StackArray<String> &astrResult, BOOL bTrimAll) const;
+  /// Split into an array that keeps its first parts inline, so splitting into a few parts doesn't allocate slots
+  template<INDEX ctInline>
+  void Split(const String &strNeedle, SmallArray<String, ctInline> &astrResult, BOOL bTrimAll = FALSE) const
+  {
+    // Same parts as the StackArray version, copied straight from our buffer
+    StringView strRemaining = this->View();
+    StringView strPart;
+    while(strRemaining.SplitNext(strNeedle.View(), strPart)) {
+      String &strAdd = astrResult.Push();
+      strAdd.AppendToBuffer(strPart.sv_szBuffer, strPart.sv_iLength);
+      if(bTrimAll && strRemaining.sv_szBuffer == NULL) {
+        strAdd = strAdd.Trim();
+      }
+    }
+  }
 	void CommandLineSplit(StackArray<String> &astrResult) const;
+  /// Split like a shell would, calling the given function with a view on each argument
+  template<typename Func>
+  INDEX CommandLineSplit(Func f) const
+  {
+    // Arguments without escapes are viewed in place, the others share a single buffer
+    StringView strRemaining = this->View();
+    StringView strArgument;
+    String strBuffer;
+    INDEX ctArguments = 0;
+    while(strRemaining.CommandLineSplitNext(strArgument, strBuffer)) {
+      f(strArgument);
+      ctArguments++;
+    }
+    return ctArguments;
+  }
 private:
 	String InternalTrim(bool bLeft, bool bRight, char c = ' ') const;
 public:
@@ -76,10 +234,29 @@ public:
 	String TrimRight() const;
 	String TrimRight(char c) const;
 	String Replace(const String &strNeedle, const String &strReplace) const;
+  /// Replace every needle with the replacement at the same index, in a single pass over the string
+  String ReplaceAll(const StackArray<String> &astrNeedles, const StackArray<String> &astrReplaces) const;
 	String SubString(int iStart) const;
 	String SubString(int iStart, int iLen) const;
+  /// Return whether the string is valid UTF-8
+  bool IsValidUtf8() const;
+  /// Return the amount of codepoints, assuming the string is valid UTF-8
+  int Utf8Length() const;
+  /// Copy the part starting at the given codepoint, never splitting a multibyte character
+  String Utf8SubString(int iStart) const;
+  String Utf8SubString(int iStart, int iLen) const;
+  /// Trim all Unicode whitespace, like no-break and ideographic spaces, not just ASCII spaces
+  String Utf8Trim() const;
+  String Utf8TrimLeft() const;
+  String Utf8TrimRight() const;
+  /// Append a codepoint encoded as UTF-8
+  void AppendCodepoint(unsigned int iCodepoint);
 	String ToLower() const;
 	String ToUpper() const;
+  /// Turn A-Z into a-z without making a new string
+  void ToLowerInPlace();
+  /// Turn a-z into A-Z without making a new string
+  void ToUpperInPlace();
 
   int IndexOf(char c) const;
 	int IndexOf(const String &strNeedle) const;
@@ -94,35 +271,78 @@ public:
 	bool StartsWith(const String &strNeedle);
 	bool EndsWith(const String &strNeedle);
 
+  /// Compare with another string, treating A-Z and a-z as the same
+  bool EqualsIgnoreCase(const StringView &strOther) const;
+  /// Order against another string like strcasecmp, returning -1, 0 or 1
+  int CompareIgnoreCase(const StringView &strOther) const;
+  bool StartsWithIgnoreCase(const StringView &strNeedle) const;
+  /// Return a hash of the characters, the same as hashBytes gives
+  unsigned long long Hash(unsigned long long ulSeed = 0) const;
+  /// Return a hash that is the same for strings that only differ in the case of A-Z
+  unsigned long long HashIgnoreCase(unsigned long long ulSeed = 0) const;
+
   operator const char*();
   operator const char*() const;
 
 	String& operator=(char* szSrc);
 	String& operator=(const char* szSrc);
 	String& operator=(const String &strSrc);
+	String& operator=(String &&strSrc);
+	String& operator=(const StringView &strSrc);
 
 	String& operator+=(const char* szSrc);
+	String& operator+=(const String &strSrc);
+	String& operator+=(const StringView &strSrc);
 	String& operator+=(const char cSrc);
 
 	String& operator*=(int ctRepeat);
 
   bool operator==(const char* szSrc) const;
+  bool operator==(const String &strSrc) const;
+  bool operator==(const StringView &strSrc) const;
   bool operator!=(const char* szSrc) const;
+  bool operator!=(const String &strSrc) const;
+  bool operator!=(const StringView &strSrc) const;
+  /// Order by bytes like strcmp, so strings can be sorted and binary searched
+  bool operator<(const String &strSrc) const;
 
+  /// Note: The buffer is never shared with copies after this, since the reference could be written through
   char& operator[](int iIndex);
+  char operator[](int iIndex) const;
 };
 
+String SCRATCH_EXPORT operator+(const String &strLHS, const String &strRHS);
 String SCRATCH_EXPORT operator+(const String &strLHS, const char* szRHS);
 String SCRATCH_EXPORT operator+(const String &strLHS, const char cRHS);
 
-String SCRATCH_EXPORT operator+(const char* szLHS, String &strRHS);
-String SCRATCH_EXPORT operator+(const char cLHS, String &strRHS);
+String SCRATCH_EXPORT operator+(String &&strLHS, const String &strRHS);
+String SCRATCH_EXPORT operator+(String &&strLHS, const char* szRHS);
+String SCRATCH_EXPORT operator+(String &&strLHS, const char cRHS);
+
+String SCRATCH_EXPORT operator+(const char* szLHS, const String &strRHS);
+String SCRATCH_EXPORT operator+(const char cLHS, const String &strRHS);
 
 String SCRATCH_EXPORT operator*(const String &strLHS, int ctRepeat);
 String SCRATCH_EXPORT operator*(int ctRepeat, const String &strRHS);
 
 String SCRATCH_EXPORT strPrintF(const char* szFormat, ...);
 
+template<>
+struct Hasher<String>
+{
+  static inline unsigned long long Hash(const String &str, unsigned long long ulSeed = 0) { return str.Hash(ulSeed); }
+};
+
+/// Format the arguments into a new string, see StringFormat.h for the placeholders. Only checked at runtime
+/// like String::Format, SCRATCH_FORMAT wraps this with the compile time check.
+template<typename... Args>
+String strFormat(const char* szFormat, const Args &... args)
+{
+  String strResult;
+  strResult.AppendFormat(szFormat, args...);
+  return strResult;
+}
+
 SCRATCH_NAMESPACE_END;
 
 #endif // include once check
@@ -0,0 +1,193 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "CStringBuilder.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+StringBuilder::StringBuilder()
+{
+  sb_pFirst = NULL;
+  sb_pLast = NULL;
+  sb_pWrite = NULL;
+  sb_pWriteEnd = NULL;
+  sb_iLength = 0;
+}
+
+StringBuilder::StringBuilder(StringBuilder &&move)
+{
+  // Take over the other builder's chunks
+  sb_pFirst = move.sb_pFirst;
+  sb_pLast = move.sb_pLast;
+  sb_pWrite = move.sb_pWrite;
+  sb_pWriteEnd = move.sb_pWriteEnd;
+  sb_iLength = move.sb_iLength;
+
+  // Leave the other builder empty
+  move.sb_pFirst = NULL;
+  move.sb_pLast = NULL;
+  move.sb_pWrite = NULL;
+  move.sb_pWriteEnd = NULL;
+  move.sb_iLength = 0;
+}
+
+StringBuilder::~StringBuilder()
+{
+  Clear();
+}
+
+StringBuilder& StringBuilder::operator=(StringBuilder &&move)
+{
+  if(this == &move) {
+    return *this;
+  }
+
+  Clear();
+
+  sb_pFirst = move.sb_pFirst;
+  sb_pLast = move.sb_pLast;
+  sb_pWrite = move.sb_pWrite;
+  sb_pWriteEnd = move.sb_pWriteEnd;
+  sb_iLength = move.sb_iLength;
+
+  move.sb_pFirst = NULL;
+  move.sb_pLast = NULL;
+  move.sb_pWrite = NULL;
+  move.sb_pWriteEnd = NULL;
+  move.sb_iLength = 0;
+
+  return *this;
+}
+
+char* StringBuilder::AddChunk(int ctChars)
+{
+  // Remember how much of the current chunk got used
+  if(sb_pLast != NULL) {
+    sb_pLast->ch_iUsed = sb_pWrite - sb_pLast->ch_acData;
+  }
+
+  // Grow along with the builder so the amount of chunks stays small, but make sure the fragment fits
+  int iCapacity = Min(Max(sb_iLength, CSTRINGBUILDER_FIRST_CHUNK_SIZE), CSTRINGBUILDER_MAX_CHUNK_SIZE);
+  iCapacity = Max(iCapacity, ctChars);
+
+  Chunk* pChunk = (Chunk*)new char[sizeof(Chunk) + iCapacity];
+  pChunk->ch_pNext = NULL;
+  pChunk->ch_iUsed = 0;
+  pChunk->ch_iCapacity = iCapacity;
+
+  if(sb_pLast == NULL) {
+    sb_pFirst = pChunk;
+  } else {
+    sb_pLast->ch_pNext = pChunk;
+  }
+  sb_pLast = pChunk;
+
+  sb_pWriteEnd = pChunk->ch_acData + iCapacity;
+  return pChunk->ch_acData;
+}
+
+int StringBuilder::Length() const
+{
+  return sb_iLength;
+}
+
+void StringBuilder::Clear()
+{
+  Chunk* pChunk = sb_pFirst;
+  while(pChunk != NULL) {
+    Chunk* pNext = pChunk->ch_pNext;
+    delete[] (char*)pChunk;
+    pChunk = pNext;
+  }
+
+  sb_pFirst = NULL;
+  sb_pLast = NULL;
+  sb_pWrite = NULL;
+  sb_pWriteEnd = NULL;
+  sb_iLength = 0;
+}
+
+StringBuilder& StringBuilder::Append(const char* szSrc)
+{
+  if(szSrc == NULL) {
+    return *this;
+  }
+  return Append(szSrc, strlen(szSrc));
+}
+
+StringBuilder& StringBuilder::Append(const String &strSrc)
+{
+  return Append(strSrc.str_szBuffer, strSrc.str_iLength);
+}
+
+StringBuilder& StringBuilder::Append(const StringView &strSrc)
+{
+  return Append(strSrc.sv_szBuffer, strSrc.sv_iLength);
+}
+
+StringBuilder& StringBuilder::operator+=(const char* szSrc)
+{
+  return Append(szSrc);
+}
+
+StringBuilder& StringBuilder::operator+=(const String &strSrc)
+{
+  return Append(strSrc);
+}
+
+StringBuilder& StringBuilder::operator+=(const StringView &strSrc)
+{
+  return Append(strSrc);
+}
+
+StringBuilder& StringBuilder::operator+=(char cSrc)
+{
+  return Append(cSrc);
+}
+
+String StringBuilder::ToString() const
+{
+  String strRet;
+  if(sb_iLength == 0) {
+    return strRet;
+  }
+
+  // Allocate once and copy all chunks into it
+  strRet.Reserve(sb_iLength);
+  char* szDst = strRet.str_szBuffer;
+  for(Chunk* pChunk = sb_pFirst; pChunk != NULL; pChunk = pChunk->ch_pNext) {
+    // The last chunk is still being written to, so its used count isn't up to date
+    int iUsed = pChunk == sb_pLast ? sb_pWrite - pChunk->ch_acData : pChunk->ch_iUsed;
+    memcpy(szDst, pChunk->ch_acData, iUsed);
+    szDst += iUsed;
+  }
+
+  strRet.str_iLength = sb_iLength;
+  strRet.str_szBuffer[sb_iLength] = '\0';
+  return strRet;
+}
+
+SCRATCH_NAMESPACE_END;
@@ -0,0 +1,125 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CSTRINGBUILDER_H_INCLUDED
+#define SCRATCH_CSTRINGBUILDER_H_INCLUDED
+
+#include <cstring> // for memcpy
+
+#include "CString.h"
+
+// Size of the first chunk a builder allocates, later chunks grow along with the builder.
+#ifndef CSTRINGBUILDER_FIRST_CHUNK_SIZE
+#define CSTRINGBUILDER_FIRST_CHUNK_SIZE 256
+#endif
+
+// Chunks don't grow beyond this, unless a single fragment needs more room.
+#ifndef CSTRINGBUILDER_MAX_CHUNK_SIZE
+#define CSTRINGBUILDER_MAX_CHUNK_SIZE (1024 * 1024)
+#endif
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/// Collects string fragments in a list of chunks and only builds the resulting String once,
+/// when it's asked for. Characters that were added are never moved or copied again until then.
+class SCRATCH_EXPORT StringBuilder
+{
+private:
+  struct Chunk
+  {
+    Chunk* ch_pNext;
+    int ch_iUsed;
+    int ch_iCapacity;
+    char ch_acData[1];
+  };
+
+  Chunk* sb_pFirst;
+  Chunk* sb_pLast;
+  char* sb_pWrite;
+  char* sb_pWriteEnd;
+  int sb_iLength;
+
+  char* AddChunk(int ctChars);
+
+  StringBuilder(const StringBuilder &copy); // Note: Not implemented, build a String instead.
+  StringBuilder& operator=(const StringBuilder &copy);
+
+public:
+  StringBuilder();
+  StringBuilder(StringBuilder &&move);
+  ~StringBuilder();
+
+  /// Take over the fragments of another builder, clearing this one first
+  StringBuilder& operator=(StringBuilder &&move);
+
+  /// Return the amount of characters added so far
+  int Length() const;
+  /// Remove everything and give back the memory
+  void Clear();
+
+  /// Add characters to the end
+  inline StringBuilder& Append(const char* szSrc, int iLen)
+  {
+    if(iLen <= 0) {
+      return *this;
+    }
+    if(sb_pWriteEnd - sb_pWrite < iLen) {
+      sb_pWrite = AddChunk(iLen);
+    }
+    memcpy(sb_pWrite, szSrc, iLen);
+    sb_pWrite += iLen;
+    sb_iLength += iLen;
+    return *this;
+  }
+  /// Add a null terminated string to the end
+  StringBuilder& Append(const char* szSrc);
+  /// Add a string to the end
+  StringBuilder& Append(const String &strSrc);
+  /// Add a view to the end
+  StringBuilder& Append(const StringView &strSrc);
+  /// Add a single character to the end
+  inline StringBuilder& Append(char cSrc)
+  {
+    if(sb_pWrite == sb_pWriteEnd) {
+      sb_pWrite = AddChunk(1);
+    }
+    *sb_pWrite++ = cSrc;
+    sb_iLength++;
+    return *this;
+  }
+
+  StringBuilder& operator+=(const char* szSrc);
+  StringBuilder& operator+=(const String &strSrc);
+  StringBuilder& operator+=(const StringView &strSrc);
+  StringBuilder& operator+=(char cSrc);
+
+  /// Build a String out of everything that was added, with a single allocation
+  String ToString() const;
+};
+
+SCRATCH_NAMESPACE_END;
+
+#endif // include once check
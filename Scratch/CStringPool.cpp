@@ -0,0 +1,269 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring> // for memcmp
+#include <cstddef> // for offsetof
+
+#include "CStringPool.h"
+#include "Hash.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+// Every pool hands out the same entry for the empty string, hashed the same way as all other entries
+static const StringPoolEntry _speEmpty = { (unsigned int)hashBytes("", 0), 0, { '\0' } };
+
+InternedString::InternedString()
+{
+  is_pEntry = &_speEmpty;
+}
+
+InternedString::InternedString(const StringPoolEntry* pEntry)
+{
+  is_pEntry = pEntry;
+}
+
+InternedString::InternedString(const char* szValue)
+{
+  is_pEntry = StringPool::Global().Intern(szValue).is_pEntry;
+}
+
+InternedString::InternedString(const String &strValue)
+{
+  is_pEntry = StringPool::Global().Intern(strValue).is_pEntry;
+}
+
+InternedString::InternedString(const StringView &strValue)
+{
+  is_pEntry = StringPool::Global().Intern(strValue).is_pEntry;
+}
+
+bool InternedString::operator==(const char* szValue) const
+{
+  return View() == StringView(szValue);
+}
+
+bool InternedString::operator!=(const char* szValue) const
+{
+  return !(View() == StringView(szValue));
+}
+
+StringPool::StringPool()
+{
+  for(int i=0; i<CSTRINGPOOL_SHARDS; i++) {
+    Shard &shard = sp_aShards[i];
+    shard.sh_apSlots = NULL;
+    shard.sh_ctSlots = 0;
+    shard.sh_ctEntries = 0;
+    shard.sh_pBlocks = NULL;
+    shard.sh_pWrite = NULL;
+    shard.sh_pWriteEnd = NULL;
+    shard.sh_iMemory = 0;
+  }
+}
+
+StringPool::~StringPool()
+{
+  for(int i=0; i<CSTRINGPOOL_SHARDS; i++) {
+    Shard &shard = sp_aShards[i];
+    delete[] shard.sh_apSlots;
+
+    // Every block starts with a pointer to the next one
+    char* pBlock = shard.sh_pBlocks;
+    while(pBlock != NULL) {
+      char* pNext = *(char**)pBlock;
+      delete[] pBlock;
+      pBlock = pNext;
+    }
+  }
+}
+
+StringPool::Shard& StringPool::ShardFor(unsigned int ulHash)
+{
+  // The top bits pick the shard, the bottom bits the slot within it
+  return sp_aShards[(ulHash >> 24) & (CSTRINGPOOL_SHARDS - 1)];
+}
+
+const StringPoolEntry* StringPool::FindEntry(Shard &shard, const char* sz, int iLen, unsigned int ulHash)
+{
+  if(shard.sh_ctSlots == 0) {
+    return NULL;
+  }
+
+  int iSlot = ulHash & (shard.sh_ctSlots - 1);
+  const StringPoolEntry* pEntry;
+  while((pEntry = shard.sh_apSlots[iSlot]) != NULL) {
+    if(pEntry->spe_ulHash == ulHash && pEntry->spe_iLength == iLen && memcmp(pEntry->spe_acData, sz, iLen) == 0) {
+      return pEntry;
+    }
+    iSlot = (iSlot + 1) & (shard.sh_ctSlots - 1);
+  }
+  return NULL;
+}
+
+const StringPoolEntry* StringPool::AddEntry(Shard &shard, const char* sz, int iLen, unsigned int ulHash)
+{
+  // Keep the table at most half full so probe sequences stay short
+  if((shard.sh_ctEntries + 1) * 2 > shard.sh_ctSlots) {
+    int ctSlots = Max(16, shard.sh_ctSlots * 2);
+    const StringPoolEntry** apSlots = new const StringPoolEntry*[ctSlots];
+    memset(apSlots, 0, ctSlots * sizeof(StringPoolEntry*));
+    for(int i=0; i<shard.sh_ctSlots; i++) {
+      const StringPoolEntry* pEntry = shard.sh_apSlots[i];
+      if(pEntry != NULL) {
+        int iSlot = pEntry->spe_ulHash & (ctSlots - 1);
+        while(apSlots[iSlot] != NULL) {
+          iSlot = (iSlot + 1) & (ctSlots - 1);
+        }
+        apSlots[iSlot] = pEntry;
+      }
+    }
+    delete[] shard.sh_apSlots;
+    shard.sh_iMemory += (ctSlots - shard.sh_ctSlots) * sizeof(StringPoolEntry*);
+    shard.sh_apSlots = apSlots;
+    shard.sh_ctSlots = ctSlots;
+  }
+
+  // Entries are packed into blocks, aligned for the next entry
+  int iSize = offsetof(StringPoolEntry, spe_acData) + iLen + 1;
+  iSize = (iSize + sizeof(int) - 1) & ~(int)(sizeof(int) - 1);
+
+  char* pEntryMemory;
+  if(iSize > CSTRINGPOOL_BLOCK_SIZE / 4) {
+    // Big strings get a block of their own, leaving the current block to fill up further
+    char* pBlock = new char[sizeof(char*) + iSize];
+    *(char**)pBlock = shard.sh_pBlocks;
+    shard.sh_pBlocks = pBlock;
+    shard.sh_iMemory += sizeof(char*) + iSize;
+    pEntryMemory = pBlock + sizeof(char*);
+  } else {
+    if(shard.sh_pWriteEnd - shard.sh_pWrite < iSize) {
+      char* pBlock = new char[CSTRINGPOOL_BLOCK_SIZE];
+      *(char**)pBlock = shard.sh_pBlocks;
+      shard.sh_pBlocks = pBlock;
+      shard.sh_pWrite = pBlock + sizeof(char*);
+      shard.sh_pWriteEnd = pBlock + CSTRINGPOOL_BLOCK_SIZE;
+      shard.sh_iMemory += CSTRINGPOOL_BLOCK_SIZE;
+    }
+    pEntryMemory = shard.sh_pWrite;
+    shard.sh_pWrite += iSize;
+  }
+
+  StringPoolEntry* pEntry = (StringPoolEntry*)pEntryMemory;
+  pEntry->spe_ulHash = ulHash;
+  pEntry->spe_iLength = iLen;
+  memcpy(pEntry->spe_acData, sz, iLen);
+  pEntry->spe_acData[iLen] = '\0';
+
+  int iSlot = ulHash & (shard.sh_ctSlots - 1);
+  while(shard.sh_apSlots[iSlot] != NULL) {
+    iSlot = (iSlot + 1) & (shard.sh_ctSlots - 1);
+  }
+  shard.sh_apSlots[iSlot] = pEntry;
+  shard.sh_ctEntries++;
+  return pEntry;
+}
+
+InternedString StringPool::Intern(const char* sz, int iLen)
+{
+  if(iLen <= 0) {
+    return InternedString(&_speEmpty);
+  }
+
+  unsigned int ulHash = (unsigned int)hashBytes(sz, iLen);
+  Shard &shard = ShardFor(ulHash);
+  MutexWait wait(shard.sh_mutex);
+
+  const StringPoolEntry* pEntry = FindEntry(shard, sz, iLen, ulHash);
+  if(pEntry == NULL) {
+    pEntry = AddEntry(shard, sz, iLen, ulHash);
+  }
+  return InternedString(pEntry);
+}
+
+InternedString StringPool::Intern(const char* szValue)
+{
+  return Intern(StringView(szValue));
+}
+
+InternedString StringPool::Intern(const String &strValue)
+{
+  return Intern(strValue.View());
+}
+
+InternedString StringPool::Intern(const StringView &strValue)
+{
+  return Intern(strValue.Data(), strValue.Length());
+}
+
+bool StringPool::Find(const StringView &strValue, InternedString &istrResult)
+{
+  const char* sz = strValue.Data();
+  int iLen = strValue.Length();
+  if(iLen <= 0) {
+    istrResult = InternedString(&_speEmpty);
+    return true;
+  }
+
+  unsigned int ulHash = (unsigned int)hashBytes(sz, iLen);
+  Shard &shard = ShardFor(ulHash);
+  MutexWait wait(shard.sh_mutex);
+
+  const StringPoolEntry* pEntry = FindEntry(shard, sz, iLen, ulHash);
+  if(pEntry == NULL) {
+    return false;
+  }
+  istrResult = InternedString(pEntry);
+  return true;
+}
+
+int StringPool::Count()
+{
+  int ctEntries = 0;
+  for(int i=0; i<CSTRINGPOOL_SHARDS; i++) {
+    MutexWait wait(sp_aShards[i].sh_mutex);
+    ctEntries += sp_aShards[i].sh_ctEntries;
+  }
+  return ctEntries;
+}
+
+int StringPool::MemoryUsage()
+{
+  int iMemory = sizeof(StringPool);
+  for(int i=0; i<CSTRINGPOOL_SHARDS; i++) {
+    MutexWait wait(sp_aShards[i].sh_mutex);
+    iMemory += sp_aShards[i].sh_iMemory;
+  }
+  return iMemory;
+}
+
+StringPool& StringPool::Global()
+{
+  // Constructed on first use, which C++11 makes thread safe
+  static StringPool _spGlobal;
+  return _spGlobal;
+}
+
+SCRATCH_NAMESPACE_END;
@@ -0,0 +1,139 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CSTRINGPOOL_H_INCLUDED
+#define SCRATCH_CSTRINGPOOL_H_INCLUDED
+
+#include "CString.h"
+#include "CMutex.h"
+
+// Amount of independently locked parts of a pool, must be a power of two.
+#ifndef CSTRINGPOOL_SHARDS
+#define CSTRINGPOOL_SHARDS 16
+#endif
+
+// Size of the blocks the characters of interned strings are stored in.
+#ifndef CSTRINGPOOL_BLOCK_SIZE
+#define CSTRINGPOOL_BLOCK_SIZE (64 * 1024)
+#endif
+
+SCRATCH_NAMESPACE_BEGIN;
+
+class StringPool;
+
+/// The characters of an interned string, stored once in a StringPool
+struct StringPoolEntry
+{
+  unsigned int spe_ulHash;
+  int spe_iLength;
+  char spe_acData[1];
+};
+
+/// Handle to an immutable string stored once in a StringPool. Copying it copies a pointer, and two
+/// handles from the same pool are equal exactly when they point to the same entry.
+class SCRATCH_EXPORT InternedString
+{
+  friend class StringPool;
+private:
+  const StringPoolEntry* is_pEntry;
+
+  InternedString(const StringPoolEntry* pEntry);
+
+public:
+  /// An empty string
+  InternedString();
+  /// Intern the given value in the global pool
+  explicit InternedString(const char* szValue);
+  explicit InternedString(const String &strValue);
+  explicit InternedString(const StringView &strValue);
+
+  /// Return the amount of characters in the string
+  inline int Length() const { return is_pEntry->spe_iLength; }
+  /// Return the hash of the characters, computed once when the string was interned
+  inline unsigned int Hash() const { return is_pEntry->spe_ulHash; }
+  /// Return a view on the characters, which stays valid as long as the pool does
+  inline StringView View() const { return StringView(is_pEntry->spe_acData, is_pEntry->spe_iLength); }
+
+  inline operator const char*() const { return is_pEntry->spe_acData; }
+
+  /// Note: Only handles from the same pool can be compared
+  inline bool operator==(const InternedString &istr) const { return is_pEntry == istr.is_pEntry; }
+  inline bool operator!=(const InternedString &istr) const { return is_pEntry != istr.is_pEntry; }
+  /// Compare the characters, without interning the other string
+  bool operator==(const char* szValue) const;
+  bool operator!=(const char* szValue) const;
+};
+
+/// Stores every distinct string once. Interning is thread safe; the pool is split in shards
+/// with their own lock, picked by hash, so threads interning different strings rarely wait on
+/// each other. Entries live until the pool is destroyed.
+class SCRATCH_EXPORT StringPool
+{
+private:
+  struct Shard
+  {
+    Mutex sh_mutex;
+    const StringPoolEntry** sh_apSlots;
+    int sh_ctSlots;
+    int sh_ctEntries;
+    char* sh_pBlocks;
+    char* sh_pWrite;
+    char* sh_pWriteEnd;
+    int sh_iMemory;
+  };
+  Shard sp_aShards[CSTRINGPOOL_SHARDS];
+
+  Shard& ShardFor(unsigned int ulHash);
+  const StringPoolEntry* FindEntry(Shard &shard, const char* sz, int iLen, unsigned int ulHash);
+  const StringPoolEntry* AddEntry(Shard &shard, const char* sz, int iLen, unsigned int ulHash);
+
+  StringPool(const StringPool &copy); // Note: Not implemented, handles point into the pool.
+  StringPool& operator=(const StringPool &copy);
+
+public:
+  StringPool();
+  ~StringPool();
+
+  /// Return the handle for the given characters, adding them to the pool if they're new
+  InternedString Intern(const char* sz, int iLen);
+  InternedString Intern(const char* szValue);
+  InternedString Intern(const String &strValue);
+  InternedString Intern(const StringView &strValue);
+  /// Look up the given characters without adding them, returns false if they're not in the pool
+  bool Find(const StringView &strValue, InternedString &istrResult);
+
+  /// Return the amount of distinct strings in the pool
+  int Count();
+  /// Return the amount of bytes the pool has allocated
+  int MemoryUsage();
+
+  /// The pool used by the InternedString constructors
+  static StringPool& Global();
+};
+
+SCRATCH_NAMESPACE_END;
+
+#endif // include once check
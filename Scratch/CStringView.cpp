@@ -0,0 +1,366 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring> // for memcmp
+
+#include "CStringView.h"
+#include "CString.h"
+#include "StringSearch.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+StringView::StringView()
+{
+  sv_szBuffer = "";
+  sv_iLength = 0;
+}
+
+StringView::StringView(const char* szValue)
+{
+  // Validate the source string
+  if(szValue == NULL) {
+    szValue = "";
+  }
+  sv_szBuffer = szValue;
+  sv_iLength = strlen(szValue);
+}
+
+StringView::StringView(const char* szValue, int iLength)
+{
+  sv_szBuffer = szValue;
+  sv_iLength = iLength;
+}
+
+StringView::StringView(const String &str)
+{
+  sv_szBuffer = str;
+  sv_iLength = str.Length();
+}
+
+bool StringView::SplitNext(const StringView &strNeedle, StringView &strPart)
+{
+  // A view that has been split completely points nowhere
+  if(sv_szBuffer == NULL) {
+    return false;
+  }
+
+  // Find the needle from the current offset
+  int iIndex = strNeedle.sv_iLength > 0 ? IndexOf(strNeedle) : -1;
+
+  // If it's not found, the rest of the view is the last part
+  if(iIndex == -1) {
+    strPart = *this;
+    sv_szBuffer = NULL;
+    sv_iLength = 0;
+    return true;
+  }
+
+  // Take everything before the needle and skip past the needle
+  strPart = StringView(sv_szBuffer, iIndex);
+  sv_szBuffer += iIndex + strNeedle.sv_iLength;
+  sv_iLength -= iIndex + strNeedle.sv_iLength;
+  return true;
+}
+
+static inline bool IsArgumentSeparator(char c)
+{
+  return c == ' ' || c == '\t';
+}
+
+bool StringView::CommandLineSplitNext(StringView &strArgument, String &strBuffer)
+{
+  const char* sz = sv_szBuffer;
+  const char* szEnd = sv_szBuffer + sv_iLength;
+
+  // Skip the separators in front of the argument
+  while(sz < szEnd && IsArgumentSeparator(*sz)) {
+    sz++;
+  }
+  if(sz == szEnd) {
+    sv_szBuffer = szEnd;
+    sv_iLength = 0;
+    return false;
+  }
+
+  // A quoted argument only ends at a quote that's followed by a separator
+  bool bQuoted = *sz == '"';
+  if(bQuoted) {
+    sz++;
+  }
+
+  const char* szStart = sz;
+  const char* szRun = sz;
+  const char* szArgumentEnd = szEnd;
+  const char* szNext = szEnd;
+  bool bBuffered = false;
+
+  while(sz < szEnd) {
+    char c = *sz;
+    if(c == '\\' && sz + 1 < szEnd) {
+      // Copy what we have so far in one go, the escaped character starts the next run
+      if(!bBuffered) {
+        strBuffer.Clear();
+        bBuffered = true;
+      }
+      strBuffer += StringView(szRun, sz - szRun);
+      szRun = sz + 1;
+      sz += 2;
+      continue;
+    }
+
+    if(bQuoted ? (c == '"' && (sz + 1 == szEnd || IsArgumentSeparator(sz[1]))) : IsArgumentSeparator(c)) {
+      szArgumentEnd = sz;
+      szNext = sz + 1;
+      break;
+    }
+    sz++;
+  }
+
+  if(bBuffered) {
+    strBuffer += StringView(szRun, szArgumentEnd - szRun);
+    strArgument = strBuffer.View();
+  } else {
+    strArgument = StringView(szStart, szArgumentEnd - szStart);
+  }
+
+  sv_szBuffer = szNext;
+  sv_iLength = szEnd - szNext;
+  return true;
+}
+
+StringView StringView::InternalTrim(bool bLeft, bool bRight, char c) const
+{
+  // Keep pointers to the start and end of the part we want to keep
+  const char* szStart = sv_szBuffer;
+  const char* szEnd = szStart + sv_iLength;
+
+  if(bLeft) {
+    while(szStart < szEnd && *szStart == c) {
+      szStart++;
+    }
+  }
+
+  if(bRight) {
+    while(szEnd > szStart && *(szEnd - 1) == c) {
+      szEnd--;
+    }
+  }
+
+  return StringView(szStart, szEnd - szStart);
+}
+
+StringView StringView::Trim() const
+{
+  return InternalTrim(true, true);
+}
+
+StringView StringView::Trim(char c) const
+{
+  return InternalTrim(true, true, c);
+}
+
+StringView StringView::TrimLeft() const
+{
+  return InternalTrim(true, false);
+}
+
+StringView StringView::TrimLeft(char c) const
+{
+  return InternalTrim(true, false, c);
+}
+
+StringView StringView::TrimRight() const
+{
+  return InternalTrim(false, true);
+}
+
+StringView StringView::TrimRight(char c) const
+{
+  return InternalTrim(false, true, c);
+}
+
+StringView StringView::SubString(int iStart) const
+{
+  return SubString(iStart, sv_iLength - iStart);
+}
+
+StringView StringView::SubString(int iStart, int iLen) const
+{
+  // Empty views
+  if(iStart < 0 || iStart >= sv_iLength || iLen <= 0) {
+    return StringView(sv_szBuffer + Min(Max(iStart, 0), sv_iLength), 0);
+  }
+
+  // Clamp to the characters we actually have
+  if(iLen > sv_iLength - iStart) {
+    iLen = sv_iLength - iStart;
+  }
+
+  return StringView(sv_szBuffer + iStart, iLen);
+}
+
+bool StringView::IsValidUtf8() const
+{
+  return strUtf8Validate(sv_szBuffer, sv_iLength) == sv_iLength;
+}
+
+int StringView::Utf8Length() const
+{
+  return strUtf8Count(sv_szBuffer, sv_iLength);
+}
+
+StringView StringView::Utf8SubString(int iStart) const
+{
+  int iOffset = strUtf8Offset(sv_szBuffer, sv_iLength, iStart);
+  return StringView(sv_szBuffer + iOffset, sv_iLength - iOffset);
+}
+
+StringView StringView::Utf8SubString(int iStart, int iLen) const
+{
+  // Find the start first, then count the length from there
+  int iOffset = strUtf8Offset(sv_szBuffer, sv_iLength, iStart);
+  if(iLen <= 0) {
+    return StringView(sv_szBuffer + iOffset, 0);
+  }
+  int iBytes = strUtf8Offset(sv_szBuffer + iOffset, sv_iLength - iOffset, iLen);
+  return StringView(sv_szBuffer + iOffset, iBytes);
+}
+
+StringView StringView::InternalUtf8Trim(bool bLeft, bool bRight) const
+{
+  int iStart = 0;
+  int iEnd = sv_iLength;
+  int iSize;
+
+  if(bLeft) {
+    while(iStart < iEnd && strUtf8IsSpace(strUtf8Decode(sv_szBuffer + iStart, iEnd - iStart, iSize))) {
+      iStart += iSize;
+    }
+  }
+
+  if(bRight) {
+    while(iEnd > iStart) {
+      int iPrevious = strUtf8Previous(sv_szBuffer, iEnd);
+      if(iPrevious < iStart || !strUtf8IsSpace(strUtf8Decode(sv_szBuffer + iPrevious, iEnd - iPrevious, iSize))) {
+        break;
+      }
+      iEnd = iPrevious;
+    }
+  }
+
+  return StringView(sv_szBuffer + iStart, iEnd - iStart);
+}
+
+StringView StringView::Utf8Trim() const
+{
+  return InternalUtf8Trim(true, true);
+}
+
+StringView StringView::Utf8TrimLeft() const
+{
+  return InternalUtf8Trim(true, false);
+}
+
+StringView StringView::Utf8TrimRight() const
+{
+  return InternalUtf8Trim(false, true);
+}
+
+int StringView::IndexOf(char c) const
+{
+  const char* sz = strFindChar(sv_szBuffer, sv_iLength, c);
+  if(sz != NULL) {
+    return sz - sv_szBuffer;
+  }
+  return -1;
+}
+
+int StringView::IndexOf(const StringView &strNeedle) const
+{
+  const char* sz = strFind(sv_szBuffer, sv_iLength, strNeedle.sv_szBuffer, strNeedle.sv_iLength);
+  if(sz != NULL) {
+    return sz - sv_szBuffer;
+  }
+  return -1;
+}
+
+int StringView::IndexOfLast(char c) const
+{
+  const char* sz = strFindCharLast(sv_szBuffer, sv_iLength, c);
+  if(sz != NULL) {
+    return sz - sv_szBuffer;
+  }
+  return -1;
+}
+
+int StringView::IndexOfLast(const StringView &strNeedle) const
+{
+  const char* sz = strFindLast(sv_szBuffer, sv_iLength, strNeedle.sv_szBuffer, strNeedle.sv_iLength);
+  if(sz != NULL) {
+    return sz - sv_szBuffer;
+  }
+  return -1;
+}
+
+bool StringView::Contains(const StringView &strNeedle) const
+{
+  return IndexOf(strNeedle) != -1;
+}
+
+bool StringView::Contains(char c) const
+{
+  return IndexOf(c) != -1;
+}
+
+bool StringView::StartsWith(const StringView &strNeedle) const
+{
+  // Only compare the characters at the start
+  if(strNeedle.sv_iLength > sv_iLength) {
+    return false;
+  }
+  return !memcmp(sv_szBuffer, strNeedle.sv_szBuffer, strNeedle.sv_iLength);
+}
+
+bool StringView::EndsWith(const StringView &strNeedle) const
+{
+  // Only compare the characters at the end
+  if(strNeedle.sv_iLength > sv_iLength) {
+    return false;
+  }
+  return !memcmp(sv_szBuffer + sv_iLength - strNeedle.sv_iLength, strNeedle.sv_szBuffer, strNeedle.sv_iLength);
+}
+
+bool StringView::operator==(const StringView &strOther) const
+{
+  return sv_iLength == strOther.sv_iLength && !memcmp(sv_szBuffer, strOther.sv_szBuffer, sv_iLength);
+}
+
+bool StringView::operator!=(const StringView &strOther) const
+{
+  return !(*this == strOther);
+}
+
+SCRATCH_NAMESPACE_END;
@@ -0,0 +1,157 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CSTRINGVIEW_H_INCLUDED
+#define SCRATCH_CSTRINGVIEW_H_INCLUDED
+
+#include "Common.h"
+#include "Hash.h"
+#include "StringUtf8.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+class String;
+
+/// A non-owning view on a range of characters. It's just a pointer and a length, so it
+/// never allocates, but the characters it points to have to outlive the view.
+/// Note: The characters of a view are not necessarily null terminated.
+class SCRATCH_EXPORT StringView
+{
+public:
+  const char* sv_szBuffer;
+  int sv_iLength;
+
+public:
+  StringView();
+  StringView(const char* szValue);
+  StringView(const char* szValue, int iLength);
+  StringView(const String &str);
+
+  /// Return the amount of characters in the view
+  inline int Length() const { return sv_iLength; }
+  /// Return a pointer to the first character of the view
+  inline const char* Data() const { return sv_szBuffer; }
+
+  /// Split the view by the given needle, calling the given function with a view on each part
+  template<typename Func>
+  INDEX Split(const StringView &strNeedle, Func f) const;
+  /// Take the part up to the given needle off the front of this view, returns false when nothing is left
+  bool SplitNext(const StringView &strNeedle, StringView &strPart);
+  /// Take the next shell-like argument off the front of this view, returns false when nothing is left.
+  /// Arguments are separated by spaces and tabs, can be "quoted", and a backslash takes the next
+  /// character literally. Arguments with escapes are written into the given buffer, which is reused
+  /// between calls, so the resulting view is only valid until the next call.
+  bool CommandLineSplitNext(StringView &strArgument, String &strBuffer);
+
+private:
+  StringView InternalTrim(bool bLeft, bool bRight, char c = ' ') const;
+public:
+  StringView Trim() const;
+  StringView Trim(char c) const;
+  StringView TrimLeft() const;
+  StringView TrimLeft(char c) const;
+  StringView TrimRight() const;
+  StringView TrimRight(char c) const;
+  StringView SubString(int iStart) const;
+  StringView SubString(int iStart, int iLen) const;
+
+  /// Return whether the view is valid UTF-8
+  bool IsValidUtf8() const;
+  /// Return the amount of codepoints, assuming the view is valid UTF-8
+  int Utf8Length() const;
+  /// Return the part starting at the given codepoint, never splitting a multibyte character
+  StringView Utf8SubString(int iStart) const;
+  StringView Utf8SubString(int iStart, int iLen) const;
+private:
+  StringView InternalUtf8Trim(bool bLeft, bool bRight) const;
+public:
+  /// Trim all Unicode whitespace, like no-break and ideographic spaces, not just ASCII spaces
+  StringView Utf8Trim() const;
+  StringView Utf8TrimLeft() const;
+  StringView Utf8TrimRight() const;
+  /// Take the first codepoint off the front of this view, returns false when nothing is left
+  inline bool NextCodepoint(unsigned int &iCodepoint)
+  {
+    if(sv_iLength == 0) {
+      return false;
+    }
+
+    // ASCII doesn't need decoding
+    int iSize = 1;
+    iCodepoint = (UBYTE)sv_szBuffer[0];
+    if(iCodepoint >= 0x80) {
+      iCodepoint = strUtf8Decode(sv_szBuffer, sv_iLength, iSize);
+    }
+    sv_szBuffer += iSize;
+    sv_iLength -= iSize;
+    return true;
+  }
+
+  int IndexOf(char c) const;
+  int IndexOf(const StringView &strNeedle) const;
+
+  int IndexOfLast(char c) const;
+  int IndexOfLast(const StringView &strNeedle) const;
+
+  bool Contains(const StringView &strNeedle) const;
+  bool Contains(char c) const;
+  bool StartsWith(const StringView &strNeedle) const;
+  bool EndsWith(const StringView &strNeedle) const;
+
+  bool operator==(const StringView &strOther) const;
+  bool operator!=(const StringView &strOther) const;
+
+  inline char operator[](int iIndex) const { return sv_szBuffer[iIndex]; }
+
+  /// Return a hash of the characters, the same as String::Hash gives for the same characters
+  inline unsigned long long Hash(unsigned long long ulSeed = 0) const { return hashBytes(sv_szBuffer, sv_iLength, ulSeed); }
+};
+
+template<>
+struct Hasher<StringView>
+{
+  static inline unsigned long long Hash(const StringView &str, unsigned long long ulSeed = 0) { return str.Hash(ulSeed); }
+};
+
+template<typename Func>
+INDEX StringView::Split(const StringView &strNeedle, Func f) const
+{
+  StringView strRemaining = *this;
+  StringView strPart;
+  INDEX ctParts = 0;
+
+  // Hand every part to the function
+  while(strRemaining.SplitNext(strNeedle, strPart)) {
+    f(strPart);
+    ctParts++;
+  }
+
+  return ctParts;
+}
+
+SCRATCH_NAMESPACE_END;
+
+#endif // include once check
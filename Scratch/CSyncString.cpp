@@ -0,0 +1,122 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "CSyncString.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+SyncString::SyncString()
+{
+}
+
+SyncString::SyncString(const char* szValue)
+  : ss_str(szValue)
+{
+}
+
+SyncString::SyncString(const String &strValue)
+  : ss_str(strValue)
+{
+}
+
+SyncString::SyncString(const SyncString &copy)
+  : ss_str(copy.Get())
+{
+}
+
+SyncString::~SyncString()
+{
+}
+
+String SyncString::Get() const
+{
+  MutexWait wait(ss_mutex);
+  return ss_str;
+}
+
+void SyncString::Set(const String &strValue)
+{
+  MutexWait wait(ss_mutex);
+  ss_str = strValue;
+}
+
+int SyncString::Length() const
+{
+  MutexWait wait(ss_mutex);
+  return ss_str.Length();
+}
+
+SyncString& SyncString::operator=(const char* szSrc)
+{
+  MutexWait wait(ss_mutex);
+  ss_str = szSrc;
+  return *this;
+}
+
+SyncString& SyncString::operator=(const String &strSrc)
+{
+  MutexWait wait(ss_mutex);
+  ss_str = strSrc;
+  return *this;
+}
+
+SyncString& SyncString::operator=(const SyncString &strSrc)
+{
+  // If the right hand side is not the left hand side...
+  if(this != &strSrc) {
+    // Take a copy first so we never hold both locks at once
+    Set(strSrc.Get());
+  }
+  return *this;
+}
+
+SyncString& SyncString::operator+=(const char* szSrc)
+{
+  MutexWait wait(ss_mutex);
+  ss_str += szSrc;
+  return *this;
+}
+
+SyncString& SyncString::operator+=(const char cSrc)
+{
+  MutexWait wait(ss_mutex);
+  ss_str += cSrc;
+  return *this;
+}
+
+bool SyncString::operator==(const char* szSrc) const
+{
+  MutexWait wait(ss_mutex);
+  return ss_str == szSrc;
+}
+
+bool SyncString::operator!=(const char* szSrc) const
+{
+  MutexWait wait(ss_mutex);
+  return ss_str != szSrc;
+}
+
+SCRATCH_NAMESPACE_END;
@@ -0,0 +1,79 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CSYNCSTRING_H_INCLUDED
+#define SCRATCH_CSYNCSTRING_H_INCLUDED
+
+#include "CString.h"
+#include "CMutex.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/// A String guarded by a Mutex, for the rare string that is shared and modified between threads.
+/// String itself is an unsynchronized value type.
+class SCRATCH_EXPORT SyncString
+{
+protected:
+  String ss_str;
+  Mutex ss_mutex;
+
+public:
+  SyncString();
+  SyncString(const char* szValue);
+  SyncString(const String &strValue);
+  SyncString(const SyncString &copy);
+  ~SyncString();
+
+  /// Return a copy of the current value
+  String Get() const;
+  /// Replace the current value
+  void Set(const String &strValue);
+
+  /// Return the amount of characters in the string
+  int Length() const;
+
+  /// Run the given function with exclusive access to the string
+  template<typename Func>
+  void Access(Func f)
+  {
+    MutexWait wait(ss_mutex);
+    f(ss_str);
+  }
+
+  SyncString& operator=(const char* szSrc);
+  SyncString& operator=(const String &strSrc);
+  SyncString& operator=(const SyncString &strSrc);
+
+  SyncString& operator+=(const char* szSrc);
+  SyncString& operator+=(const char cSrc);
+
+  bool operator==(const char* szSrc) const;
+  bool operator!=(const char* szSrc) const;
+};
+
+SCRATCH_NAMESPACE_END;
+
+#endif // include once check
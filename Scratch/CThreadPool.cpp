@@ -0,0 +1,180 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "CThreadPool.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+// Set for the worker threads of every pool, and for a caller while it works on its own range, so a For
+// from inside a chunk runs right there instead of waiting on itself or locking a mutex it already holds
+static thread_local bool _bInPoolRange = false;
+
+ThreadPool::ThreadPool(INDEX ctThreads)
+{
+  if(ctThreads <= 0) {
+    ctThreads = Max((INDEX)std::thread::hardware_concurrency(), (INDEX)1);
+  }
+
+  tp_bStop = false;
+  tp_pfChunk = NULL;
+  tp_ct = 0;
+  tp_ctGrain = 1;
+  tp_ctChunks = 0;
+  tp_ctMaxWorkers = 0;
+  tp_iGeneration = 0;
+  tp_ctBusy = 0;
+  tp_iNextChunk = 0;
+
+  // the calling thread is the last one working on a range
+  tp_ctWorkers = ctThreads - 1;
+  tp_athWorkers = NULL;
+  if(tp_ctWorkers > 0) {
+    tp_athWorkers = new std::thread[tp_ctWorkers];
+    for(INDEX i=0; i<tp_ctWorkers; i++) {
+      tp_athWorkers[i] = std::thread(&ThreadPool::WorkerThread, this, i);
+    }
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(tp_mutex);
+    tp_bStop = true;
+  }
+  tp_cvWork.notify_all();
+
+  for(INDEX i=0; i<tp_ctWorkers; i++) {
+    tp_athWorkers[i].join();
+  }
+  delete[] tp_athWorkers;
+}
+
+void ThreadPool::RunChunks(const std::function<void(INDEX, INDEX)> &fChunk, INDEX ct, INDEX ctGrain, INDEX ctChunks)
+{
+  // take chunks until there are none left
+  while(true) {
+    INDEX iChunk = tp_iNextChunk.fetch_add(1);
+    if(iChunk >= ctChunks) {
+      break;
+    }
+    INDEX iStart = iChunk * ctGrain;
+    fChunk(iStart, Min(iStart + ctGrain, ct));
+  }
+}
+
+void ThreadPool::WorkerThread(INDEX iWorker)
+{
+  _bInPoolRange = true;
+
+  unsigned int iSeenGeneration = 0;
+  std::unique_lock<std::mutex> lock(tp_mutex);
+  while(true) {
+    // wait for a range we haven't worked on yet
+    tp_cvWork.wait(lock, [&]() {
+      return tp_bStop || (tp_pfChunk != NULL && tp_iGeneration != iSeenGeneration);
+    });
+    if(tp_bStop) {
+      break;
+    }
+    iSeenGeneration = tp_iGeneration;
+
+    // the caller might not want all threads
+    if(iWorker >= tp_ctMaxWorkers) {
+      continue;
+    }
+
+    // the range stays valid until we're no longer busy
+    const std::function<void(INDEX, INDEX)> &fChunk = *tp_pfChunk;
+    INDEX ct = tp_ct;
+    INDEX ctGrain = tp_ctGrain;
+    INDEX ctChunks = tp_ctChunks;
+    tp_ctBusy++;
+
+    lock.unlock();
+    RunChunks(fChunk, ct, ctGrain, ctChunks);
+    lock.lock();
+
+    if(--tp_ctBusy == 0) {
+      tp_cvDone.notify_all();
+    }
+  }
+}
+
+void ThreadPool::For(INDEX ct, INDEX ctGrain, const std::function<void(INDEX, INDEX)> &fChunk, INDEX ctMaxThreads)
+{
+  if(ct <= 0) {
+    return;
+  }
+  ctGrain = Max(ctGrain, (INDEX)1);
+  INDEX ctChunks = (ct + ctGrain - 1) / ctGrain;
+  if(ctMaxThreads <= 0 || ctMaxThreads > ThreadCount()) {
+    ctMaxThreads = ThreadCount();
+  }
+
+  // a single chunk, a single thread, a For from inside a chunk, or a range that another thread has in
+  // progress is done right here. The flag is tested first, so we never try to lock the range twice.
+  std::unique_lock<std::mutex> lockRange(tp_mutexRange, std::defer_lock);
+  if(ctChunks == 1 || ctMaxThreads == 1 || _bInPoolRange || !lockRange.try_lock()) {
+    for(INDEX iStart=0; iStart<ct; iStart+=ctGrain) {
+      fChunk(iStart, Min(iStart + ctGrain, ct));
+    }
+    return;
+  }
+
+  // hand out the range to the workers
+  {
+    std::lock_guard<std::mutex> lock(tp_mutex);
+    tp_pfChunk = &fChunk;
+    tp_ct = ct;
+    tp_ctGrain = ctGrain;
+    tp_ctChunks = ctChunks;
+    tp_ctMaxWorkers = ctMaxThreads - 1;
+    tp_iNextChunk = 0;
+    tp_iGeneration++;
+  }
+  tp_cvWork.notify_all();
+
+  // work along, then wait for the workers that are still on their last chunk
+  _bInPoolRange = true;
+  RunChunks(fChunk, ct, ctGrain, ctChunks);
+  _bInPoolRange = false;
+
+  std::unique_lock<std::mutex> lock(tp_mutex);
+  tp_cvDone.wait(lock, [this]() { return tp_ctBusy == 0; });
+
+  // workers that wake up after this don't join in anymore
+  tp_pfChunk = NULL;
+}
+
+ThreadPool& ThreadPool::Global()
+{
+  // Constructed on first use, which C++11 makes thread safe
+  static ThreadPool _tpGlobal;
+  return _tpGlobal;
+}
+
+SCRATCH_NAMESPACE_END;
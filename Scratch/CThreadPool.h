@@ -0,0 +1,94 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_CTHREADPOOL_H_INCLUDED
+#define SCRATCH_CTHREADPOOL_H_INCLUDED
+
+#include "Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Default amount of objects a thread handles at once in the saParallel functions of StackArrayParallel.h.
+#ifndef CTHREADPOOL_DEFAULT_GRAIN
+#define CTHREADPOOL_DEFAULT_GRAIN 1024
+#endif
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/// Fixed set of threads that split a range of work into chunks between them. The thread calling For
+/// works along, and For only returns once every chunk is done. One range is worked on at a time; For
+/// calls from a worker or while another thread's range is in progress run on the calling thread.
+class SCRATCH_EXPORT ThreadPool
+{
+private:
+  std::thread* tp_athWorkers;
+  INDEX tp_ctWorkers;
+
+  std::mutex tp_mutex;
+  std::condition_variable tp_cvWork;
+  std::condition_variable tp_cvDone;
+  std::mutex tp_mutexRange;
+  bool tp_bStop;
+
+  // the range currently being worked on, only changed while tp_mutex is held
+  const std::function<void(INDEX, INDEX)>* tp_pfChunk;
+  INDEX tp_ct;
+  INDEX tp_ctGrain;
+  INDEX tp_ctChunks;
+  INDEX tp_ctMaxWorkers;
+  unsigned int tp_iGeneration;
+  INDEX tp_ctBusy;
+  std::atomic<INDEX> tp_iNextChunk;
+
+  void WorkerThread(INDEX iWorker);
+  void RunChunks(const std::function<void(INDEX, INDEX)> &fChunk, INDEX ct, INDEX ctGrain, INDEX ctChunks);
+
+  ThreadPool(const ThreadPool &copy); // Note: Not implemented, the threads belong to one pool.
+  ThreadPool& operator=(const ThreadPool &copy);
+
+public:
+  /// Start a pool that works with the given amount of threads including the caller, 0 meaning one for every core
+  ThreadPool(INDEX ctThreads = 0);
+  ~ThreadPool();
+
+  /// Return the amount of threads working on a range, including the caller
+  inline INDEX ThreadCount() const { return tp_ctWorkers + 1; }
+
+  /// Call the function with the start and end of every chunk of at most ctGrain indices in [0, ct), spread
+  /// over at most ctMaxThreads threads (0 meaning all of them), and return once all chunks are done
+  void For(INDEX ct, INDEX ctGrain, const std::function<void(INDEX, INDEX)> &fChunk, INDEX ctMaxThreads = 0);
+
+  /// The pool used by the saParallel functions of StackArrayParallel.h, with a thread for every core
+  static ThreadPool& Global();
+};
+
+SCRATCH_NAMESPACE_END;
+
+#endif // include once check
@@ -193,4 +193,11 @@ Vector3f& Vector3f::operator /=(const FLOAT f)
   return *this;
 }
 
+unsigned long long Hasher<Vector3f>::Hash(const Vector3f &v, unsigned long long ulSeed)
+{
+  // Adding 0 turns -0 into 0
+  FLOAT afValues[3] = { v.x + 0.0f, v.y + 0.0f, v.z + 0.0f };
+  return hashBytes(afValues, sizeof(afValues), ulSeed);
+}
+
 SCRATCH_NAMESPACE_END;
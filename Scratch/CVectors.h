@@ -28,6 +28,7 @@
 #define SCRATCH_CVECTORS_H_INCLUDED
 
 #include "Common.h"
+#include "Hash.h"
 
 SCRATCH_NAMESPACE_BEGIN;
 
@@ -70,6 +71,13 @@ public:
   Vector3f& operator /=(const FLOAT f);
 };
 
+template<>
+struct Hasher<Vector3f>
+{
+  /// Note: -0 and 0 hash the same, since they compare equal
+  static unsigned long long Hash(const Vector3f &v, unsigned long long ulSeed = 0);
+};
+
 SCRATCH_NAMESPACE_END;
 
 #endif
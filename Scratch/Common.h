@@ -30,6 +30,7 @@
 #include <cstdio>
 #include <cmath>
 #include <cassert>
+#include <utility> // for std::move
 
 #ifdef _MSC_VER
 #ifndef WIN32_LEAN_AND_MEAN
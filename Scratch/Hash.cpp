@@ -0,0 +1,164 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring> // for memcpy
+
+#include "Hash.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h> // for _umul128
+#endif
+
+SCRATCH_NAMESPACE_BEGIN;
+
+// The default secret of wyhash, odd constants with a balanced amount of set bits
+static const unsigned long long _aulSecret[4] = {
+  0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL,
+};
+
+// Multiply into 128 bits, leaving the low half in ulA and the high half in ulB
+static inline void MultiplyFull(unsigned long long &ulA, unsigned long long &ulB)
+{
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 ulProduct = (unsigned __int128)ulA * ulB;
+  ulA = (unsigned long long)ulProduct;
+  ulB = (unsigned long long)(ulProduct >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  ulA = _umul128(ulA, ulB, &ulB);
+#else
+  unsigned long long ulHighA = ulA >> 32, ulHighB = ulB >> 32;
+  unsigned long long ulLowA = (unsigned int)ulA, ulLowB = (unsigned int)ulB;
+  unsigned long long ulHigh = ulHighA * ulHighB, ulMid0 = ulHighA * ulLowB, ulMid1 = ulHighB * ulLowA, ulLow = ulLowA * ulLowB;
+  unsigned long long ulTemp = ulLow + (ulMid0 << 32);
+  unsigned long long ulCarry = ulTemp < ulLow;
+  unsigned long long ulResult = ulTemp + (ulMid1 << 32);
+  ulCarry += ulResult < ulTemp;
+  ulA = ulResult;
+  ulB = ulHigh + (ulMid0 >> 32) + (ulMid1 >> 32) + ulCarry;
+#endif
+}
+
+static inline unsigned long long Mix(unsigned long long ulA, unsigned long long ulB)
+{
+  MultiplyFull(ulA, ulB);
+  return ulA ^ ulB;
+}
+
+// Turn A-Z into a-z in all 8 bytes of a word at once. Adding to the low 7 bits of every byte
+// sets its high bit when it's at least 'A' or more than 'Z', without carrying into the next byte.
+static inline unsigned long long FoldWord(unsigned long long ulWord)
+{
+  const unsigned long long ulHighBits = 0x8080808080808080ULL;
+  unsigned long long ulLow7 = ulWord & ~ulHighBits;
+  unsigned long long ulAtLeastA = ulLow7 + 0x3F3F3F3F3F3F3F3FULL;
+  unsigned long long ulAboveZ = ulLow7 + 0x2525252525252525ULL;
+  unsigned long long ulUpper = ulAtLeastA & ~ulAboveZ & ~ulWord & ulHighBits;
+  return ulWord | (ulUpper >> 2);
+}
+
+// Reads the input as it is
+struct HashReadPlain
+{
+  static inline unsigned long long Read8(const UBYTE* p) { unsigned long long ul; memcpy(&ul, p, 8); return ul; }
+  static inline unsigned long long Read4(const UBYTE* p) { unsigned int ul; memcpy(&ul, p, 4); return ul; }
+  static inline unsigned long long Read1(const UBYTE* p) { return *p; }
+};
+
+// Reads the input as if it was lowercase
+struct HashReadFolded
+{
+  static inline unsigned long long Read8(const UBYTE* p) { return FoldWord(HashReadPlain::Read8(p)); }
+  static inline unsigned long long Read4(const UBYTE* p) { return FoldWord(HashReadPlain::Read4(p)); }
+  static inline unsigned long long Read1(const UBYTE* p) { return FoldWord(*p); }
+};
+
+template<typename Reader>
+static inline unsigned long long WyHash(const UBYTE* p, int iLen, unsigned long long ulSeed)
+{
+  ulSeed ^= Mix(ulSeed ^ _aulSecret[0], _aulSecret[1]);
+  unsigned long long ulA, ulB;
+
+  if(iLen <= 16) {
+    if(iLen >= 4) {
+      // Two overlapping pairs of 4 bytes cover anything from 4 to 16 bytes
+      int iOffset = (iLen >> 3) << 2;
+      ulA = (Reader::Read4(p) << 32) | Reader::Read4(p + iOffset);
+      ulB = (Reader::Read4(p + iLen - 4) << 32) | Reader::Read4(p + iLen - 4 - iOffset);
+    } else if(iLen > 0) {
+      ulA = (Reader::Read1(p) << 16) | (Reader::Read1(p + (iLen >> 1)) << 8) | Reader::Read1(p + iLen - 1);
+      ulB = 0;
+    } else {
+      ulA = ulB = 0;
+    }
+  } else {
+    int i = iLen;
+    if(i >= 48) {
+      // Three independent lanes keep the multipliers busy on long inputs
+      unsigned long long ulSeed1 = ulSeed, ulSeed2 = ulSeed;
+      do {
+        ulSeed = Mix(Reader::Read8(p) ^ _aulSecret[1], Reader::Read8(p + 8) ^ ulSeed);
+        ulSeed1 = Mix(Reader::Read8(p + 16) ^ _aulSecret[2], Reader::Read8(p + 24) ^ ulSeed1);
+        ulSeed2 = Mix(Reader::Read8(p + 32) ^ _aulSecret[3], Reader::Read8(p + 40) ^ ulSeed2);
+        p += 48;
+        i -= 48;
+      } while(i >= 48);
+      ulSeed ^= ulSeed1 ^ ulSeed2;
+    }
+    while(i > 16) {
+      ulSeed = Mix(Reader::Read8(p) ^ _aulSecret[1], Reader::Read8(p + 8) ^ ulSeed);
+      p += 16;
+      i -= 16;
+    }
+    // The last 16 bytes, which may overlap with what was already mixed in
+    ulA = Reader::Read8(p + i - 16);
+    ulB = Reader::Read8(p + i - 8);
+  }
+
+  ulA ^= _aulSecret[1];
+  ulB ^= ulSeed;
+  MultiplyFull(ulA, ulB);
+  return Mix(ulA ^ _aulSecret[0] ^ (unsigned long long)iLen, ulB ^ _aulSecret[1]);
+}
+
+unsigned long long hashBytes(const void* pData, int iLen, unsigned long long ulSeed)
+{
+  return WyHash<HashReadPlain>((const UBYTE*)pData, Max(iLen, 0), ulSeed);
+}
+
+unsigned long long hashBytesIgnoreCase(const char* sz, int iLen, unsigned long long ulSeed)
+{
+  return WyHash<HashReadFolded>((const UBYTE*)sz, Max(iLen, 0), ulSeed);
+}
+
+unsigned long long hashInteger(unsigned long long ulValue, unsigned long long ulSeed)
+{
+  unsigned long long ulA = ulValue ^ _aulSecret[0];
+  unsigned long long ulB = ulSeed ^ _aulSecret[1];
+  MultiplyFull(ulA, ulB);
+  return Mix(ulA ^ _aulSecret[0], ulB ^ _aulSecret[1]);
+}
+
+SCRATCH_NAMESPACE_END;
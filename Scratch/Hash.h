@@ -0,0 +1,72 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_HASH_H_INCLUDED
+#define SCRATCH_HASH_H_INCLUDED
+
+#include "Common.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/* Hashing used by the containers, based on wyhash. Every function takes an optional seed;
+ * pass a secret random seed for tables that are filled with untrusted keys, so nobody can
+ * craft keys that all land on the same hash.
+ */
+
+/// Hash a range of bytes
+unsigned long long SCRATCH_EXPORT hashBytes(const void* pData, int iLen, unsigned long long ulSeed = 0);
+/// Hash a range of characters as if A-Z were a-z, without changing or copying them
+unsigned long long SCRATCH_EXPORT hashBytesIgnoreCase(const char* sz, int iLen, unsigned long long ulSeed = 0);
+/// Hash a single integer, much cheaper than hashing its bytes
+unsigned long long SCRATCH_EXPORT hashInteger(unsigned long long ulValue, unsigned long long ulSeed = 0);
+
+/// Customization point for hashing keys, specialized next to the types that can be hashed
+template<typename T>
+struct Hasher;
+
+#define SCRATCH_HASHER_INTEGER(T) \
+  template<> struct Hasher<T> { \
+    static inline unsigned long long Hash(T value, unsigned long long ulSeed = 0) { return hashInteger((unsigned long long)value, ulSeed); } \
+  };
+
+SCRATCH_HASHER_INTEGER(bool)
+SCRATCH_HASHER_INTEGER(char)
+SCRATCH_HASHER_INTEGER(signed char)
+SCRATCH_HASHER_INTEGER(unsigned char)
+SCRATCH_HASHER_INTEGER(short)
+SCRATCH_HASHER_INTEGER(unsigned short)
+SCRATCH_HASHER_INTEGER(int)
+SCRATCH_HASHER_INTEGER(unsigned int)
+SCRATCH_HASHER_INTEGER(long)
+SCRATCH_HASHER_INTEGER(unsigned long)
+SCRATCH_HASHER_INTEGER(long long)
+SCRATCH_HASHER_INTEGER(unsigned long long)
+
+#undef SCRATCH_HASHER_INTEGER
+
+SCRATCH_NAMESPACE_END;
+
+#endif // include once check
@@ -41,6 +41,108 @@
  */
 #include "CString.h"
 
+/* StringView: non-owning view on a range of characters
+ * ----------------------------------------------------
+ * Basic usage:
+ *   String strLine = "GET /index.html HTTP/1.1";
+ *   StringView strMethod, strPath;
+ *   StringView strRemaining = strLine.View();
+ *   strRemaining.SplitNext(" ", strMethod); // GET
+ *   strRemaining.SplitNext(" ", strPath);   // /index.html
+ *   ASSERT(strPath.EndsWith(".html"));
+ *   strLine.View().Split(" ", [](const StringView &strPart) {
+ *     // called for "GET", "/index.html" and "HTTP/1.1", without allocating
+ *   });
+ */
+#include "CStringView.h"
+
+/* StringSearch: SIMD accelerated search kernels used by String and StringView
+ * ---------------------------------------------------------------------------
+ * Basic usage:
+ *   const char* szFound = strFind(szText, iTextLen, "needle", 6);
+ *   const char* szLastComma = strFindCharLast(szText, iTextLen, ',');
+ */
+#include "StringSearch.h"
+
+/* StringConvert: number formatting and parsing used by String, without allocating
+ * --------------------------------------------------------------------------------
+ * Basic usage:
+ *   char acBuffer[STRINGCONVERT_MAX_CHARS];
+ *   int iLen = strFromDouble(acBuffer, 0.1); // "0.1"
+ *   long long iValue;
+ *   bool bValid = strToInt("-42", 3, iValue); // true, -42
+ */
+#include "StringConvert.h"
+
+/* StringUtf8: vectorized UTF-8 validation and codepoint helpers used by String and StringView
+ * ------------------------------------------------------------------------------------------
+ * Basic usage:
+ *   String strName = "  Zo\xC3\xAB\xC2\xA0"; // Zoë, then a no-break space
+ *   ASSERT(strName.IsValidUtf8());
+ *   ASSERT(strName.Utf8Trim().Utf8Length() == 3);
+ *   StringView strRemaining = strName.View();
+ *   unsigned int iCodepoint;
+ *   while(strRemaining.NextCodepoint(iCodepoint)) {
+ *     // called for every codepoint, invalid bytes become STRINGUTF8_REPLACEMENT
+ *   }
+ */
+#include "StringUtf8.h"
+
+/* StringFormat: type safe formatting straight into a String, checked at compile time by the macros
+ * ------------------------------------------------------------------------------------------------
+ * Basic usage:
+ *   String strLine = SCRATCH_FORMAT("%s:%d took %.3f ms", strFile, iLine, fTime);
+ *   SCRATCH_APPEND_FORMAT(strLine, " (%s)", "cached");
+ *   SCRATCH_FORMAT("%d", "text"); // doesn't compile
+ *   strLine.Format("%s", 42);     // only parsed at runtime, writes "42"
+ * Only the macros check the format string at compile time, String::Format, AppendFormat and
+ * strFormat don't.
+ */
+#include "StringFormat.h"
+
+/* Hash: fast 64 bit hashing of bytes, strings and keys
+ * ----------------------------------------------------
+ * Basic usage:
+ *   unsigned long long ulHash = strName.Hash();
+ *   ASSERT(ulHash == hashBytes((const char*)strName, strName.Length()));
+ *   ASSERT(String("Host").HashIgnoreCase() == String("HOST").HashIgnoreCase());
+ *   unsigned long long ulKey = Hasher<int>::Hash(42);
+ */
+#include "Hash.h"
+
+/* StringBuilder: collects fragments and builds a String with a single allocation
+ * ------------------------------------------------------------------------------
+ * Basic usage:
+ *   StringBuilder sb;
+ *   for(int i=0; i<astrNames.Count(); i++) {
+ *     sb.Append("<li>").Append(astrNames[i]).Append("</li>\n");
+ *   }
+ *   String strList = sb.ToString();
+ */
+#include "CStringBuilder.h"
+
+/* StringPool: stores every distinct string once and hands out handles to it
+ * -------------------------------------------------------------------------
+ * Basic usage:
+ *   StringPool sp;
+ *   InternedString istrKey = sp.Intern(strLine.View(0, 4));
+ *   ASSERT(istrKey == sp.Intern("host")); // compares pointers
+ *   InternedString istrGlobal("host");     // interned in StringPool::Global()
+ */
+#include "CStringPool.h"
+
+/* SyncString: String guarded by a mutex, for strings shared between threads
+ * -------------------------------------------------------------------------
+ * Basic usage:
+ *   SyncString strStatus = "Idle";
+ *   strStatus += "...";                  // safe from any thread
+ *   String strCopy = strStatus.Get();    // Idle...
+ *   strStatus.Access([](String &str) {
+ *     str = str.Replace("Idle", "Busy"); // Busy...
+ *   });
+ */
+#include "CSyncString.h"
+
 /* Filename: high level string management with filename functions
  * --------------------------------------------------------------
  * Basic usage:
@@ -67,6 +169,56 @@
  */
 #include "CStackArray.h"
 
+/* Array: array that stores its objects next to each other
+ * -------------------------------------------------------
+ * Basic usage:
+ *   Array<int> aiTest;
+ *   aiTest.Reserve(3);
+ *   aiTest.Push(5);
+ *   aiTest.Push() = 10;
+ *   aiTest.Push(123);
+ *   ASSERT(aiTest[0] == 5);
+ *   ASSERT(aiTest.Pop() == 123);
+ *   ASSERT(aiTest.Count() == 2);
+ */
+#include "CArray.h"
+
+/* Deque: queue with cheap pushing and popping at both ends
+ * --------------------------------------------------------
+ * Basic usage:
+ *   Deque<Job> aJobs;
+ *   aJobs.Push(jobNormal);
+ *   aJobs.PushBegin(jobUrgent);
+ *   while(aJobs.Count() > 0) {
+ *     Job job = aJobs.PopBegin(); // jobUrgent, then jobNormal
+ *   }
+ */
+#include "CDeque.h"
+
+/* SmallArray: array that keeps its first few objects inside itself
+ * ----------------------------------------------------------------
+ * Basic usage:
+ *   SmallArray<String, 4> astrParts;
+ *   String("host:8080").Split(":", astrParts); // doesn't allocate slots
+ *   ASSERT(astrParts.IsInline() && astrParts[1] == "8080");
+ *   for(String &strPart : astrParts) {
+ *     // walks the inline objects directly
+ *   }
+ */
+#include "CSmallArray.h"
+
+/* ConcurrentArray: append-only array that threads can push to and read from without locking
+ * -----------------------------------------------------------------------------------------
+ * Basic usage:
+ *   ConcurrentArray<Result> aResults;
+ *   // from any amount of threads at once:
+ *   Result &res = aResults.Push(ComputeResult());
+ *   for(INDEX i=0; i<aResults.Count(); i++) {
+ *     // everything below Count() is ready, and never moves
+ *   }
+ */
+#include "CConcurrentArray.h"
+
 /* Dictionary: high level table management
  * ---------------------------------------
  * Basic usage:
@@ -126,6 +278,18 @@
  */
 #include "CMutex.h"
 
+/* ThreadPool: threads that split a range of work between them
+ * -----------------------------------------------------------
+ * Basic usage:
+ *   ThreadPool::Global().For(ctPixels, 4096, [&](INDEX iStart, INDEX iEnd) {
+ *     // called once for every chunk of at most 4096 pixels, on any thread
+ *   });
+ *   INDEX ctExpired = saParallelCount(aSessions, [](Session &s) { return s.IsExpired(); });
+ *   INDEX iFirst = saParallelFindAny(aSessions, [](Session &s) { return s.IsExpired(); });
+ */
+#include "CThreadPool.h"
+#include "StackArrayParallel.h"
+
 /* Exception: high level exception management
  * ------------------------------------------
  * Basic usage:
@@ -0,0 +1,212 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_STACKARRAYPARALLEL_CPP_INCLUDED
+#define SCRATCH_STACKARRAYPARALLEL_CPP_INCLUDED
+
+#include "StackArrayParallel.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new> // for bad_alloc
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/// Call the function for every object, spread over the threads of the pool
+template<class Type, typename Func>
+void saParallelForEach(StackArray<Type> &aItems, Func f, INDEX ctGrain, ThreadPool &pool)
+{
+  Type** pItems = aItems.sa_pItems;
+  pool.For(aItems.sa_ctUsed, ctGrain, [pItems, &f](INDEX iStart, INDEX iEnd) {
+    for(INDEX i=iStart; i<iEnd; i++) {
+      f(*pItems[i]);
+    }
+  });
+}
+
+/// Find the lowest index of the given condition, or -1 if none of the objects match
+template<class Type, typename Func>
+INDEX saParallelFindAny(StackArray<Type> &aItems, Func f, INDEX ctGrain, ThreadPool &pool)
+{
+  // chunks after the lowest index found so far don't need testing anymore
+  std::atomic<INDEX> iFound(aItems.sa_ctUsed);
+  Type** pItems = aItems.sa_pItems;
+  pool.For(aItems.sa_ctUsed, ctGrain, [pItems, &f, &iFound](INDEX iStart, INDEX iEnd) {
+    for(INDEX i=iStart; i<iEnd && i<iFound.load(std::memory_order_relaxed); i++) {
+      if(f(*pItems[i])) {
+        INDEX iLowest = iFound.load();
+        while(i < iLowest && !iFound.compare_exchange_weak(iLowest, i)) {
+        }
+        return;
+      }
+    }
+  });
+
+  if(iFound == aItems.sa_ctUsed) {
+    return -1;
+  }
+  return iFound;
+}
+
+/// Count the objects the given condition holds for
+template<class Type, typename Func>
+INDEX saParallelCount(StackArray<Type> &aItems, Func f, INDEX ctGrain, ThreadPool &pool)
+{
+  std::atomic<INDEX> ctFound(0);
+  Type** pItems = aItems.sa_pItems;
+  pool.For(aItems.sa_ctUsed, ctGrain, [pItems, &f, &ctFound](INDEX iStart, INDEX iEnd) {
+    // count locally, so threads only touch the total once per chunk
+    INDEX ct = 0;
+    for(INDEX i=iStart; i<iEnd; i++) {
+      if(f(*pItems[i])) {
+        ct++;
+      }
+    }
+    ctFound += ct;
+  });
+  return ctFound;
+}
+
+/// Replace the contents of the result stack with what the function returns for every object, in the same order
+template<class Type, class TResult, typename Func>
+void saParallelTransform(StackArray<Type> &aItems, StackArray<TResult> &aResult, Func f, INDEX ctGrain, ThreadPool &pool)
+{
+  ASSERT((void*)&aResult != (void*)&aItems);
+
+  // every thread fills in its own part of the slots
+  aResult.Clear();
+  aResult.Reserve(aItems.sa_ctUsed);
+  Type** pItems = aItems.sa_pItems;
+  TResult** pResults = aResult.sa_pItems;
+  pool.For(aItems.sa_ctUsed, ctGrain, [pItems, pResults, &f](INDEX iStart, INDEX iEnd) {
+    for(INDEX i=iStart; i<iEnd; i++) {
+      pResults[i] = new TResult(f(*pItems[i]));
+    }
+  });
+  aResult.sa_ctUsed = aItems.sa_ctUsed;
+}
+
+/// Find how many of the first iOut objects of merging two sorted runs come from the first run. Ties go to
+/// the first run like with std::merge, so pieces split at these points merge into exactly the same result.
+template<class Type, typename Func>
+INDEX saMergeSplit(Type** pFirst, INDEX ctFirst, Type** pSecond, INDEX ctSecond, INDEX iOut, Func &fLess)
+{
+  INDEX iLow = Max(iOut - ctSecond, (INDEX)0);
+  INDEX iHigh = Min(iOut, ctFirst);
+  while(iLow < iHigh) {
+    INDEX iFromFirst = (iLow + iHigh) / 2;
+    // an object of the first run that isn't after the last one taken from the second run has to be taken too
+    if(!fLess(pSecond[iOut - iFromFirst - 1], pFirst[iFromFirst])) {
+      iLow = iFromFirst + 1;
+    } else {
+      iHigh = iFromFirst;
+    }
+  }
+  return iLow;
+}
+
+/// Sort the stack on at most ctThreads threads of the pool, 0 meaning all of them
+template<class Type>
+void saParallelSort(StackArray<Type> &aItems, INDEX ctThreads, ThreadPool &pool)
+{
+  saParallelSort(aItems, [](const Type &obj1, const Type &obj2) { return obj1 < obj2; }, ctThreads, pool);
+}
+
+/// Sort the stack with the given less than function on at most ctThreads threads of the pool, 0 meaning all of them
+template<class Type, typename Func>
+void saParallelSort(StackArray<Type> &aItems, Func fLess, INDEX ctThreads, ThreadPool &pool)
+{
+  if(ctThreads <= 0) {
+    ctThreads = pool.ThreadCount();
+  }
+
+  // small stacks aren't worth splitting up
+  INDEX ctUsed = aItems.sa_ctUsed;
+  INDEX ctRuns = Min(ctThreads, ctUsed / (STACKARRAYPARALLEL_SORT_MIN / 2));
+  if(ctRuns <= 1) {
+    aItems.Sort(fLess);
+    return;
+  }
+
+  auto fLessPointers = [&fLess](const Type* p1, const Type* p2) {
+    return fLess(*p1, *p2);
+  };
+
+  // split the stack into evenly sized runs, and sort each of them as a chunk of its own
+  INDEX* aiBounds = new INDEX[ctRuns + 1];
+  for(INDEX i=0; i<=ctRuns; i++) {
+    aiBounds[i] = (INDEX)((long long)ctUsed * i / ctRuns);
+  }
+  Type** pItems = aItems.sa_pItems;
+  pool.For(ctRuns, 1, [pItems, aiBounds, &fLessPointers](INDEX iRun, INDEX) {
+    std::sort(pItems + aiBounds[iRun], pItems + aiBounds[iRun + 1], fLessPointers);
+  }, ctThreads);
+
+  // then merge pairs of neighbouring runs, back and forth between the stack and a buffer
+  Type** pSource = pItems;
+  Type** pTarget = (Type**)malloc(sizeof(Type*) * ctUsed);
+  if(pTarget == NULL) {
+    delete[] aiBounds;
+    throw std::bad_alloc();
+  }
+  Type** pBuffer = pTarget;
+  for(INDEX ctWidth=1; ctWidth<ctRuns; ctWidth*=2) {
+    // the later passes have fewer merges than threads, so every merge is split into pieces that end up
+    // in different parts of the target and can be merged at the same time, down to the last one
+    INDEX ctMerges = (ctRuns + ctWidth * 2 - 1) / (ctWidth * 2);
+    INDEX ctPieces = (ctThreads + ctMerges - 1) / ctMerges;
+    pool.For(ctMerges * ctPieces, 1, [pSource, pTarget, aiBounds, ctRuns, ctWidth, ctPieces, &fLessPointers](INDEX iTask, INDEX) {
+      INDEX iFirst = (iTask / ctPieces) * ctWidth * 2;
+      INDEX iStart = aiBounds[iFirst];
+      INDEX iMiddle = aiBounds[Min(iFirst + ctWidth, ctRuns)];
+      INDEX iEnd = aiBounds[Min(iFirst + ctWidth * 2, ctRuns)];
+
+      INDEX iPiece = iTask % ctPieces;
+      INDEX iOutStart = (INDEX)((long long)(iEnd - iStart) * iPiece / ctPieces);
+      INDEX iOutEnd = (INDEX)((long long)(iEnd - iStart) * (iPiece + 1) / ctPieces);
+      Type** pFirst = pSource + iStart;
+      Type** pSecond = pSource + iMiddle;
+      INDEX iFirstStart = saMergeSplit(pFirst, iMiddle - iStart, pSecond, iEnd - iMiddle, iOutStart, fLessPointers);
+      INDEX iFirstEnd = saMergeSplit(pFirst, iMiddle - iStart, pSecond, iEnd - iMiddle, iOutEnd, fLessPointers);
+      std::merge(pFirst + iFirstStart, pFirst + iFirstEnd, pSecond + (iOutStart - iFirstStart), pSecond + (iOutEnd - iFirstEnd),
+        pTarget + iStart + iOutStart, fLessPointers);
+    }, ctThreads);
+    Swap(pSource, pTarget);
+  }
+
+  // the last merge may have ended up in the buffer
+  if(pSource != pItems) {
+    memcpy(pItems, pSource, sizeof(Type*) * ctUsed);
+  }
+
+  free(pBuffer);
+  delete[] aiBounds;
+}
+
+SCRATCH_NAMESPACE_END;
+
+#endif
@@ -0,0 +1,66 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_STACKARRAYPARALLEL_H_INCLUDED
+#define SCRATCH_STACKARRAYPARALLEL_H_INCLUDED
+
+#include "CStackArray.h"
+#include "CThreadPool.h"
+
+/// Stacks with fewer objects than this are always sorted on the calling thread
+#ifndef STACKARRAYPARALLEL_SORT_MIN
+#define STACKARRAYPARALLEL_SORT_MIN 16384
+#endif
+
+SCRATCH_NAMESPACE_BEGIN;
+
+// Work over every object of a StackArray, split in chunks of ctGrain objects over the threads of a
+// ThreadPool. These live outside of StackArray so only the callers that use them pull in the thread headers.
+
+/// Call the function for every object, spread over the threads of the pool
+template<class Type, typename Func>
+void saParallelForEach(StackArray<Type> &aItems, Func f, INDEX ctGrain = CTHREADPOOL_DEFAULT_GRAIN, ThreadPool &pool = ThreadPool::Global());
+/// Find the lowest index of the given condition, or -1 if none of the objects match
+template<class Type, typename Func>
+INDEX saParallelFindAny(StackArray<Type> &aItems, Func f, INDEX ctGrain = CTHREADPOOL_DEFAULT_GRAIN, ThreadPool &pool = ThreadPool::Global());
+/// Count the objects the given condition holds for
+template<class Type, typename Func>
+INDEX saParallelCount(StackArray<Type> &aItems, Func f, INDEX ctGrain = CTHREADPOOL_DEFAULT_GRAIN, ThreadPool &pool = ThreadPool::Global());
+/// Replace the contents of the result stack with what the function returns for every object, in the same order
+template<class Type, class TResult, typename Func>
+void saParallelTransform(StackArray<Type> &aItems, StackArray<TResult> &aResult, Func f, INDEX ctGrain = CTHREADPOOL_DEFAULT_GRAIN, ThreadPool &pool = ThreadPool::Global());
+/// Sort the stack on at most ctThreads threads of the pool, 0 meaning all of them
+template<class Type>
+void saParallelSort(StackArray<Type> &aItems, INDEX ctThreads = 0, ThreadPool &pool = ThreadPool::Global());
+/// Sort the stack with the given less than function on at most ctThreads threads of the pool, 0 meaning all of them
+template<class Type, typename Func>
+void saParallelSort(StackArray<Type> &aItems, Func fLess, INDEX ctThreads = 0, ThreadPool &pool = ThreadPool::Global());
+
+SCRATCH_NAMESPACE_END;
+
+#include "StackArrayParallel.cpp"
+
+#endif // include once check
@@ -0,0 +1,618 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring> // for memcpy and memset
+#include <cstdlib> // for strtod_l and strtof_l
+#include <stdint.h>
+#include <locale.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+
+#include "StringConvert.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+static const char g_acDigitPairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+static const uint64_t g_aulPow10[] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+  1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+  100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+  1000000000000000000ULL, 10000000000000000000ULL,
+};
+
+static int CountDigits(uint64_t ul)
+{
+  int ctDigits = 1;
+  for(;;) {
+    if(ul < 10) {
+      return ctDigits;
+    }
+    if(ul < 100) {
+      return ctDigits + 1;
+    }
+    if(ul < 1000) {
+      return ctDigits + 2;
+    }
+    if(ul < 10000) {
+      return ctDigits + 3;
+    }
+    ul /= 10000;
+    ctDigits += 4;
+  }
+}
+
+int strFromUInt(char* szDst, unsigned long long ulValue)
+{
+  int ctDigits = CountDigits(ulValue);
+
+  // Write two digits at a time from back to front
+  char* p = szDst + ctDigits;
+  while(ulValue >= 100) {
+    int i = (int)(ulValue % 100) * 2;
+    ulValue /= 100;
+    p -= 2;
+    p[0] = g_acDigitPairs[i];
+    p[1] = g_acDigitPairs[i + 1];
+  }
+  if(ulValue >= 10) {
+    int i = (int)ulValue * 2;
+    p[-2] = g_acDigitPairs[i];
+    p[-1] = g_acDigitPairs[i + 1];
+  } else {
+    p[-1] = (char)('0' + ulValue);
+  }
+
+  return ctDigits;
+}
+
+int strFromInt(char* szDst, long long iValue)
+{
+  if(iValue < 0) {
+    *szDst = '-';
+    // Negate as unsigned, so the most negative value works too
+    return 1 + strFromUInt(szDst + 1, 0ULL - (unsigned long long)iValue);
+  }
+  return strFromUInt(szDst, (unsigned long long)iValue);
+}
+
+int strFromHex(char* szDst, unsigned long long ulValue)
+{
+  static const char acHexDigits[] = "0123456789abcdef";
+
+  int ctDigits = 1;
+  while(ctDigits < 16 && (ulValue >> (ctDigits * 4)) != 0) {
+    ctDigits++;
+  }
+  for(int i=ctDigits-1; i>=0; i--) {
+    szDst[i] = acHexDigits[ulValue & 0xF];
+    ulValue >>= 4;
+  }
+  return ctDigits;
+}
+
+/* Floating point numbers are formatted with Grisu2 (Florian Loitsch, "Printing Floating-Point
+ * Numbers Quickly and Accurately with Integers"). Its output always parses back to exactly the
+ * same value, and is the shortest representation that does so for all but a tiny fraction of
+ * inputs, which get one digit more than strictly needed.
+ */
+
+// A floating point number f * 2^e with a 64 bit significand
+struct DiyFp
+{
+  uint64_t f;
+  int e;
+};
+
+// Normalized powers of ten from 10^-348 to 10^340 in steps of 8
+static const uint64_t g_aulCachedPowersF[] = {
+  0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+  0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+  0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+  0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+  0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+  0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+  0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+  0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+  0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+  0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+  0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+  0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+  0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+  0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+  0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+  0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+  0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+  0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+  0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+  0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+  0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+  0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+  0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+  0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+  0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+  0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+  0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+  0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+  0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+
+static const short g_aiCachedPowersE[] = {
+  -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+  -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+  -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+  -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+  -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+  109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+  375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+  641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+  907, 933, 960, 986, 1013, 1039, 1066,
+};
+
+static inline DiyFp DiyFpMake(uint64_t f, int e)
+{
+  DiyFp ret = { f, e };
+  return ret;
+}
+
+static inline DiyFp DiyFpNormalize(DiyFp v)
+{
+  while((v.f & (1ULL << 63)) == 0) {
+    v.f <<= 1;
+    v.e--;
+  }
+  return v;
+}
+
+static inline DiyFp DiyFpMultiply(const DiyFp &a, const DiyFp &b)
+{
+  // 64x64 bit multiplication keeping the upper 64 bits, rounded
+  const uint64_t M32 = 0xFFFFFFFFULL;
+  uint64_t ulA = a.f >> 32;
+  uint64_t ulB = a.f & M32;
+  uint64_t ulC = b.f >> 32;
+  uint64_t ulD = b.f & M32;
+  uint64_t ulAC = ulA * ulC;
+  uint64_t ulBC = ulB * ulC;
+  uint64_t ulAD = ulA * ulD;
+  uint64_t ulBD = ulB * ulD;
+  uint64_t ulTmp = (ulBD >> 32) + (ulAD & M32) + (ulBC & M32) + (1ULL << 31);
+  return DiyFpMake(ulAC + (ulAD >> 32) + (ulBC >> 32) + (ulTmp >> 32), a.e + b.e + 64);
+}
+
+static DiyFp GetCachedPower(int e, int &iK)
+{
+  // Pick the power of ten that brings the binary exponent into the range DigitGen works with
+  double dk = (-61 - e) * 0.30102999566398114 + 347;
+  int k = (int)dk;
+  if(dk - k > 0.0) {
+    k++;
+  }
+  int iIndex = (k >> 3) + 1;
+  iK = -(-348 + iIndex * 8);
+  return DiyFpMake(g_aulCachedPowersF[iIndex], g_aiCachedPowersE[iIndex]);
+}
+
+static void GrisuRound(char* szDigits, int iLen, uint64_t ulDelta, uint64_t ulRest, uint64_t ulTenKappa, uint64_t ulDistance)
+{
+  // Move the last digit closer to the exact value while staying inside the rounding interval
+  while(ulRest < ulDistance && ulDelta - ulRest >= ulTenKappa &&
+    (ulRest + ulTenKappa < ulDistance || ulDistance - ulRest > ulRest + ulTenKappa - ulDistance)) {
+    szDigits[iLen - 1]--;
+    ulRest += ulTenKappa;
+  }
+}
+
+static int DigitGen(const DiyFp &W, const DiyFp &Mp, uint64_t ulDelta, char* szDigits, int &iK)
+{
+  const DiyFp one = DiyFpMake(1ULL << -Mp.e, Mp.e);
+  uint64_t ulDistance = Mp.f - W.f;
+  uint32_t ulIntegral = (uint32_t)(Mp.f >> -one.e);
+  uint64_t ulFraction = Mp.f & (one.f - 1);
+  int iKappa = CountDigits(ulIntegral);
+  int iLen = 0;
+
+  // Digits of the integral part
+  while(iKappa > 0) {
+    uint32_t ulDivisor = (uint32_t)g_aulPow10[iKappa - 1];
+    uint32_t ulDigit = ulIntegral / ulDivisor;
+    ulIntegral %= ulDivisor;
+    if(ulDigit != 0 || iLen != 0) {
+      szDigits[iLen++] = (char)('0' + ulDigit);
+    }
+    iKappa--;
+    uint64_t ulRest = ((uint64_t)ulIntegral << -one.e) + ulFraction;
+    if(ulRest <= ulDelta) {
+      iK += iKappa;
+      GrisuRound(szDigits, iLen, ulDelta, ulRest, g_aulPow10[iKappa] << -one.e, ulDistance);
+      return iLen;
+    }
+  }
+
+  // Digits of the fractional part
+  for(;;) {
+    ulFraction *= 10;
+    ulDelta *= 10;
+    char cDigit = (char)(ulFraction >> -one.e);
+    if(cDigit != 0 || iLen != 0) {
+      szDigits[iLen++] = (char)('0' + cDigit);
+    }
+    ulFraction &= one.f - 1;
+    iKappa--;
+    if(ulFraction < ulDelta) {
+      iK += iKappa;
+      GrisuRound(szDigits, iLen, ulDelta, ulFraction, one.f, ulDistance * (-iKappa < 20 ? g_aulPow10[-iKappa] : 0));
+      return iLen;
+    }
+  }
+}
+
+// Generate the shortest digits for f * 2^e, so that the value is szDigits * 10^iK. The value halfway
+// to the next representable number below is closer when f is an exact power of two.
+static int Grisu2(uint64_t f, int e, bool bLowerCloser, char* szDigits, int &iK)
+{
+  DiyFp mPlus = DiyFpNormalize(DiyFpMake((f << 1) + 1, e - 1));
+  DiyFp mMinus = bLowerCloser ? DiyFpMake((f << 2) - 1, e - 2) : DiyFpMake((f << 1) - 1, e - 1);
+  mMinus.f <<= mMinus.e - mPlus.e;
+  mMinus.e = mPlus.e;
+
+  DiyFp cached = GetCachedPower(mPlus.e, iK);
+  DiyFp W = DiyFpMultiply(DiyFpNormalize(DiyFpMake(f, e)), cached);
+  DiyFp Wp = DiyFpMultiply(mPlus, cached);
+  DiyFp Wm = DiyFpMultiply(mMinus, cached);
+  Wm.f++;
+  Wp.f--;
+  return DigitGen(W, Wp, Wp.f - Wm.f, szDigits, iK);
+}
+
+// Lay out the digits of szDigits * 10^iK like 123, 1.23, 0.00123 or 1.23e+30
+static int FormatDigits(char* szDst, const char* szDigits, int iLen, int iK)
+{
+  int iPoint = iLen + iK;
+
+  if(iK >= 0 && iPoint <= 21) {
+    // 123e2 -> 12300
+    memcpy(szDst, szDigits, iLen);
+    memset(szDst + iLen, '0', iK);
+    return iPoint;
+  }
+
+  if(iPoint > 0 && iPoint <= 21) {
+    // 123e-2 -> 1.23
+    memcpy(szDst, szDigits, iPoint);
+    szDst[iPoint] = '.';
+    memcpy(szDst + iPoint + 1, szDigits + iPoint, iLen - iPoint);
+    return iLen + 1;
+  }
+
+  if(iPoint > -6 && iPoint <= 0) {
+    // 123e-5 -> 0.00123
+    szDst[0] = '0';
+    szDst[1] = '.';
+    memset(szDst + 2, '0', -iPoint);
+    memcpy(szDst + 2 - iPoint, szDigits, iLen);
+    return 2 - iPoint + iLen;
+  }
+
+  // 123e28 -> 1.23e+30
+  int ctChars = 1;
+  szDst[0] = szDigits[0];
+  if(iLen > 1) {
+    szDst[1] = '.';
+    memcpy(szDst + 2, szDigits + 1, iLen - 1);
+    ctChars = iLen + 1;
+  }
+  int iExp = iPoint - 1;
+  szDst[ctChars++] = 'e';
+  szDst[ctChars++] = iExp < 0 ? '-' : '+';
+  return ctChars + strFromUInt(szDst + ctChars, iExp < 0 ? -iExp : iExp);
+}
+
+// Format a number with the given bits, significand size and exponent bias
+static int FormatFloatingPoint(char* szDst, uint64_t ulBits, int ctSignificandBits, int iExpBits)
+{
+  const uint64_t ulSignificandMask = (1ULL << ctSignificandBits) - 1;
+  const int iExpMax = (1 << iExpBits) - 1;
+  const int iExpBias = (iExpMax >> 1) + ctSignificandBits;
+
+  uint64_t ulSignificand = ulBits & ulSignificandMask;
+  int iBiasedExp = (int)((ulBits >> ctSignificandBits) & iExpMax);
+  bool bNegative = ((ulBits >> (ctSignificandBits + iExpBits)) & 1) != 0;
+
+  if(iBiasedExp == iExpMax) {
+    if(ulSignificand != 0) {
+      memcpy(szDst, "nan", 3);
+      return 3;
+    }
+    if(bNegative) {
+      memcpy(szDst, "-inf", 4);
+      return 4;
+    }
+    memcpy(szDst, "inf", 3);
+    return 3;
+  }
+
+  char* p = szDst;
+  if(bNegative) {
+    *p++ = '-';
+  }
+
+  if(iBiasedExp == 0 && ulSignificand == 0) {
+    *p++ = '0';
+    return p - szDst;
+  }
+
+  uint64_t f;
+  int e;
+  if(iBiasedExp != 0) {
+    f = ulSignificand | (1ULL << ctSignificandBits);
+    e = iBiasedExp - iExpBias;
+  } else {
+    // Denormals
+    f = ulSignificand;
+    e = 1 - iExpBias;
+  }
+
+  char acDigits[20];
+  int iK;
+  int iLen = Grisu2(f, e, ulSignificand == 0 && iBiasedExp > 1, acDigits, iK);
+  return (p - szDst) + FormatDigits(p, acDigits, iLen, iK);
+}
+
+int strFromFloat(char* szDst, float fValue)
+{
+  uint32_t ulBits;
+  memcpy(&ulBits, &fValue, sizeof(ulBits));
+  return FormatFloatingPoint(szDst, ulBits, 23, 8);
+}
+
+int strFromDouble(char* szDst, double dValue)
+{
+  uint64_t ulBits;
+  memcpy(&ulBits, &dValue, sizeof(ulBits));
+  return FormatFloatingPoint(szDst, ulBits, 52, 11);
+}
+
+bool strToInt(const char* sz, int iLen, long long &iValue)
+{
+  int i = 0;
+  bool bNegative = false;
+  if(i < iLen && (sz[i] == '-' || sz[i] == '+')) {
+    bNegative = sz[i] == '-';
+    i++;
+  }
+  if(i == iLen) {
+    return false;
+  }
+
+  uint64_t ulValue = 0;
+  for(; i<iLen; i++) {
+    unsigned int iDigit = (unsigned int)(sz[i] - '0');
+    if(iDigit > 9) {
+      return false;
+    }
+    // Check for overflow before it happens
+    if(ulValue > (UINT64_MAX - iDigit) / 10) {
+      return false;
+    }
+    ulValue = ulValue * 10 + iDigit;
+  }
+
+  if(bNegative) {
+    if(ulValue > (uint64_t)INT64_MAX + 1) {
+      return false;
+    }
+    iValue = ulValue == 0 ? 0 : -(long long)(ulValue - 1) - 1;
+  } else {
+    if(ulValue > (uint64_t)INT64_MAX) {
+      return false;
+    }
+    iValue = (long long)ulValue;
+  }
+  return true;
+}
+
+// Check the syntax of a decimal number and collect its first 19 significant digits, so that
+// the number is ulMantissa * 10^iExp10. bExact is false when digits had to be left out.
+static bool ScanDecimal(const char* sz, int iLen, bool &bNegative, uint64_t &ulMantissa, int &iExp10, bool &bExact)
+{
+  int i = 0;
+  int ctDigits = 0;
+  int ctSignificant = 0;
+  bNegative = false;
+  ulMantissa = 0;
+  iExp10 = 0;
+  bExact = true;
+
+  if(i < iLen && (sz[i] == '-' || sz[i] == '+')) {
+    bNegative = sz[i] == '-';
+    i++;
+  }
+
+  // Integral part
+  for(; i<iLen && sz[i] >= '0' && sz[i] <= '9'; i++) {
+    int iDigit = sz[i] - '0';
+    ctDigits++;
+    if(ctSignificant < 19) {
+      ulMantissa = ulMantissa * 10 + iDigit;
+      if(ulMantissa != 0) {
+        ctSignificant++;
+      }
+    } else {
+      bExact = bExact && iDigit == 0;
+      iExp10++;
+    }
+  }
+
+  // Fractional part
+  if(i < iLen && sz[i] == '.') {
+    for(i++; i<iLen && sz[i] >= '0' && sz[i] <= '9'; i++) {
+      int iDigit = sz[i] - '0';
+      ctDigits++;
+      if(ctSignificant < 19) {
+        ulMantissa = ulMantissa * 10 + iDigit;
+        if(ulMantissa != 0) {
+          ctSignificant++;
+        }
+        iExp10--;
+      } else {
+        bExact = bExact && iDigit == 0;
+      }
+    }
+  }
+
+  if(ctDigits == 0) {
+    return false;
+  }
+
+  // Exponent
+  if(i < iLen && (sz[i] == 'e' || sz[i] == 'E')) {
+    i++;
+    bool bNegativeExp = false;
+    if(i < iLen && (sz[i] == '-' || sz[i] == '+')) {
+      bNegativeExp = sz[i] == '-';
+      i++;
+    }
+    int iExp = 0;
+    int ctExpDigits = 0;
+    for(; i<iLen && sz[i] >= '0' && sz[i] <= '9'; i++) {
+      // Anything this big is out of range anyway, just don't overflow
+      if(iExp < 100000) {
+        iExp = iExp * 10 + (sz[i] - '0');
+      }
+      ctExpDigits++;
+    }
+    if(ctExpDigits == 0) {
+      return false;
+    }
+    iExp10 += bNegativeExp ? -iExp : iExp;
+  }
+
+  return i == iLen;
+}
+
+#ifdef _MSC_VER
+typedef _locale_t CLocale;
+#define strtof_l _strtof_l
+#define strtod_l _strtod_l
+#else
+typedef locale_t CLocale;
+#endif
+
+// The "C" locale, so the library always expects a '.' no matter what setlocale was called with
+static CLocale GetCLocale()
+{
+#ifdef _MSC_VER
+  static CLocale _locC = _create_locale(LC_ALL, "C");
+#else
+  static CLocale _locC = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+#endif
+  return _locC;
+}
+
+// Hand the hard cases to the C library, which rounds correctly but needs a null terminator
+template<typename Type, typename Func>
+static bool ParseWithLibrary(const char* sz, int iLen, Type &value, Func f)
+{
+  char acBuffer[128];
+  char* szCopy = iLen < (int)sizeof(acBuffer) ? acBuffer : new char[iLen + 1];
+  memcpy(szCopy, sz, iLen);
+  szCopy[iLen] = '\0';
+  char* szEnd = NULL;
+  value = f(szCopy, &szEnd, GetCLocale());
+  bool bComplete = szEnd == szCopy + iLen;
+  if(szCopy != acBuffer) {
+    delete[] szCopy;
+  }
+  // Numbers too big to be represented come back as infinity
+  return bComplete && value - value == 0;
+}
+
+bool strToFloat(const char* sz, int iLen, float &fValue)
+{
+  static const float afPow10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+  bool bNegative;
+  uint64_t ulMantissa;
+  int iExp10;
+  bool bExact;
+  if(!ScanDecimal(sz, iLen, bNegative, ulMantissa, iExp10, bExact)) {
+    return false;
+  }
+
+  // Both the mantissa and the power of ten are exact floats, so a single operation rounds correctly
+  if(bExact && ulMantissa <= (1ULL << 24) && iExp10 >= -10 && iExp10 <= 10) {
+    float f = (float)ulMantissa;
+    f = iExp10 < 0 ? f / afPow10[-iExp10] : f * afPow10[iExp10];
+    fValue = bNegative ? -f : f;
+    return true;
+  }
+
+  return ParseWithLibrary(sz, iLen, fValue, [](const char* szNumber, char** pszEnd, CLocale loc) {
+    return strtof_l(szNumber, pszEnd, loc);
+  });
+}
+
+bool strToDouble(const char* sz, int iLen, double &dValue)
+{
+  static const double adPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+  };
+
+  bool bNegative;
+  uint64_t ulMantissa;
+  int iExp10;
+  bool bExact;
+  if(!ScanDecimal(sz, iLen, bNegative, ulMantissa, iExp10, bExact)) {
+    return false;
+  }
+
+  // Both the mantissa and the power of ten are exact doubles, so a single operation rounds correctly
+  if(bExact && ulMantissa <= (1ULL << 53) && iExp10 >= -22 && iExp10 <= 22) {
+    double d = (double)ulMantissa;
+    d = iExp10 < 0 ? d / adPow10[-iExp10] : d * adPow10[iExp10];
+    dValue = bNegative ? -d : d;
+    return true;
+  }
+
+  return ParseWithLibrary(sz, iLen, dValue, [](const char* szNumber, char** pszEnd, CLocale loc) {
+    return strtod_l(szNumber, pszEnd, loc);
+  });
+}
+
+SCRATCH_NAMESPACE_END;
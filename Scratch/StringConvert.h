@@ -0,0 +1,64 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_STRINGCONVERT_H_INCLUDED
+#define SCRATCH_STRINGCONVERT_H_INCLUDED
+
+#include "Common.h"
+
+// The most characters any of the strFrom functions will ever write.
+#define STRINGCONVERT_MAX_CHARS 32
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/* Number conversion used by String. The strFrom functions write into a buffer of at
+ * least STRINGCONVERT_MAX_CHARS characters without a null terminator, and return the
+ * amount of characters written. The strTo functions parse exactly iLen characters and
+ * return false when those aren't a valid number, or when the number doesn't fit.
+ * None of them allocate memory.
+ */
+
+/// Write a signed integer in decimal
+int SCRATCH_EXPORT strFromInt(char* szDst, long long iValue);
+/// Write an unsigned integer in decimal
+int SCRATCH_EXPORT strFromUInt(char* szDst, unsigned long long ulValue);
+/// Write an unsigned integer in lowercase hexadecimal, without a prefix
+int SCRATCH_EXPORT strFromHex(char* szDst, unsigned long long ulValue);
+/// Write the shortest decimal representation that parses back to exactly the same float
+int SCRATCH_EXPORT strFromFloat(char* szDst, float fValue);
+/// Write the shortest decimal representation that parses back to exactly the same double
+int SCRATCH_EXPORT strFromDouble(char* szDst, double dValue);
+
+/// Parse a decimal integer with an optional sign
+bool SCRATCH_EXPORT strToInt(const char* sz, int iLen, long long &iValue);
+/// Parse a decimal number with an optional sign, fraction and exponent
+bool SCRATCH_EXPORT strToFloat(const char* sz, int iLen, float &fValue);
+/// Parse a decimal number with an optional sign, fraction and exponent
+bool SCRATCH_EXPORT strToDouble(const char* sz, int iLen, double &dValue);
+
+SCRATCH_NAMESPACE_END;
+
+#endif // include once check
@@ -0,0 +1,189 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_STRINGFORMAT_H_INCLUDED
+#define SCRATCH_STRINGFORMAT_H_INCLUDED
+
+#include <cstring> // for strlen
+#include <type_traits>
+
+#include "Common.h"
+#include "CStringView.h"
+#include "StringConvert.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+class String;
+
+/* Type safe formatting used by String::Format and the SCRATCH_FORMAT macros. Placeholders are printf style:
+ *   %d %i %u %x %X %c %s %f %g %e, and %% for a percent sign,
+ * with optional - (align left) and 0 (pad with zeros) flags, a width and a .precision.
+ * The h, l, ll and z length modifiers are accepted and ignored, because every argument
+ * is written according to its actual type. Floating point placeholders without a
+ * precision write the shortest form that reads back as the same value.
+ *
+ * Only the SCRATCH_FORMAT and SCRATCH_APPEND_FORMAT macros check the placeholders against
+ * the argument types at compile time, turning a mismatch into a compile error. C++11 can't
+ * see that a function parameter is a constant expression, so String::Format, AppendFormat
+ * and strFormat called directly parse the format string at runtime only: arguments are still
+ * written according to their actual type, but a wrong placeholder isn't reported, surplus
+ * arguments are dropped and so are placeholders left without an argument.
+ */
+
+enum EFormatArgKind {
+  EFAK_UNSUPPORTED,
+  EFAK_INT,
+  EFAK_UINT,
+  EFAK_FLOAT,
+  EFAK_CHAR,
+  EFAK_STRING,
+};
+
+/// Describes how an argument of type T is checked and which type it's written as
+template<typename T>
+struct FormatArg
+{
+  static const EFormatArgKind Kind =
+    std::is_same<T, char>::value ? EFAK_CHAR :
+    std::is_same<T, bool>::value ? EFAK_UINT :
+    std::is_floating_point<T>::value ? EFAK_FLOAT :
+    std::is_enum<T>::value ? EFAK_INT :
+    std::is_integral<T>::value ? (std::is_signed<T>::value ? EFAK_INT : EFAK_UINT) :
+    EFAK_UNSUPPORTED;
+
+  typedef typename std::conditional<Kind == EFAK_CHAR, char,
+    typename std::conditional<Kind == EFAK_INT, long long,
+    typename std::conditional<Kind == EFAK_UINT, unsigned long long,
+    typename std::conditional<std::is_same<T, float>::value, float,
+    typename std::conditional<Kind == EFAK_FLOAT, double,
+    T>::type>::type>::type>::type>::type Type;
+};
+
+template<> struct FormatArg<const char*> { static const EFormatArgKind Kind = EFAK_STRING; typedef StringView Type; };
+template<> struct FormatArg<char*> { static const EFormatArgKind Kind = EFAK_STRING; typedef StringView Type; };
+template<> struct FormatArg<StringView> { static const EFormatArgKind Kind = EFAK_STRING; typedef StringView Type; };
+template<> struct FormatArg<String> { static const EFormatArgKind Kind = EFAK_STRING; typedef StringView Type; };
+
+/// A parsed placeholder
+struct FormatSpec
+{
+  char fs_cType;
+  bool fs_bLeftAlign;
+  bool fs_bZeroPad;
+  int fs_iWidth;
+  int fs_iPrecision; // -1 when not given
+  int fs_iArgSize; // size of the argument in bytes, so negative numbers are written in hex like printf does
+};
+
+/// How many characters an argument is expected to need, used to reserve room up front
+inline int strFormatSizeHint(const StringView &strValue) { return strValue.Length(); }
+template<typename T>
+inline int strFormatSizeHint(const T &) { return STRINGCONVERT_MAX_CHARS; }
+
+/// Whether an argument points into the given range of characters
+inline bool strFormatPointsInto(const char* szBegin, const char* szEnd, const StringView &strValue)
+{
+  return strValue.Data() >= szBegin && strValue.Data() <= szEnd;
+}
+template<typename T>
+inline bool strFormatPointsInto(const char*, const char*, const T &) { return false; }
+
+// The constexpr functions below follow the exact grammar of String::AppendFormatLiteral.
+constexpr const char* strFormatSkipFlags(const char* sz) { return (*sz == '-' || *sz == '0') ? strFormatSkipFlags(sz + 1) : sz; }
+constexpr const char* strFormatSkipDigits(const char* sz) { return (*sz >= '0' && *sz <= '9') ? strFormatSkipDigits(sz + 1) : sz; }
+constexpr const char* strFormatSkipPrecision(const char* sz) { return *sz == '.' ? strFormatSkipDigits(sz + 1) : sz; }
+constexpr const char* strFormatSkipModifiers(const char* sz) { return (*sz == 'h' || *sz == 'l' || *sz == 'z') ? strFormatSkipModifiers(sz + 1) : sz; }
+constexpr const char* strFormatSkipSpec(const char* sz)
+{
+  return strFormatSkipModifiers(strFormatSkipPrecision(strFormatSkipDigits(strFormatSkipFlags(sz))));
+}
+
+/// Whether the placeholder type character accepts an argument of the given kind
+constexpr bool strFormatAccepts(char cType, EFormatArgKind efak)
+{
+  return (cType == 'd' || cType == 'i' || cType == 'u' || cType == 'x' || cType == 'X') ? (efak == EFAK_INT || efak == EFAK_UINT || efak == EFAK_CHAR) :
+         (cType == 'f' || cType == 'g' || cType == 'e') ? efak == EFAK_FLOAT :
+         cType == 'c' ? (efak == EFAK_CHAR || efak == EFAK_INT) :
+         cType == 's' ? efak == EFAK_STRING :
+         false;
+}
+
+/// Checks a format string against a list of argument types at compile time
+template<typename... Args>
+struct FormatChecker;
+
+template<>
+struct FormatChecker<>
+{
+  /// Only literal text and %% may remain
+  static constexpr bool Check(const char* sz)
+  {
+    return *sz == '\0' ? true :
+           *sz != '%' ? Check(sz + 1) :
+           sz[1] == '%' ? Check(sz + 2) :
+           false;
+  }
+};
+
+template<typename T, typename... Rest>
+struct FormatChecker<T, Rest...>
+{
+  /// The first placeholder has to accept T, the rest of the string is checked against Rest
+  static constexpr bool Check(const char* sz)
+  {
+    return *sz == '\0' ? false :
+           *sz != '%' ? Check(sz + 1) :
+           sz[1] == '%' ? Check(sz + 2) :
+           strFormatAccepts(*strFormatSkipSpec(sz + 1), FormatArg<T>::Kind) && FormatChecker<Rest...>::Check(strFormatSkipSpec(sz + 1) + 1);
+  }
+};
+
+/// Only used in decltype, to deduce the checker for the arguments after a format string
+template<typename... Args>
+FormatChecker<typename std::decay<Args>::type...> strFormatCheckerFor(const char* szFormat, const Args &...);
+
+template<bool bValid>
+struct FormatValidate
+{
+  static_assert(bValid, "Format string doesn't match the types of the arguments");
+};
+
+SCRATCH_NAMESPACE_END;
+
+/// The format string out of the arguments of the macros below, which pass an extra one so there's always a rest
+#define SCRATCH_FORMAT_STRING(szFormat, ...) szFormat
+
+/// Format into a new String, rejecting a format string that doesn't match the arguments at compile time
+#define SCRATCH_FORMAT(...) \
+  ((void)Scratch::FormatValidate<decltype(Scratch::strFormatCheckerFor(__VA_ARGS__))::Check(SCRATCH_FORMAT_STRING(__VA_ARGS__, 0))>(), \
+    Scratch::strFormat(__VA_ARGS__))
+
+/// Append to an existing String, rejecting a format string that doesn't match the arguments at compile time
+#define SCRATCH_APPEND_FORMAT(str, ...) \
+  ((void)Scratch::FormatValidate<decltype(Scratch::strFormatCheckerFor(__VA_ARGS__))::Check(SCRATCH_FORMAT_STRING(__VA_ARGS__, 0))>(), \
+    (str).AppendFormat(__VA_ARGS__))
+
+#endif // include once check
@@ -0,0 +1,669 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring> // for memchr and memcmp
+
+#include "StringSearch.h"
+
+// SIMD kernels are only built for x86-64, where SSE2 is always available
+// and AVX2 can be checked for at runtime.
+#if !defined(SCRATCH_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define STRINGSEARCH_SIMD 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define STRINGSEARCH_TARGET_AVX2
+#else
+#define STRINGSEARCH_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define STRINGSEARCH_SIMD 0
+#endif
+
+SCRATCH_NAMESPACE_BEGIN;
+
+// Scalar kernels, used for short tails and on CPUs without SIMD support
+
+static const char* FindChar_Scalar(const char* sz, int iLen, char c)
+{
+  return (const char*)memchr(sz, c, iLen);
+}
+
+static const char* FindCharLast_Scalar(const char* sz, int iLen, char c)
+{
+  for(int i=iLen-1; i>=0; i--) {
+    if(sz[i] == c) {
+      return sz + i;
+    }
+  }
+  return NULL;
+}
+
+static const char* Find_Scalar(const char* sz, int iLen, const char* szNeedle, int iNeedleLen)
+{
+  // The needle can only start this far in
+  const char* szOffset = sz;
+  const char* szLast = sz + iLen - iNeedleLen;
+
+  while(szOffset <= szLast) {
+    // Find the next candidate for the first character of the needle
+    szOffset = (const char*)memchr(szOffset, szNeedle[0], szLast - szOffset + 1);
+    if(szOffset == NULL) {
+      break;
+    }
+
+    // Then compare the rest
+    if(!memcmp(szOffset + 1, szNeedle + 1, iNeedleLen - 1)) {
+      return szOffset;
+    }
+    szOffset++;
+  }
+  return NULL;
+}
+
+static const char* FindLast_Scalar(const char* sz, int iLen, const char* szNeedle, int iNeedleLen)
+{
+  for(int i=iLen-iNeedleLen; i>=0; i--) {
+    if(sz[i] == szNeedle[0] && !memcmp(sz + i + 1, szNeedle + 1, iNeedleLen - 1)) {
+      return sz + i;
+    }
+  }
+  return NULL;
+}
+
+static inline char LowerChar(char c)
+{
+  return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+static inline char UpperChar(char c)
+{
+  return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+static void ToLower_Scalar(char* szDst, const char* szSrc, int iLen)
+{
+  for(int i=0; i<iLen; i++) {
+    szDst[i] = LowerChar(szSrc[i]);
+  }
+}
+
+static void ToUpper_Scalar(char* szDst, const char* szSrc, int iLen)
+{
+  for(int i=0; i<iLen; i++) {
+    szDst[i] = UpperChar(szSrc[i]);
+  }
+}
+
+static int MismatchIgnoreCase_Scalar(const char* sz1, const char* sz2, int iLen)
+{
+  for(int i=0; i<iLen; i++) {
+    if(LowerChar(sz1[i]) != LowerChar(sz2[i])) {
+      return i;
+    }
+  }
+  return iLen;
+}
+
+#if STRINGSEARCH_SIMD
+
+static inline int BitScanForward32(unsigned int ulMask)
+{
+#ifdef _MSC_VER
+  unsigned long ulIndex;
+  _BitScanForward(&ulIndex, ulMask);
+  return (int)ulIndex;
+#else
+  return __builtin_ctz(ulMask);
+#endif
+}
+
+static inline int BitScanReverse32(unsigned int ulMask)
+{
+#ifdef _MSC_VER
+  unsigned long ulIndex;
+  _BitScanReverse(&ulIndex, ulMask);
+  return (int)ulIndex;
+#else
+  return 31 - __builtin_clz(ulMask);
+#endif
+}
+
+// SSE2 kernels, comparing 16 characters at a time
+
+static const char* FindChar_SSE2(const char* sz, int iLen, char c)
+{
+  const __m128i vChar = _mm_set1_epi8(c);
+
+  int i = 0;
+
+  // Check 64 characters per iteration and only find the exact position once something matched
+  for(; i + 64 <= iLen; i += 64) {
+    __m128i vMatch0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(sz + i)), vChar);
+    __m128i vMatch1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(sz + i + 16)), vChar);
+    __m128i vMatch2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(sz + i + 32)), vChar);
+    __m128i vMatch3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(sz + i + 48)), vChar);
+    __m128i vAny = _mm_or_si128(_mm_or_si128(vMatch0, vMatch1), _mm_or_si128(vMatch2, vMatch3));
+    if(_mm_movemask_epi8(vAny) != 0) {
+      break;
+    }
+  }
+
+  for(; i + 16 <= iLen; i += 16) {
+    __m128i vBlock = _mm_loadu_si128((const __m128i*)(sz + i));
+    unsigned int ulMask = _mm_movemask_epi8(_mm_cmpeq_epi8(vBlock, vChar));
+    if(ulMask != 0) {
+      return sz + i + BitScanForward32(ulMask);
+    }
+  }
+  return FindChar_Scalar(sz + i, iLen - i, c);
+}
+
+static const char* FindCharLast_SSE2(const char* sz, int iLen, char c)
+{
+  const __m128i vChar = _mm_set1_epi8(c);
+
+  int i = iLen;
+
+  // Check 64 characters per iteration and only find the exact position once something matched
+  for(; i >= 64; i -= 64) {
+    __m128i vMatch0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(sz + i - 16)), vChar);
+    __m128i vMatch1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(sz + i - 32)), vChar);
+    __m128i vMatch2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(sz + i - 48)), vChar);
+    __m128i vMatch3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(sz + i - 64)), vChar);
+    __m128i vAny = _mm_or_si128(_mm_or_si128(vMatch0, vMatch1), _mm_or_si128(vMatch2, vMatch3));
+    if(_mm_movemask_epi8(vAny) != 0) {
+      break;
+    }
+  }
+
+  for(; i >= 16; i -= 16) {
+    __m128i vBlock = _mm_loadu_si128((const __m128i*)(sz + i - 16));
+    unsigned int ulMask = _mm_movemask_epi8(_mm_cmpeq_epi8(vBlock, vChar));
+    if(ulMask != 0) {
+      return sz + i - 16 + BitScanReverse32(ulMask);
+    }
+  }
+  return FindCharLast_Scalar(sz, i, c);
+}
+
+// Compares the first and last character of the needle against 16 possible
+// starting positions at once, and only does a full compare where both match.
+static const char* Find_SSE2(const char* sz, int iLen, const char* szNeedle, int iNeedleLen)
+{
+  const __m128i vFirst = _mm_set1_epi8(szNeedle[0]);
+  const __m128i vLast = _mm_set1_epi8(szNeedle[iNeedleLen - 1]);
+
+  int i = 0;
+  for(; i + iNeedleLen - 1 + 16 <= iLen; i += 16) {
+    __m128i vBlockFirst = _mm_loadu_si128((const __m128i*)(sz + i));
+    __m128i vBlockLast = _mm_loadu_si128((const __m128i*)(sz + i + iNeedleLen - 1));
+    unsigned int ulMask = _mm_movemask_epi8(_mm_and_si128(
+      _mm_cmpeq_epi8(vBlockFirst, vFirst),
+      _mm_cmpeq_epi8(vBlockLast, vLast)));
+
+    while(ulMask != 0) {
+      int iBit = BitScanForward32(ulMask);
+      if(!memcmp(sz + i + iBit + 1, szNeedle + 1, iNeedleLen - 2)) {
+        return sz + i + iBit;
+      }
+      ulMask &= ulMask - 1;
+    }
+  }
+  return Find_Scalar(sz + i, iLen - i, szNeedle, iNeedleLen);
+}
+
+static const char* FindLast_SSE2(const char* sz, int iLen, const char* szNeedle, int iNeedleLen)
+{
+  const __m128i vFirst = _mm_set1_epi8(szNeedle[0]);
+  const __m128i vLast = _mm_set1_epi8(szNeedle[iNeedleLen - 1]);
+
+  // Candidate starting positions left to check are [0, iEnd)
+  int iEnd = iLen - iNeedleLen + 1;
+  for(; iEnd >= 16; iEnd -= 16) {
+    int iBase = iEnd - 16;
+    __m128i vBlockFirst = _mm_loadu_si128((const __m128i*)(sz + iBase));
+    __m128i vBlockLast = _mm_loadu_si128((const __m128i*)(sz + iBase + iNeedleLen - 1));
+    unsigned int ulMask = _mm_movemask_epi8(_mm_and_si128(
+      _mm_cmpeq_epi8(vBlockFirst, vFirst),
+      _mm_cmpeq_epi8(vBlockLast, vLast)));
+
+    while(ulMask != 0) {
+      int iBit = BitScanReverse32(ulMask);
+      if(!memcmp(sz + iBase + iBit + 1, szNeedle + 1, iNeedleLen - 2)) {
+        return sz + iBase + iBit;
+      }
+      ulMask &= ~(1u << iBit);
+    }
+  }
+  if(iEnd <= 0) {
+    return NULL;
+  }
+  return FindLast_Scalar(sz, iEnd + iNeedleLen - 1, szNeedle, iNeedleLen);
+}
+
+
+// Letters are folded by adding or removing the 0x20 bit on bytes in the A-Z or a-z range. Bytes
+// of 0x80 and up are negative as signed characters, so they never fall in either range.
+
+static inline __m128i LowerBlock_SSE2(__m128i vBlock)
+{
+  __m128i vUpper = _mm_and_si128(_mm_cmpgt_epi8(vBlock, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(vBlock, _mm_set1_epi8('Z' + 1)));
+  return _mm_or_si128(vBlock, _mm_and_si128(vUpper, _mm_set1_epi8(0x20)));
+}
+
+static inline __m128i UpperBlock_SSE2(__m128i vBlock)
+{
+  __m128i vLower = _mm_and_si128(_mm_cmpgt_epi8(vBlock, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(vBlock, _mm_set1_epi8('z' + 1)));
+  return _mm_xor_si128(vBlock, _mm_and_si128(vLower, _mm_set1_epi8(0x20)));
+}
+
+static void ToLower_SSE2(char* szDst, const char* szSrc, int iLen)
+{
+  int i = 0;
+  for(; i + 16 <= iLen; i += 16) {
+    _mm_storeu_si128((__m128i*)(szDst + i), LowerBlock_SSE2(_mm_loadu_si128((const __m128i*)(szSrc + i))));
+  }
+  ToLower_Scalar(szDst + i, szSrc + i, iLen - i);
+}
+
+static void ToUpper_SSE2(char* szDst, const char* szSrc, int iLen)
+{
+  int i = 0;
+  for(; i + 16 <= iLen; i += 16) {
+    _mm_storeu_si128((__m128i*)(szDst + i), UpperBlock_SSE2(_mm_loadu_si128((const __m128i*)(szSrc + i))));
+  }
+  ToUpper_Scalar(szDst + i, szSrc + i, iLen - i);
+}
+
+static int MismatchIgnoreCase_SSE2(const char* sz1, const char* sz2, int iLen)
+{
+  int i = 0;
+  for(; i + 16 <= iLen; i += 16) {
+    __m128i vBlock1 = LowerBlock_SSE2(_mm_loadu_si128((const __m128i*)(sz1 + i)));
+    __m128i vBlock2 = LowerBlock_SSE2(_mm_loadu_si128((const __m128i*)(sz2 + i)));
+    unsigned int ulMask = _mm_movemask_epi8(_mm_cmpeq_epi8(vBlock1, vBlock2));
+    if(ulMask != 0xFFFF) {
+      return i + BitScanForward32(~ulMask);
+    }
+  }
+  return i + MismatchIgnoreCase_Scalar(sz1 + i, sz2 + i, iLen - i);
+}
+
+// AVX2 kernels, the same as above but comparing 32 characters at a time
+
+STRINGSEARCH_TARGET_AVX2
+static const char* FindChar_AVX2(const char* sz, int iLen, char c)
+{
+  const __m256i vChar = _mm256_set1_epi8(c);
+
+  int i = 0;
+
+  // Check 128 characters per iteration and only find the exact position once something matched
+  for(; i + 128 <= iLen; i += 128) {
+    __m256i vMatch0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i)), vChar);
+    __m256i vMatch1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i + 32)), vChar);
+    __m256i vMatch2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i + 64)), vChar);
+    __m256i vMatch3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i + 96)), vChar);
+    __m256i vAny = _mm256_or_si256(_mm256_or_si256(vMatch0, vMatch1), _mm256_or_si256(vMatch2, vMatch3));
+    if(!_mm256_testz_si256(vAny, vAny)) {
+      break;
+    }
+  }
+
+  for(; i + 32 <= iLen; i += 32) {
+    __m256i vBlock = _mm256_loadu_si256((const __m256i*)(sz + i));
+    unsigned int ulMask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(vBlock, vChar));
+    if(ulMask != 0) {
+      return sz + i + BitScanForward32(ulMask);
+    }
+  }
+  return FindChar_SSE2(sz + i, iLen - i, c);
+}
+
+STRINGSEARCH_TARGET_AVX2
+static const char* FindCharLast_AVX2(const char* sz, int iLen, char c)
+{
+  const __m256i vChar = _mm256_set1_epi8(c);
+
+  int i = iLen;
+
+  // Check 128 characters per iteration and only find the exact position once something matched
+  for(; i >= 128; i -= 128) {
+    __m256i vMatch0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i - 32)), vChar);
+    __m256i vMatch1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i - 64)), vChar);
+    __m256i vMatch2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i - 96)), vChar);
+    __m256i vMatch3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i - 128)), vChar);
+    __m256i vAny = _mm256_or_si256(_mm256_or_si256(vMatch0, vMatch1), _mm256_or_si256(vMatch2, vMatch3));
+    if(!_mm256_testz_si256(vAny, vAny)) {
+      break;
+    }
+  }
+
+  for(; i >= 32; i -= 32) {
+    __m256i vBlock = _mm256_loadu_si256((const __m256i*)(sz + i - 32));
+    unsigned int ulMask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(vBlock, vChar));
+    if(ulMask != 0) {
+      return sz + i - 32 + BitScanReverse32(ulMask);
+    }
+  }
+  return FindCharLast_SSE2(sz, i, c);
+}
+
+STRINGSEARCH_TARGET_AVX2
+static const char* Find_AVX2(const char* sz, int iLen, const char* szNeedle, int iNeedleLen)
+{
+  const __m256i vFirst = _mm256_set1_epi8(szNeedle[0]);
+  const __m256i vLast = _mm256_set1_epi8(szNeedle[iNeedleLen - 1]);
+
+  int i = 0;
+
+  // Skip ahead 64 starting positions at a time while neither half has a candidate
+  for(; i + iNeedleLen - 1 + 64 <= iLen; i += 64) {
+    __m256i vCandidates0 = _mm256_and_si256(
+      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i)), vFirst),
+      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i + iNeedleLen - 1)), vLast));
+    __m256i vCandidates1 = _mm256_and_si256(
+      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i + 32)), vFirst),
+      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + i + 32 + iNeedleLen - 1)), vLast));
+    __m256i vAny = _mm256_or_si256(vCandidates0, vCandidates1);
+    if(!_mm256_testz_si256(vAny, vAny)) {
+      break;
+    }
+  }
+
+  for(; i + iNeedleLen - 1 + 32 <= iLen; i += 32) {
+    __m256i vBlockFirst = _mm256_loadu_si256((const __m256i*)(sz + i));
+    __m256i vBlockLast = _mm256_loadu_si256((const __m256i*)(sz + i + iNeedleLen - 1));
+    unsigned int ulMask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(
+      _mm256_cmpeq_epi8(vBlockFirst, vFirst),
+      _mm256_cmpeq_epi8(vBlockLast, vLast)));
+
+    while(ulMask != 0) {
+      int iBit = BitScanForward32(ulMask);
+      if(!memcmp(sz + i + iBit + 1, szNeedle + 1, iNeedleLen - 2)) {
+        return sz + i + iBit;
+      }
+      ulMask &= ulMask - 1;
+    }
+  }
+  return Find_SSE2(sz + i, iLen - i, szNeedle, iNeedleLen);
+}
+
+STRINGSEARCH_TARGET_AVX2
+static const char* FindLast_AVX2(const char* sz, int iLen, const char* szNeedle, int iNeedleLen)
+{
+  const __m256i vFirst = _mm256_set1_epi8(szNeedle[0]);
+  const __m256i vLast = _mm256_set1_epi8(szNeedle[iNeedleLen - 1]);
+
+  // Candidate starting positions left to check are [0, iEnd)
+  int iEnd = iLen - iNeedleLen + 1;
+
+  // Skip back 64 starting positions at a time while neither half has a candidate
+  for(; iEnd >= 64; iEnd -= 64) {
+    __m256i vCandidates0 = _mm256_and_si256(
+      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + iEnd - 32)), vFirst),
+      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + iEnd - 32 + iNeedleLen - 1)), vLast));
+    __m256i vCandidates1 = _mm256_and_si256(
+      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + iEnd - 64)), vFirst),
+      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sz + iEnd - 64 + iNeedleLen - 1)), vLast));
+    __m256i vAny = _mm256_or_si256(vCandidates0, vCandidates1);
+    if(!_mm256_testz_si256(vAny, vAny)) {
+      break;
+    }
+  }
+
+  for(; iEnd >= 32; iEnd -= 32) {
+    int iBase = iEnd - 32;
+    __m256i vBlockFirst = _mm256_loadu_si256((const __m256i*)(sz + iBase));
+    __m256i vBlockLast = _mm256_loadu_si256((const __m256i*)(sz + iBase + iNeedleLen - 1));
+    unsigned int ulMask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(
+      _mm256_cmpeq_epi8(vBlockFirst, vFirst),
+      _mm256_cmpeq_epi8(vBlockLast, vLast)));
+
+    while(ulMask != 0) {
+      int iBit = BitScanReverse32(ulMask);
+      if(!memcmp(sz + iBase + iBit + 1, szNeedle + 1, iNeedleLen - 2)) {
+        return sz + iBase + iBit;
+      }
+      ulMask &= ~(1u << iBit);
+    }
+  }
+  if(iEnd <= 0) {
+    return NULL;
+  }
+  return FindLast_SSE2(sz, iEnd + iNeedleLen - 1, szNeedle, iNeedleLen);
+}
+
+STRINGSEARCH_TARGET_AVX2
+static inline __m256i LowerBlock_AVX2(__m256i vBlock)
+{
+  __m256i vUpper = _mm256_and_si256(_mm256_cmpgt_epi8(vBlock, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), vBlock));
+  return _mm256_or_si256(vBlock, _mm256_and_si256(vUpper, _mm256_set1_epi8(0x20)));
+}
+
+STRINGSEARCH_TARGET_AVX2
+static inline __m256i UpperBlock_AVX2(__m256i vBlock)
+{
+  __m256i vLower = _mm256_and_si256(_mm256_cmpgt_epi8(vBlock, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), vBlock));
+  return _mm256_xor_si256(vBlock, _mm256_and_si256(vLower, _mm256_set1_epi8(0x20)));
+}
+
+STRINGSEARCH_TARGET_AVX2
+static void ToLower_AVX2(char* szDst, const char* szSrc, int iLen)
+{
+  int i = 0;
+  for(; i + 32 <= iLen; i += 32) {
+    _mm256_storeu_si256((__m256i*)(szDst + i), LowerBlock_AVX2(_mm256_loadu_si256((const __m256i*)(szSrc + i))));
+  }
+  ToLower_SSE2(szDst + i, szSrc + i, iLen - i);
+}
+
+STRINGSEARCH_TARGET_AVX2
+static void ToUpper_AVX2(char* szDst, const char* szSrc, int iLen)
+{
+  int i = 0;
+  for(; i + 32 <= iLen; i += 32) {
+    _mm256_storeu_si256((__m256i*)(szDst + i), UpperBlock_AVX2(_mm256_loadu_si256((const __m256i*)(szSrc + i))));
+  }
+  ToUpper_SSE2(szDst + i, szSrc + i, iLen - i);
+}
+
+STRINGSEARCH_TARGET_AVX2
+static int MismatchIgnoreCase_AVX2(const char* sz1, const char* sz2, int iLen)
+{
+  int i = 0;
+  for(; i + 32 <= iLen; i += 32) {
+    __m256i vBlock1 = LowerBlock_AVX2(_mm256_loadu_si256((const __m256i*)(sz1 + i)));
+    __m256i vBlock2 = LowerBlock_AVX2(_mm256_loadu_si256((const __m256i*)(sz2 + i)));
+    unsigned int ulMask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(vBlock1, vBlock2));
+    if(ulMask != 0xFFFFFFFF) {
+      return i + BitScanForward32(~ulMask);
+    }
+  }
+  return i + MismatchIgnoreCase_SSE2(sz1 + i, sz2 + i, iLen - i);
+}
+
+static bool CPUSupportsAVX2()
+{
+#ifdef _MSC_VER
+  int aiInfo[4];
+  __cpuid(aiInfo, 0);
+  if(aiInfo[0] < 7) {
+    return false;
+  }
+
+  // The OS has to save the AVX registers for us
+  __cpuid(aiInfo, 1);
+  if(!(aiInfo[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+
+  __cpuidex(aiInfo, 7, 0);
+  return (aiInfo[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif // STRINGSEARCH_SIMD
+
+struct StringSearchKernels
+{
+  EStringSearchLevel ssk_essl;
+  const char* (*ssk_pFindChar)(const char* sz, int iLen, char c);
+  const char* (*ssk_pFindCharLast)(const char* sz, int iLen, char c);
+  const char* (*ssk_pFind)(const char* sz, int iLen, const char* szNeedle, int iNeedleLen);
+  const char* (*ssk_pFindLast)(const char* sz, int iLen, const char* szNeedle, int iNeedleLen);
+  void (*ssk_pToLower)(char* szDst, const char* szSrc, int iLen);
+  void (*ssk_pToUpper)(char* szDst, const char* szSrc, int iLen);
+  int (*ssk_pMismatchIgnoreCase)(const char* sz1, const char* sz2, int iLen);
+};
+
+static EStringSearchLevel BestSearchLevel()
+{
+#if STRINGSEARCH_SIMD
+  if(CPUSupportsAVX2()) {
+    return ESSL_AVX2;
+  }
+  return ESSL_SSE2;
+#else
+  return ESSL_SCALAR;
+#endif
+}
+
+static StringSearchKernels PickSearchKernels(EStringSearchLevel essl)
+{
+  StringSearchKernels ssk;
+  ssk.ssk_essl = ESSL_SCALAR;
+  ssk.ssk_pFindChar = FindChar_Scalar;
+  ssk.ssk_pFindCharLast = FindCharLast_Scalar;
+  ssk.ssk_pFind = Find_Scalar;
+  ssk.ssk_pFindLast = FindLast_Scalar;
+  ssk.ssk_pToLower = ToLower_Scalar;
+  ssk.ssk_pToUpper = ToUpper_Scalar;
+  ssk.ssk_pMismatchIgnoreCase = MismatchIgnoreCase_Scalar;
+
+#if STRINGSEARCH_SIMD
+  if(essl >= ESSL_SSE2) {
+    ssk.ssk_essl = ESSL_SSE2;
+    ssk.ssk_pFindChar = FindChar_SSE2;
+    ssk.ssk_pFindCharLast = FindCharLast_SSE2;
+    ssk.ssk_pFind = Find_SSE2;
+    ssk.ssk_pFindLast = FindLast_SSE2;
+    ssk.ssk_pToLower = ToLower_SSE2;
+    ssk.ssk_pToUpper = ToUpper_SSE2;
+    ssk.ssk_pMismatchIgnoreCase = MismatchIgnoreCase_SSE2;
+  }
+  if(essl >= ESSL_AVX2) {
+    ssk.ssk_essl = ESSL_AVX2;
+    ssk.ssk_pFindChar = FindChar_AVX2;
+    ssk.ssk_pFindCharLast = FindCharLast_AVX2;
+    ssk.ssk_pFind = Find_AVX2;
+    ssk.ssk_pFindLast = FindLast_AVX2;
+    ssk.ssk_pToLower = ToLower_AVX2;
+    ssk.ssk_pToUpper = ToUpper_AVX2;
+    ssk.ssk_pMismatchIgnoreCase = MismatchIgnoreCase_AVX2;
+  }
+#endif
+
+  return ssk;
+}
+
+static StringSearchKernels &GetSearchKernels()
+{
+  static StringSearchKernels ssk = PickSearchKernels(BestSearchLevel());
+  return ssk;
+}
+
+EStringSearchLevel strSearchGetLevel()
+{
+  return GetSearchKernels().ssk_essl;
+}
+
+void strSearchSetLevel(EStringSearchLevel essl)
+{
+  GetSearchKernels() = PickSearchKernels(Min(essl, BestSearchLevel()));
+}
+
+const char* strFindChar(const char* sz, int iLen, char c)
+{
+  return GetSearchKernels().ssk_pFindChar(sz, iLen, c);
+}
+
+const char* strFindCharLast(const char* sz, int iLen, char c)
+{
+  return GetSearchKernels().ssk_pFindCharLast(sz, iLen, c);
+}
+
+const char* strFind(const char* sz, int iLen, const char* szNeedle, int iNeedleLen)
+{
+  // Empty needles are found right away, like strstr does
+  if(iNeedleLen <= 0) {
+    return sz;
+  }
+  if(iNeedleLen > iLen) {
+    return NULL;
+  }
+  if(iNeedleLen == 1) {
+    return strFindChar(sz, iLen, szNeedle[0]);
+  }
+  return GetSearchKernels().ssk_pFind(sz, iLen, szNeedle, iNeedleLen);
+}
+
+const char* strFindLast(const char* sz, int iLen, const char* szNeedle, int iNeedleLen)
+{
+  // Empty needles are found at the very end
+  if(iNeedleLen <= 0) {
+    return sz + iLen;
+  }
+  if(iNeedleLen > iLen) {
+    return NULL;
+  }
+  if(iNeedleLen == 1) {
+    return strFindCharLast(sz, iLen, szNeedle[0]);
+  }
+  return GetSearchKernels().ssk_pFindLast(sz, iLen, szNeedle, iNeedleLen);
+}
+
+void strToLower(char* szDst, const char* szSrc, int iLen)
+{
+  GetSearchKernels().ssk_pToLower(szDst, szSrc, iLen);
+}
+
+void strToUpper(char* szDst, const char* szSrc, int iLen)
+{
+  GetSearchKernels().ssk_pToUpper(szDst, szSrc, iLen);
+}
+
+int strMismatchIgnoreCase(const char* sz1, const char* sz2, int iLen)
+{
+  return GetSearchKernels().ssk_pMismatchIgnoreCase(sz1, sz2, iLen);
+}
+
+SCRATCH_NAMESPACE_END;
@@ -0,0 +1,71 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_STRINGSEARCH_H_INCLUDED
+#define SCRATCH_STRINGSEARCH_H_INCLUDED
+
+#include "Common.h"
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/* Search and ASCII case folding kernels used by String and StringView. They
+ * work on a pointer and a length rather than null terminated strings, and pick
+ * the widest SIMD instruction set the CPU supports (SSE2 or AVX2) the first
+ * time they're used.
+ */
+
+enum SCRATCH_EXPORT EStringSearchLevel
+{
+  ESSL_SCALAR,
+  ESSL_SSE2,
+  ESSL_AVX2,
+};
+
+/// Return the instruction set the search kernels are currently using
+EStringSearchLevel SCRATCH_EXPORT strSearchGetLevel();
+/// Force the search kernels to a given instruction set, clamped to what the CPU supports. Not thread safe,
+/// meant for tests and benchmarks.
+void SCRATCH_EXPORT strSearchSetLevel(EStringSearchLevel essl);
+
+/// Return a pointer to the first occurrence of c, or NULL if it's not there
+const char* SCRATCH_EXPORT strFindChar(const char* sz, int iLen, char c);
+/// Return a pointer to the last occurrence of c, or NULL if it's not there
+const char* SCRATCH_EXPORT strFindCharLast(const char* sz, int iLen, char c);
+/// Return a pointer to the first occurrence of the needle, or NULL if it's not there
+const char* SCRATCH_EXPORT strFind(const char* sz, int iLen, const char* szNeedle, int iNeedleLen);
+/// Return a pointer to the last occurrence of the needle, or NULL if it's not there
+const char* SCRATCH_EXPORT strFindLast(const char* sz, int iLen, const char* szNeedle, int iNeedleLen);
+
+/// Write the characters with A-Z turned into a-z, the destination may be the source itself
+void SCRATCH_EXPORT strToLower(char* szDst, const char* szSrc, int iLen);
+/// Write the characters with a-z turned into A-Z, the destination may be the source itself
+void SCRATCH_EXPORT strToUpper(char* szDst, const char* szSrc, int iLen);
+/// Return the index of the first character that differs when ignoring ASCII case, or iLen if none do
+int SCRATCH_EXPORT strMismatchIgnoreCase(const char* sz1, const char* sz2, int iLen);
+
+SCRATCH_NAMESPACE_END;
+
+#endif // include once check
@@ -0,0 +1,524 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring> // for memcpy
+
+#include "StringUtf8.h"
+#include "StringSearch.h"
+
+// Like the StringSearch kernels, the vectorized paths are only built for x86-64.
+// The AVX2 validator also relies on the byte shuffles AVX2 brings along.
+#if !defined(SCRATCH_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define STRINGUTF8_SIMD 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define STRINGUTF8_TARGET_AVX2
+#else
+#define STRINGUTF8_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define STRINGUTF8_SIMD 0
+#endif
+
+SCRATCH_NAMESPACE_BEGIN;
+
+static inline bool IsContinuation(UBYTE ub)
+{
+  return (ub & 0xC0) == 0x80;
+}
+
+// Decode a single sequence, returns its size or 0 when it's not valid UTF-8. This rejects
+// overlong forms, surrogates and anything above U+10FFFF, like the vectorized validator does.
+static inline int DecodeSequence(const UBYTE* pub, int iLen, unsigned int &iCodepoint)
+{
+  UBYTE ub0 = pub[0];
+  if(ub0 < 0x80) {
+    iCodepoint = ub0;
+    return 1;
+  }
+
+  if(ub0 < 0xC2) {
+    // Continuation byte without a lead, or an overlong 2 byte form
+    return 0;
+  }
+
+  if(ub0 < 0xE0) {
+    if(iLen < 2 || !IsContinuation(pub[1])) {
+      return 0;
+    }
+    iCodepoint = ((ub0 & 0x1F) << 6) | (pub[1] & 0x3F);
+    return 2;
+  }
+
+  if(ub0 < 0xF0) {
+    // E0 must be followed by A0-BF (overlong otherwise), ED by 80-9F (surrogates otherwise)
+    UBYTE ubMin = ub0 == 0xE0 ? 0xA0 : 0x80;
+    UBYTE ubMax = ub0 == 0xED ? 0x9F : 0xBF;
+    if(iLen < 3 || pub[1] < ubMin || pub[1] > ubMax || !IsContinuation(pub[2])) {
+      return 0;
+    }
+    iCodepoint = ((ub0 & 0x0F) << 12) | ((pub[1] & 0x3F) << 6) | (pub[2] & 0x3F);
+    return 3;
+  }
+
+  if(ub0 < 0xF5) {
+    // F0 must be followed by 90-BF (overlong otherwise), F4 by 80-8F (above U+10FFFF otherwise)
+    UBYTE ubMin = ub0 == 0xF0 ? 0x90 : 0x80;
+    UBYTE ubMax = ub0 == 0xF4 ? 0x8F : 0xBF;
+    if(iLen < 4 || pub[1] < ubMin || pub[1] > ubMax || !IsContinuation(pub[2]) || !IsContinuation(pub[3])) {
+      return 0;
+    }
+    iCodepoint = ((ub0 & 0x07) << 18) | ((pub[1] & 0x3F) << 12) | ((pub[2] & 0x3F) << 6) | (pub[3] & 0x3F);
+    return 4;
+  }
+
+  return 0;
+}
+
+// Return the amount of continuation bytes in 8 bytes at once
+static inline int CountContinuations(unsigned long long ul)
+{
+  // A continuation byte has its high bit set and the bit below it clear
+  unsigned long long ulMask = (ul & ~(ul << 1)) & 0x8080808080808080ULL;
+  return (int)(((ulMask >> 7) * 0x0101010101010101ULL) >> 56);
+}
+
+// Scalar kernels, used for short tails and on CPUs without SIMD support
+
+static int Utf8Validate_Scalar(const char* sz, int iLen)
+{
+  const UBYTE* pub = (const UBYTE*)sz;
+  int i = 0;
+  while(i < iLen) {
+    // Skip over ASCII 8 bytes at a time
+    if(i + 8 <= iLen) {
+      unsigned long long ul;
+      memcpy(&ul, pub + i, 8);
+      if((ul & 0x8080808080808080ULL) == 0) {
+        i += 8;
+        continue;
+      }
+    }
+
+    unsigned int iCodepoint;
+    int iSize = DecodeSequence(pub + i, iLen - i, iCodepoint);
+    if(iSize == 0) {
+      return i;
+    }
+    i += iSize;
+  }
+  return iLen;
+}
+
+static int Utf8Count_Scalar(const char* sz, int iLen)
+{
+  int ctCodepoints = 0;
+  int i = 0;
+  for(; i + 8 <= iLen; i += 8) {
+    unsigned long long ul;
+    memcpy(&ul, sz + i, 8);
+    ctCodepoints += 8 - CountContinuations(ul);
+  }
+  for(; i < iLen; i++) {
+    ctCodepoints += !IsContinuation(sz[i]);
+  }
+  return ctCodepoints;
+}
+
+#if STRINGUTF8_SIMD
+
+// The validator checks whole blocks and only says whether a block has an error somewhere. Everything
+// that starts more than 3 bytes before that block was already checked, so back up to the start of the
+// sequence around there and let the scalar validator find exactly where it goes wrong.
+static int Utf8Recheck(const char* sz, int iLen, int iBlock)
+{
+  int iStart = Max(iBlock - 3, 0);
+  while(iStart > 0 && IsContinuation(sz[iStart])) {
+    iStart--;
+  }
+  return iStart + Utf8Validate_Scalar(sz + iStart, iLen - iStart);
+}
+
+static inline int BitScanForward32(unsigned int ulMask)
+{
+#ifdef _MSC_VER
+  unsigned long ulIndex;
+  _BitScanForward(&ulIndex, ulMask);
+  return (int)ulIndex;
+#else
+  return __builtin_ctz(ulMask);
+#endif
+}
+
+// SSE2 kernels, skipping over ASCII 16 bytes at a time
+
+static int Utf8Validate_SSE2(const char* sz, int iLen)
+{
+  const UBYTE* pub = (const UBYTE*)sz;
+  int i = 0;
+  while(i + 16 <= iLen) {
+    unsigned int ulMask = (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(sz + i)));
+    if(ulMask == 0) {
+      i += 16;
+      continue;
+    }
+
+    // Decode the run of multibyte sequences one by one, until we're back at ASCII
+    i += BitScanForward32(ulMask);
+    while(i < iLen && pub[i] >= 0x80) {
+      unsigned int iCodepoint;
+      int iSize = DecodeSequence(pub + i, iLen - i, iCodepoint);
+      if(iSize == 0) {
+        return i;
+      }
+      i += iSize;
+    }
+  }
+  return i + Utf8Validate_Scalar(sz + i, iLen - i);
+}
+
+static int Utf8Count_SSE2(const char* sz, int iLen)
+{
+  const __m128i vContinuationMax = _mm_set1_epi8((char)0xBF);
+  int ctCodepoints = 0;
+  int i = 0;
+  while(i + 16 <= iLen) {
+    // Count in bytes for up to 255 blocks, then add those up before they can overflow
+    __m128i vCounts = _mm_setzero_si128();
+    for(int iBlock = 0; iBlock < 255 && i + 16 <= iLen; iBlock++, i += 16) {
+      __m128i vLeads = _mm_cmpgt_epi8(_mm_loadu_si128((const __m128i*)(sz + i)), vContinuationMax);
+      vCounts = _mm_sub_epi8(vCounts, vLeads);
+    }
+    __m128i vSums = _mm_sad_epu8(vCounts, _mm_setzero_si128());
+    ctCodepoints += _mm_cvtsi128_si32(vSums) + _mm_cvtsi128_si32(_mm_srli_si128(vSums, 8));
+  }
+  return ctCodepoints + Utf8Count_Scalar(sz + i, iLen - i);
+}
+
+// AVX2 kernels, validating 32 bytes at a time without branching on the contents. Every byte is
+// checked against the 3 bytes in front of it by looking up the high and low nibble of the previous
+// byte and the high nibble of the byte itself in 3 tables. Each table gives the errors that nibble
+// could be part of, and only the errors all 3 agree on are real. Continuations of 3 and 4 byte
+// sequences are checked separately, by looking 2 and 3 bytes back.
+
+enum EUtf8Error
+{
+  EUE_TOO_SHORT      = 1 << 0, // 11______ 0_______, or 11______ 11______
+  EUE_TOO_LONG       = 1 << 1, // 0_______ 10______
+  EUE_OVERLONG_3     = 1 << 2, // 11100000 100_____
+  EUE_TOO_LARGE      = 1 << 3, // 11110100 1001____, or 11110101+ 10______
+  EUE_SURROGATE      = 1 << 4, // 11101101 101_____
+  EUE_OVERLONG_2     = 1 << 5, // 1100000_ 10______
+  EUE_TOO_LARGE_1000 = 1 << 6, // 11110101+ 1000____
+  EUE_OVERLONG_4     = 1 << 6, // 11110000 1000____
+  EUE_TWO_CONTS      = 1 << 7, // 10______ 10______
+  EUE_CARRY          = EUE_TOO_SHORT | EUE_TOO_LONG | EUE_TWO_CONTS,
+};
+
+static const UBYTE _aubByte1High[16] = {
+  // 0_______ ________
+  EUE_TOO_LONG, EUE_TOO_LONG, EUE_TOO_LONG, EUE_TOO_LONG,
+  EUE_TOO_LONG, EUE_TOO_LONG, EUE_TOO_LONG, EUE_TOO_LONG,
+  // 10______ ________
+  EUE_TWO_CONTS, EUE_TWO_CONTS, EUE_TWO_CONTS, EUE_TWO_CONTS,
+  // 1100____ ________
+  EUE_TOO_SHORT | EUE_OVERLONG_2,
+  // 1101____ ________
+  EUE_TOO_SHORT,
+  // 1110____ ________
+  EUE_TOO_SHORT | EUE_OVERLONG_3 | EUE_SURROGATE,
+  // 1111____ ________
+  EUE_TOO_SHORT | EUE_TOO_LARGE | EUE_TOO_LARGE_1000 | EUE_OVERLONG_4,
+};
+
+static const UBYTE _aubByte1Low[16] = {
+  // ____0000 ________
+  EUE_CARRY | EUE_OVERLONG_3 | EUE_OVERLONG_2 | EUE_OVERLONG_4,
+  // ____0001 ________
+  EUE_CARRY | EUE_OVERLONG_2,
+  // ____001_ ________
+  EUE_CARRY,
+  EUE_CARRY,
+  // ____0100 ________
+  EUE_CARRY | EUE_TOO_LARGE,
+  // ____0101 ________ and up
+  EUE_CARRY | EUE_TOO_LARGE | EUE_TOO_LARGE_1000,
+  EUE_CARRY | EUE_TOO_LARGE | EUE_TOO_LARGE_1000,
+  EUE_CARRY | EUE_TOO_LARGE | EUE_TOO_LARGE_1000,
+  EUE_CARRY | EUE_TOO_LARGE | EUE_TOO_LARGE_1000,
+  EUE_CARRY | EUE_TOO_LARGE | EUE_TOO_LARGE_1000,
+  EUE_CARRY | EUE_TOO_LARGE | EUE_TOO_LARGE_1000,
+  EUE_CARRY | EUE_TOO_LARGE | EUE_TOO_LARGE_1000,
+  EUE_CARRY | EUE_TOO_LARGE | EUE_TOO_LARGE_1000,
+  // ____1101 ________
+  EUE_CARRY | EUE_TOO_LARGE | EUE_TOO_LARGE_1000 | EUE_SURROGATE,
+  EUE_CARRY | EUE_TOO_LARGE | EUE_TOO_LARGE_1000,
+  EUE_CARRY | EUE_TOO_LARGE | EUE_TOO_LARGE_1000,
+};
+
+static const UBYTE _aubByte2High[16] = {
+  // ________ 0_______
+  EUE_TOO_SHORT, EUE_TOO_SHORT, EUE_TOO_SHORT, EUE_TOO_SHORT,
+  EUE_TOO_SHORT, EUE_TOO_SHORT, EUE_TOO_SHORT, EUE_TOO_SHORT,
+  // ________ 1000____
+  EUE_TOO_LONG | EUE_OVERLONG_2 | EUE_TWO_CONTS | EUE_OVERLONG_3 | EUE_TOO_LARGE_1000 | EUE_OVERLONG_4,
+  // ________ 1001____
+  EUE_TOO_LONG | EUE_OVERLONG_2 | EUE_TWO_CONTS | EUE_OVERLONG_3 | EUE_TOO_LARGE,
+  // ________ 101_____
+  EUE_TOO_LONG | EUE_OVERLONG_2 | EUE_TWO_CONTS | EUE_SURROGATE | EUE_TOO_LARGE,
+  EUE_TOO_LONG | EUE_OVERLONG_2 | EUE_TWO_CONTS | EUE_SURROGATE | EUE_TOO_LARGE,
+  // ________ 11______
+  EUE_TOO_SHORT, EUE_TOO_SHORT, EUE_TOO_SHORT, EUE_TOO_SHORT,
+};
+
+// The largest byte that may end a block at each position without leaving a sequence unfinished
+static const UBYTE _aubIncompleteMax[32] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+};
+
+STRINGUTF8_TARGET_AVX2
+static inline __m256i LoadTable_AVX2(const UBYTE* pubTable)
+{
+  return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)pubTable));
+}
+
+STRINGUTF8_TARGET_AVX2
+static inline __m256i HighNibbles_AVX2(__m256i vBlock)
+{
+  return _mm256_and_si256(_mm256_srli_epi16(vBlock, 4), _mm256_set1_epi8(0x0F));
+}
+
+STRINGUTF8_TARGET_AVX2
+static inline __m256i CheckBlock_AVX2(__m256i vBlock, __m256i vPrevBlock, __m256i vByte1High, __m256i vByte1Low, __m256i vByte2High)
+{
+  // Line up the 1, 2 and 3 bytes in front of every byte, reaching into the previous block
+  __m256i vCarried = _mm256_permute2x128_si256(vPrevBlock, vBlock, 0x21);
+  __m256i vPrev1 = _mm256_alignr_epi8(vBlock, vCarried, 15);
+  __m256i vPrev2 = _mm256_alignr_epi8(vBlock, vCarried, 14);
+  __m256i vPrev3 = _mm256_alignr_epi8(vBlock, vCarried, 13);
+
+  __m256i vErrors = _mm256_and_si256(
+    _mm256_and_si256(
+      _mm256_shuffle_epi8(vByte1High, HighNibbles_AVX2(vPrev1)),
+      _mm256_shuffle_epi8(vByte1Low, _mm256_and_si256(vPrev1, _mm256_set1_epi8(0x0F)))),
+    _mm256_shuffle_epi8(vByte2High, HighNibbles_AVX2(vBlock)));
+
+  // Bytes 2 or 3 behind a 3 or 4 byte lead must be continuations, which the tables mark as two
+  // continuations in a row. Flip that bit, so it's only an error when the two disagree.
+  __m256i vThird = _mm256_subs_epu8(vPrev2, _mm256_set1_epi8((char)(0xE0 - 0x80)));
+  __m256i vFourth = _mm256_subs_epu8(vPrev3, _mm256_set1_epi8((char)(0xF0 - 0x80)));
+  __m256i vMust23 = _mm256_and_si256(_mm256_or_si256(vThird, vFourth), _mm256_set1_epi8((char)0x80));
+  return _mm256_xor_si256(vMust23, vErrors);
+}
+
+STRINGUTF8_TARGET_AVX2
+static int Utf8Validate_AVX2(const char* sz, int iLen)
+{
+  const __m256i vByte1High = LoadTable_AVX2(_aubByte1High);
+  const __m256i vByte1Low = LoadTable_AVX2(_aubByte1Low);
+  const __m256i vByte2High = LoadTable_AVX2(_aubByte2High);
+  const __m256i vIncompleteMax = _mm256_loadu_si256((const __m256i*)_aubIncompleteMax);
+
+  __m256i vPrevBlock = _mm256_setzero_si256();
+  __m256i vPrevIncomplete = _mm256_setzero_si256();
+  int i = 0;
+  for(; i + 32 <= iLen; i += 32) {
+    __m256i vBlock = _mm256_loadu_si256((const __m256i*)(sz + i));
+    __m256i vErrors;
+    if(_mm256_movemask_epi8(vBlock) == 0) {
+      // All ASCII, which is only wrong when the previous block left a sequence unfinished
+      vErrors = vPrevIncomplete;
+    } else {
+      vErrors = CheckBlock_AVX2(vBlock, vPrevBlock, vByte1High, vByte1Low, vByte2High);
+      vPrevIncomplete = _mm256_subs_epu8(vBlock, vIncompleteMax);
+    }
+    if(!_mm256_testz_si256(vErrors, vErrors)) {
+      return Utf8Recheck(sz, iLen, i);
+    }
+    vPrevBlock = vBlock;
+  }
+
+  // The tail may finish a sequence the last block started, so start from before it
+  return Utf8Recheck(sz, iLen, i);
+}
+
+STRINGUTF8_TARGET_AVX2
+static int Utf8Count_AVX2(const char* sz, int iLen)
+{
+  const __m256i vContinuationMax = _mm256_set1_epi8((char)0xBF);
+  int ctCodepoints = 0;
+  int i = 0;
+  while(i + 32 <= iLen) {
+    // Count in bytes for up to 255 blocks, then add those up before they can overflow
+    __m256i vCounts = _mm256_setzero_si256();
+    for(int iBlock = 0; iBlock < 255 && i + 32 <= iLen; iBlock++, i += 32) {
+      __m256i vLeads = _mm256_cmpgt_epi8(_mm256_loadu_si256((const __m256i*)(sz + i)), vContinuationMax);
+      vCounts = _mm256_sub_epi8(vCounts, vLeads);
+    }
+    __m256i vSums = _mm256_sad_epu8(vCounts, _mm256_setzero_si256());
+    __m128i vHalves = _mm_add_epi64(_mm256_castsi256_si128(vSums), _mm256_extracti128_si256(vSums, 1));
+    ctCodepoints += _mm_cvtsi128_si32(vHalves) + _mm_cvtsi128_si32(_mm_srli_si128(vHalves, 8));
+  }
+  return ctCodepoints + Utf8Count_Scalar(sz + i, iLen - i);
+}
+
+#endif // STRINGUTF8_SIMD
+
+int strUtf8Validate(const char* sz, int iLen)
+{
+  switch(strSearchGetLevel()) {
+#if STRINGUTF8_SIMD
+  case ESSL_AVX2: return Utf8Validate_AVX2(sz, iLen);
+  case ESSL_SSE2: return Utf8Validate_SSE2(sz, iLen);
+#endif
+  default: return Utf8Validate_Scalar(sz, iLen);
+  }
+}
+
+int strUtf8Count(const char* sz, int iLen)
+{
+  switch(strSearchGetLevel()) {
+#if STRINGUTF8_SIMD
+  case ESSL_AVX2: return Utf8Count_AVX2(sz, iLen);
+  case ESSL_SSE2: return Utf8Count_SSE2(sz, iLen);
+#endif
+  default: return Utf8Count_Scalar(sz, iLen);
+  }
+}
+
+int strUtf8Offset(const char* sz, int iLen, int iCodepoint)
+{
+  if(iCodepoint <= 0) {
+    return 0;
+  }
+
+  // Skip 8 bytes at a time while the codepoint we want isn't in them
+  int ctCodepoints = 0;
+  int i = 0;
+  for(; i + 8 <= iLen; i += 8) {
+    unsigned long long ul;
+    memcpy(&ul, sz + i, 8);
+    int ctLeads = 8 - CountContinuations(ul);
+    if(ctCodepoints + ctLeads > iCodepoint) {
+      break;
+    }
+    ctCodepoints += ctLeads;
+  }
+
+  for(; i < iLen; i++) {
+    if(!IsContinuation(sz[i])) {
+      if(ctCodepoints == iCodepoint) {
+        return i;
+      }
+      ctCodepoints++;
+    }
+  }
+  return iLen;
+}
+
+unsigned int strUtf8Decode(const char* sz, int iLen, int &iSize)
+{
+  if(iLen <= 0) {
+    iSize = 0;
+    return 0;
+  }
+
+  unsigned int iCodepoint;
+  iSize = DecodeSequence((const UBYTE*)sz, iLen, iCodepoint);
+  if(iSize == 0) {
+    iSize = 1;
+    return STRINGUTF8_REPLACEMENT;
+  }
+  return iCodepoint;
+}
+
+int strUtf8Previous(const char* sz, int iOffset)
+{
+  if(iOffset <= 0) {
+    return 0;
+  }
+
+  // Back up to what looks like a lead byte, but only step over the whole sequence when it
+  // actually decodes to exactly those bytes, so this agrees with strUtf8Decode on broken input
+  int iStart = iOffset - 1;
+  int iLimit = Max(iOffset - 4, 0);
+  while(iStart > iLimit && IsContinuation(sz[iStart])) {
+    iStart--;
+  }
+  int iSize;
+  strUtf8Decode(sz + iStart, iOffset - iStart, iSize);
+  if(iStart + iSize != iOffset) {
+    return iOffset - 1;
+  }
+  return iStart;
+}
+
+int strUtf8Encode(char* szDst, unsigned int iCodepoint)
+{
+  // Surrogates and anything above U+10FFFF can't be encoded
+  if((iCodepoint >= 0xD800 && iCodepoint <= 0xDFFF) || iCodepoint > 0x10FFFF) {
+    iCodepoint = STRINGUTF8_REPLACEMENT;
+  }
+
+  if(iCodepoint < 0x80) {
+    szDst[0] = (char)iCodepoint;
+    return 1;
+  }
+  if(iCodepoint < 0x800) {
+    szDst[0] = (char)(0xC0 | (iCodepoint >> 6));
+    szDst[1] = (char)(0x80 | (iCodepoint & 0x3F));
+    return 2;
+  }
+  if(iCodepoint < 0x10000) {
+    szDst[0] = (char)(0xE0 | (iCodepoint >> 12));
+    szDst[1] = (char)(0x80 | ((iCodepoint >> 6) & 0x3F));
+    szDst[2] = (char)(0x80 | (iCodepoint & 0x3F));
+    return 3;
+  }
+  szDst[0] = (char)(0xF0 | (iCodepoint >> 18));
+  szDst[1] = (char)(0x80 | ((iCodepoint >> 12) & 0x3F));
+  szDst[2] = (char)(0x80 | ((iCodepoint >> 6) & 0x3F));
+  szDst[3] = (char)(0x80 | (iCodepoint & 0x3F));
+  return 4;
+}
+
+bool strUtf8IsSpace(unsigned int iCodepoint)
+{
+  if(iCodepoint < 0x80) {
+    return iCodepoint == ' ' || (iCodepoint >= 0x09 && iCodepoint <= 0x0D);
+  }
+  switch(iCodepoint) {
+  case 0x0085: case 0x00A0: case 0x1680:
+  case 0x2028: case 0x2029: case 0x202F: case 0x205F: case 0x3000:
+    return true;
+  }
+  return iCodepoint >= 0x2000 && iCodepoint <= 0x200A;
+}
+
+SCRATCH_NAMESPACE_END;
@@ -0,0 +1,64 @@
+/*  libscratch - Multipurpose objective C++ library.
+    
+    Copyright (c) 2015 Angelo Geels <spansjh@gmail.com>
+    
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+    
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SCRATCH_STRINGUTF8_H_INCLUDED
+#define SCRATCH_STRINGUTF8_H_INCLUDED
+
+#include "Common.h"
+
+// The codepoint that takes the place of bytes that aren't valid UTF-8.
+#define STRINGUTF8_REPLACEMENT 0xFFFD
+// The most bytes strUtf8Encode will ever write.
+#define STRINGUTF8_MAX_BYTES 4
+
+SCRATCH_NAMESPACE_BEGIN;
+
+/* UTF-8 handling used by String and StringView. Validation and counting are
+ * vectorized and use the same instruction set as the StringSearch kernels, see
+ * strSearchSetLevel. Decoding never reads past iLen, and maps every byte that
+ * isn't part of a valid sequence to STRINGUTF8_REPLACEMENT.
+ */
+
+/// Return the index of the first byte that isn't part of valid UTF-8, or iLen if all of it is
+int SCRATCH_EXPORT strUtf8Validate(const char* sz, int iLen);
+/// Return the amount of codepoints in valid UTF-8
+int SCRATCH_EXPORT strUtf8Count(const char* sz, int iLen);
+/// Return the byte offset of the given codepoint, or iLen if there aren't that many codepoints
+int SCRATCH_EXPORT strUtf8Offset(const char* sz, int iLen, int iCodepoint);
+
+/// Decode the codepoint at the start of the buffer, setting iSize to the amount of bytes it takes up
+unsigned int SCRATCH_EXPORT strUtf8Decode(const char* sz, int iLen, int &iSize);
+/// Return the byte offset of the codepoint that ends right before iOffset
+int SCRATCH_EXPORT strUtf8Previous(const char* sz, int iOffset);
+/// Write the codepoint without a null terminator and return the amount of bytes written
+int SCRATCH_EXPORT strUtf8Encode(char* szDst, unsigned int iCodepoint);
+
+/// Return whether the codepoint has the Unicode White_Space property
+bool SCRATCH_EXPORT strUtf8IsSpace(unsigned int iCodepoint);
+
+SCRATCH_NAMESPACE_END;
+
+#endif // include once check
@@ -0,0 +1,1140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <chrono>
+#include <thread>
+
+#include <Scratch.h>
+using namespace Scratch;
+
+// Every allocation made through new/delete is counted so benchmarks can
+// report how much they hit the allocator next to how long they take.
+
+static unsigned long g_ulAllocations = 0;
+
+// Both forms of new allocate through here and both forms of delete free through CountedFree, so every
+// new is matched with the delete of its own form instead of one form calling into the other.
+static void* CountedAlloc(size_t size)
+{
+  g_ulAllocations++;
+  void* p = malloc(size > 0 ? size : 1);
+  if(p == NULL) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+static void CountedFree(void* p)
+{
+  free(p);
+}
+
+void* operator new(size_t size)
+{
+  return CountedAlloc(size);
+}
+
+void* operator new[](size_t size)
+{
+  return CountedAlloc(size);
+}
+
+void operator delete(void* p) noexcept
+{
+  CountedFree(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  CountedFree(p);
+}
+
+// Results are written here so the optimizer can't throw the work away.
+static volatile int g_iSink = 0;
+
+#define BENCHES(id) \
+  if(strArg == id || strArg == "All")
+
+#define BENCH(name, iterations, ...) { \
+  unsigned long ulAllocStart = g_ulAllocations; \
+  auto tmStart = std::chrono::high_resolution_clock::now(); \
+  for(INDEX iBench=0; iBench<(iterations); iBench++) { \
+    __VA_ARGS__; \
+  } \
+  auto tmEnd = std::chrono::high_resolution_clock::now(); \
+  double fNanoseconds = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(tmEnd - tmStart).count(); \
+  printf("BENCH %-56s %12.2f ns/op %10.2f allocs/op\n", name, \
+    fNanoseconds / (iterations), (double)(g_ulAllocations - ulAllocStart) / (iterations)); \
+}
+
+int main(int argc, char* argv[])
+{
+  String strArg = "All";
+  if(argc > 1) {
+    strArg = argv[1];
+  }
+
+  BENCHES("String")
+  {
+    const INDEX ctIterations = 1000000;
+
+    BENCH("String construct short", ctIterations,
+      String str("user.name");
+      g_iSink += str.Length());
+
+    BENCH("String construct long", ctIterations,
+      String str("this string is long enough to need the heap");
+      g_iSink += str.Length());
+
+    String strShort = "hostname";
+    BENCH("String copy short", ctIterations,
+      String str(strShort);
+      g_iSink += str.Length());
+
+    BENCH("String concat short", ctIterations,
+      String str = strShort + ".local";
+      g_iSink += str.Length());
+
+    String strKeys = "id;name;host;port;tag;user;path;mode";
+    BENCH("String split 8 short keys", ctIterations / 10,
+      StackArray<String> astrParts;
+      strKeys.Split(";", astrParts);
+      g_iSink += astrParts.Count());
+
+    String strPadded = "   token   ";
+    BENCH("String trim short", ctIterations,
+      String str = strPadded.Trim();
+      g_iSink += str.Length());
+
+    String strLine = "2015-06-01 12:00:00 [info] request served";
+    BENCH("String substring short", ctIterations,
+      String str = strLine.SubString(20, 6);
+      g_iSink += str.Length());
+
+    BENCH("String construct copy destroy short", ctIterations,
+      String str("token");
+      String strCopy(str);
+      String strAssign;
+      strAssign = strCopy;
+      g_iSink += strAssign.Length());
+
+    BENCH("String construct copy destroy long", ctIterations,
+      String str("this string is long enough to need the heap");
+      String strCopy(str);
+      String strAssign;
+      strAssign = strCopy;
+      g_iSink += strAssign.Length());
+
+    String strLarge;
+    strLarge.Fill('x', 64 * 1024);
+    BENCH("String copy 64k", ctIterations / 100,
+      String str(strLarge);
+      g_iSink += str.Length());
+
+    BENCH("String move 64k there and back", ctIterations,
+      String str(std::move(strLarge));
+      strLarge = std::move(str);
+      g_iSink += strLarge.Length());
+
+    BENCH("String concat chain of 6 parts", ctIterations,
+      String str = strLine + " " + strShort + " " + strLine + "\n";
+      g_iSink += str.Length());
+
+    Dictionary<String, String> dstrConfig;
+    for(INDEX i=0; i<100; i++) {
+      dstrConfig.Add(strPrintF("configuration.section.key_%d", i), strPrintF("a value that is too long to be inline %d", i));
+    }
+    BENCH("Dictionary<String, String> copy of 100 long pairs", ctIterations / 100,
+      Dictionary<String, String> dstrCopy(dstrConfig);
+      g_iSink += dstrCopy.Count());
+
+    String strLogLine = "2015-06-01 12:00:00 [info] 127.0.0.1 GET /index.html 200 1534 0.002";
+    BENCH("String split log line into Strings", ctIterations / 10,
+      StackArray<String> astrParts;
+      strLogLine.Split(" ", astrParts);
+      g_iSink += astrParts.Count());
+
+    BENCH("StringView split log line into views", ctIterations / 10,
+      strLogLine.View().Split(" ", [](const StringView &strPart) {
+        g_iSink += strPart.Length();
+      }));
+
+    String strCommand = "git commit --author \"Some Body <some@body.org>\" -m \"Fix \\\"quoted\\\" args\" -- src/main.cpp";
+    BENCH("String CommandLineSplit into Strings", ctIterations / 10,
+      StackArray<String> astrArguments;
+      strCommand.CommandLineSplit(astrArguments);
+      g_iSink += astrArguments.Count());
+
+    BENCH("String CommandLineSplit into views", ctIterations / 10,
+      strCommand.CommandLineSplit([](const StringView &strArgument) {
+        g_iSink += strArgument.Length();
+      }));
+
+    SyncString strShared = "shared";
+    BENCH("SyncString get", ctIterations,
+      g_iSink += strShared.Get().Length());
+
+    BENCH("String append 10k single characters", 100,
+      String str;
+      for(INDEX i=0; i<10000; i++) {
+        str += 'x';
+      }
+      g_iSink += str.Length());
+
+    String strLong = strLine * 100;
+    BENCH("String length of 4k characters", ctIterations,
+      g_iSink += strLong.Length());
+
+    BENCH("String read 100 strings of 1k characters from stream", 100,
+      MemoryStream ms;
+      String strWrite = "y";
+      strWrite *= 1000;
+      for(INDEX i=0; i<100; i++) {
+        ms << strWrite;
+      }
+      ms.Seek(0, SEEK_SET);
+      for(INDEX i=0; i<100; i++) {
+        g_iSink += ms.ReadString().Length();
+      });
+  }
+
+  BENCHES("StringBuilder")
+  {
+    String strLine = "2015-06-01 12:00:00 [info] request served";
+    String strShort = "hostname";
+    BENCH("StringBuilder chain of 6 parts", 1000000,
+      StringBuilder sb;
+      sb.Append(strLine).Append(' ').Append(strShort).Append(' ').Append(strLine).Append('\n');
+      String str = sb.ToString();
+      g_iSink += str.Length());
+
+    // 100 MB out of 10 million fragments of 10 characters
+    const INDEX ctFragments = 10 * 1000 * 1000;
+    String strFragment = "fragment, ";
+
+    BENCH("String += 10M fragments into 100 MB", 1,
+      String str;
+      for(INDEX i=0; i<ctFragments; i++) {
+        str += strFragment;
+      }
+      g_iSink += str.Length());
+
+    BENCH("StringBuilder 10M fragments into 100 MB", 1,
+      StringBuilder sb;
+      for(INDEX i=0; i<ctFragments; i++) {
+        sb += strFragment;
+      }
+      String str = sb.ToString();
+      g_iSink += str.Length());
+  }
+
+  BENCHES("StringConvert")
+  {
+    const INDEX ctIterations = 1000000;
+
+    String strInts;
+    BENCH("String AppendF %d", ctIterations,
+      strInts.AppendF("%d", iBench * 997);
+      strInts += ',');
+    g_iSink += strInts.Length();
+
+    strInts = "";
+    BENCH("String AppendInt", ctIterations,
+      strInts.AppendInt(iBench * 997);
+      strInts += ',');
+    g_iSink += strInts.Length();
+
+    String strFloats;
+    BENCH("String AppendF %.17g", ctIterations,
+      strFloats.AppendF("%.17g", iBench * 0.37);
+      strFloats += ',');
+    g_iSink += strFloats.Length();
+
+    strFloats = "";
+    BENCH("String AppendDouble", ctIterations,
+      strFloats.AppendDouble(iBench * 0.37);
+      strFloats += ',');
+    g_iSink += strFloats.Length();
+
+    String strHex;
+    BENCH("String AppendF %x", ctIterations,
+      strHex.AppendF("%x", iBench * 997);
+      strHex += ',');
+    g_iSink += strHex.Length();
+
+    strHex = "";
+    BENCH("String AppendHex", ctIterations,
+      strHex.AppendHex(iBench * 997);
+      strHex += ',');
+    g_iSink += strHex.Length();
+
+    String strInt = "-1234567";
+    BENCH("strtol on a String", ctIterations,
+      g_iSink += (int)strtol(strInt, NULL, 10));
+
+    BENCH("String ParseInt", ctIterations,
+      int iValue = 0;
+      strInt.ParseInt(iValue);
+      g_iSink += iValue);
+
+    String strFloat = "1234.5678";
+    BENCH("strtod on a String", ctIterations,
+      g_iSink += (int)strtod(strFloat, NULL));
+
+    BENCH("String ParseFloat", ctIterations,
+      double dValue = 0;
+      strFloat.ParseFloat(dValue);
+      g_iSink += (int)dValue);
+  }
+
+  BENCHES("StringFormat")
+  {
+    const INDEX ctIterations = 1000000;
+    String strTime = "2015-06-01 12:00:00";
+    String strFile = "Scratch/CString.cpp";
+
+    BENCH("strPrintF log line", ctIterations,
+      String str = strPrintF("%s [%s] %s:%d took %.3f ms", (const char*)strTime, "info", (const char*)strFile, iBench, iBench * 0.001);
+      g_iSink += str.Length());
+
+    BENCH("SCRATCH_FORMAT log line", ctIterations,
+      String str = SCRATCH_FORMAT("%s [%s] %s:%d took %.3f ms", strTime, "info", strFile, iBench, iBench * 0.001);
+      g_iSink += str.Length());
+
+    BENCH("SCRATCH_FORMAT log line, shortest float", ctIterations,
+      String str = SCRATCH_FORMAT("%s [%s] %s:%d took %f ms", strTime, "info", strFile, iBench, iBench * 0.001);
+      g_iSink += str.Length());
+  }
+
+  BENCHES("StringPool")
+  {
+    // A million records that each carry one out of 200 keys
+    const INDEX ctKeys = 200;
+    const INDEX ctRecords = 1000000;
+    StackArray<String> astrKeys;
+    for(INDEX i=0; i<ctKeys; i++) {
+      astrKeys.Push() = strPrintF("configuration.network.field_%d", i);
+    }
+
+    StringPool sp;
+    StackArray<InternedString> aistrKeys;
+    for(INDEX i=0; i<ctKeys; i++) {
+      aistrKeys.Push() = sp.Intern(astrKeys[i]);
+    }
+
+    String* astrRecords = new String[ctRecords];
+    BENCH("String copy key into 1M records", 1,
+      for(INDEX i=0; i<ctRecords; i++) {
+        astrRecords[i] = astrKeys[i % ctKeys];
+      });
+
+    InternedString* aistrRecords = new InternedString[ctRecords];
+    BENCH("StringPool intern key into 1M records", 1,
+      for(INDEX i=0; i<ctRecords; i++) {
+        aistrRecords[i] = sp.Intern(astrKeys[i % ctKeys]);
+      });
+
+    long long llStringBytes = 0;
+    for(INDEX i=0; i<ctRecords; i++) {
+      llStringBytes += sizeof(String) + (astrRecords[i].Capacity() >= CSTRING_INLINE_BUFFER_SIZE ? astrRecords[i].Capacity() + 1 : 0);
+    }
+    long long llInternedBytes = (long long)sizeof(InternedString) * ctRecords + sp.MemoryUsage();
+    printf("MEMORY 1M records as String: %lld bytes, as InternedString: %lld bytes\n", llStringBytes, llInternedBytes);
+
+    // Looking a record's key up in a plain array of the keys
+    String* astrKeyTable = new String[ctKeys];
+    InternedString* aistrKeyTable = new InternedString[ctKeys];
+    for(INDEX i=0; i<ctKeys; i++) {
+      astrKeyTable[i] = astrKeys[i];
+      aistrKeyTable[i] = aistrKeys[i];
+    }
+
+    BENCH("String find key among 200 by comparing", ctRecords / 10,
+      const String &strKey = astrRecords[iBench];
+      INDEX iFound = 0;
+      while(!(astrKeyTable[iFound] == strKey)) {
+        iFound++;
+      }
+      g_iSink += iFound);
+
+    BENCH("InternedString find key among 200 by comparing", ctRecords / 10,
+      const InternedString &istrKey = aistrRecords[iBench];
+      INDEX iFound = 0;
+      while(aistrKeyTable[iFound] != istrKey) {
+        iFound++;
+      }
+      g_iSink += iFound);
+
+    delete[] astrKeyTable;
+    delete[] aistrKeyTable;
+    delete[] astrRecords;
+    delete[] aistrRecords;
+  }
+
+  BENCHES("StringReplace")
+  {
+    // 1 MB template with a placeholder every line
+    String strTemplate;
+    while(strTemplate.Length() < 1024 * 1024) {
+      strTemplate += "<li>{name} ({id}) was last seen at {host} by {user}</li>\n";
+    }
+
+    BENCH("String Replace 1 placeholder in 1 MB", 20,
+      String str = strTemplate.Replace("{name}", "libscratch");
+      g_iSink += str.Length());
+
+    StackArray<String> astrNeedles;
+    StackArray<String> astrReplaces;
+    astrNeedles.Push() = "{name}"; astrReplaces.Push() = "libscratch";
+    astrNeedles.Push() = "{id}";   astrReplaces.Push() = "42";
+    astrNeedles.Push() = "{host}"; astrReplaces.Push() = "127.0.0.1";
+    astrNeedles.Push() = "{user}"; astrReplaces.Push() = "angelo";
+
+    BENCH("String Replace 4 placeholders one by one in 1 MB", 20,
+      String str = strTemplate;
+      for(INDEX i=0; i<astrNeedles.Count(); i++) {
+        str = str.Replace(astrNeedles[i], astrReplaces[i]);
+      }
+      g_iSink += str.Length());
+
+    BENCH("String ReplaceAll 4 placeholders in 1 MB", 20,
+      String str = strTemplate.ReplaceAll(astrNeedles, astrReplaces);
+      g_iSink += str.Length());
+
+    // A bigger set of variables of which only the first 4 appear in the template
+    for(INDEX i=0; i<12; i++) {
+      astrNeedles.Push() = strPrintF("{var%d}", i);
+      astrReplaces.Push() = strPrintF("value %d", i);
+    }
+
+    BENCH("String Replace 16 placeholders one by one in 1 MB", 20,
+      String str = strTemplate;
+      for(INDEX i=0; i<astrNeedles.Count(); i++) {
+        str = str.Replace(astrNeedles[i], astrReplaces[i]);
+      }
+      g_iSink += str.Length());
+
+    BENCH("String ReplaceAll 16 placeholders in 1 MB", 20,
+      String str = strTemplate.ReplaceAll(astrNeedles, astrReplaces);
+      g_iSink += str.Length());
+  }
+
+  BENCHES("StringCase")
+  {
+    // Case insensitive lookup of a request header among the usual ones
+    const char* aszHeaders[] = { "Host", "User-Agent", "Accept", "Accept-Language", "Accept-Encoding",
+      "Connection", "Cache-Control", "Cookie", "Referer", "If-Modified-Since", "Authorization",
+      "Content-Length", "Content-Type" };
+    const INDEX ctHeaders = sizeof(aszHeaders) / sizeof(aszHeaders[0]);
+    String astrHeaders[ctHeaders];
+    for(INDEX i=0; i<ctHeaders; i++) {
+      astrHeaders[i] = aszHeaders[i];
+    }
+    String strWanted = "content-type";
+
+    BENCH("String header lookup with ToLower() == ToLower()", 1000000,
+      INDEX iFound = 0;
+      while(!(astrHeaders[iFound].ToLower() == strWanted.ToLower())) {
+        iFound++;
+      }
+      g_iSink += iFound);
+
+    BENCH("String header lookup with EqualsIgnoreCase", 1000000,
+      INDEX iFound = 0;
+      while(!astrHeaders[iFound].EqualsIgnoreCase(strWanted)) {
+        iFound++;
+      }
+      g_iSink += iFound);
+
+    String strText;
+    while(strText.Length() < 4 * 1024 * 1024) {
+      strText += "Lorem Ipsum Dolor Sit Amet, Consectetur Adipiscing Elit. ";
+    }
+    String strTextUpper = strText.ToUpper();
+
+    EStringSearchLevel esslBest = strSearchGetLevel();
+    for(int iLevel=ESSL_SCALAR; iLevel<=esslBest; iLevel++) {
+      strSearchSetLevel((EStringSearchLevel)iLevel);
+      printf("Search level %d\n", iLevel);
+
+      BENCH("String ToLower 4 MB", 100,
+        String str = strText.ToLower();
+        g_iSink += str.Length());
+
+      BENCH("String ToLowerInPlace 4 MB", 100,
+        strText.ToLowerInPlace();
+        g_iSink += strText.Length());
+
+      BENCH("String EqualsIgnoreCase 4 MB", 100,
+        g_iSink += strText.EqualsIgnoreCase(strTextUpper));
+
+      BENCH("String HashIgnoreCase 4 MB", 100,
+        g_iSink += (int)strText.HashIgnoreCase());
+    }
+    strSearchSetLevel(esslBest);
+  }
+
+  BENCHES("StringUtf8")
+  {
+    // 4 MB of mostly ASCII text with accents, CJK and emoji mixed in, and 4 MB of CJK only
+    String strMixed;
+    while(strMixed.Length() < 4 * 1024 * 1024) {
+      strMixed += "Caf\xC3\xA9 na\xC3\xAFve r\xC3\xA9sum\xC3\xA9, \xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E \xF0\x9F\x98\x80 and plain ASCII text. ";
+    }
+    String strCJK;
+    while(strCJK.Length() < 4 * 1024 * 1024) {
+      strCJK += "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x81\xAE\xE6\x96\x87\xE7\xAB\xA0";
+    }
+
+    EStringSearchLevel esslBest = strSearchGetLevel();
+    for(int iLevel=ESSL_SCALAR; iLevel<=esslBest; iLevel++) {
+      strSearchSetLevel((EStringSearchLevel)iLevel);
+      printf("Search level %d\n", iLevel);
+
+      BENCH("String IsValidUtf8 4 MB mixed", 100,
+        g_iSink += strMixed.IsValidUtf8());
+
+      BENCH("String IsValidUtf8 4 MB CJK", 100,
+        g_iSink += strCJK.IsValidUtf8());
+
+      BENCH("String Utf8Length 4 MB mixed", 100,
+        g_iSink += strMixed.Utf8Length());
+    }
+    strSearchSetLevel(esslBest);
+
+    BENCH("StringView NextCodepoint 4 MB mixed", 20,
+      StringView strRemaining = strMixed.View();
+      unsigned int iCodepoint;
+      while(strRemaining.NextCodepoint(iCodepoint)) {
+        g_iSink += iCodepoint;
+      });
+
+    BENCH("String Utf8SubString from the middle of 4 MB", 1000,
+      String str = strMixed.Utf8SubString(1000000, 16);
+      g_iSink += str.Length());
+  }
+
+  BENCHES("Hash")
+  {
+    String strData;
+    strData.Fill('x', 1024 * 1024);
+    for(INDEX i=0; i<strData.Length(); i++) {
+      strData[i] = 'a' + (i * 7919) % 26;
+    }
+
+    const INDEX aiSizes[] = { 4, 8, 16, 32, 64, 256, 1024, 4096, 65536, 1024 * 1024 };
+    for(INDEX iSize : aiSizes) {
+      // Roughly the same amount of bytes for every size
+      INDEX ctIterations = Max(100, (256 * 1024 * 1024) / Max(iSize, 64));
+      StringView strInput = strData.View(0, iSize);
+
+      BENCH((const char*)strPrintF("FNV-1a %d bytes", iSize), ctIterations,
+        unsigned int ulHash = 2166136261u;
+        for(INDEX i=0; i<iSize; i++) {
+          ulHash = (ulHash ^ (UBYTE)strInput[i]) * 16777619u;
+        }
+        g_iSink += (int)ulHash);
+
+      BENCH((const char*)strPrintF("hashBytes %d bytes", iSize), ctIterations,
+        g_iSink += (int)hashBytes(strInput.Data(), iSize, iBench));
+    }
+
+    String strHeader = "Content-Type";
+    BENCH("String ToLower().Hash() of a header name", 1000000,
+      g_iSink += (int)strHeader.ToLower().Hash());
+    BENCH("String HashIgnoreCase of a header name", 1000000,
+      g_iSink += (int)strHeader.HashIgnoreCase());
+  }
+
+  BENCHES("StringSearch")
+  {
+    // 4 MB of text with the needles only at the very start and the very end
+    const INDEX ctSize = 4 * 1024 * 1024;
+    String strHaystack = "header: ";
+    strHaystack.Reserve(ctSize + 64);
+    while(strHaystack.Length() < ctSize) {
+      strHaystack += "lorem ipsum dolor sit amet, consectetur adipiscing elit. ";
+    }
+    strHaystack += "needle; the end";
+
+    EStringSearchLevel esslBest = strSearchGetLevel();
+    for(int iLevel=ESSL_SCALAR; iLevel<=esslBest; iLevel++) {
+      strSearchSetLevel((EStringSearchLevel)iLevel);
+      printf("Search level %d\n", iLevel);
+
+      BENCH("String IndexOf char in 4 MB", 100,
+        g_iSink += strHaystack.IndexOf(';'));
+
+      BENCH("String IndexOf needle in 4 MB", 100,
+        g_iSink += strHaystack.IndexOf("needle;"));
+
+      BENCH("String IndexOfLast char in 4 MB", 100,
+        g_iSink += strHaystack.IndexOfLast(':'));
+
+      BENCH("String IndexOfLast needle in 4 MB", 100,
+        g_iSink += strHaystack.IndexOfLast("header:"));
+
+      BENCH("String Contains needle in 4 MB", 100,
+        g_iSink += strHaystack.Contains("needle;"));
+
+      BENCH("String Split 4 MB on rare needle", 100,
+        StackArray<String> astrParts;
+        strHaystack.Split("needle;", astrParts);
+        g_iSink += astrParts.Count());
+    }
+    strSearchSetLevel(esslBest);
+  }
+
+  BENCHES("StackArray")
+  {
+    // Pushing should cost the same per object no matter how big the stack gets. Only pointers
+    // are pushed, so this measures the slots and not the objects.
+    for(INDEX ctObjects=1000; ctObjects<=1000000; ctObjects*=10) {
+      StackArray<int> ai;
+      BENCH((const char*)strPrintF("StackArray push up to %d, per push", ctObjects), 1000000,
+        ai.Push((int*)NULL);
+        if(ai.Count() == ctObjects) {
+          ai.PopAll();
+          ai = StackArray<int>();
+        });
+    }
+
+    StackArray<int> aiRead;
+    for(INDEX i=0; i<1000000; i++) {
+      aiRead.Push() = i;
+    }
+    BENCH("StackArray<int> read 1M through operator[]", 20,
+      INDEX iSum = 0;
+      for(INDEX i=0; i<aiRead.Count(); i++) {
+        iSum += aiRead[i];
+      }
+      g_iSink += iSum);
+
+    // Purging many objects at once, on a stack of 100k pointers that doesn't own them so only
+    // the removal itself is measured. Refilling the stack is part of every iteration.
+    static int aiValues[100000];
+    for(INDEX i=0; i<100000; i++) {
+      aiValues[i] = i;
+    }
+    StackArray<int> aiPurge;
+    aiPurge.sa_bOnlyPop = TRUE;
+    aiPurge.Reserve(100000);
+    auto fillPurge = [&aiPurge]() {
+      aiPurge.PopAll();
+      for(INDEX i=0; i<100000; i++) {
+        aiPurge.Push(&aiValues[i]);
+      }
+    };
+
+    BENCH("StackArray remove every 3rd of 100k with PopAt", 3,
+      fillPurge();
+      for(INDEX i=aiPurge.Count() - 1; i>=0; i--) {
+        if(aiPurge[i] % 3 == 0) {
+          aiPurge.PopAt(i);
+        }
+      }
+      g_iSink += aiPurge.Count());
+
+    BENCH("StackArray remove every 3rd of 100k with RemoveIf", 3,
+      fillPurge();
+      aiPurge.RemoveIf([](int &i) { return i % 3 == 0; });
+      g_iSink += aiPurge.Count());
+
+    BENCH("StackArray remove 50k from the middle of 100k with PopAt", 3,
+      fillPurge();
+      for(INDEX i=0; i<50000; i++) {
+        aiPurge.PopAt(25000);
+      }
+      g_iSink += aiPurge.Count());
+
+    BENCH("StackArray remove 50k from the middle of 100k with RemoveRange", 3,
+      fillPurge();
+      aiPurge.RemoveRange(25000, 50000);
+      g_iSink += aiPurge.Count());
+
+    BENCH("StackArray remove 50k at random of 100k with SwapRemoveAt", 3,
+      fillPurge();
+      for(INDEX i=0; i<50000; i++) {
+        aiPurge.SwapRemoveAt(rand() % aiPurge.Count());
+      }
+      g_iSink += aiPurge.Count());
+
+    BENCH("StackArray refill 100k, for reference", 3,
+      fillPurge();
+      g_iSink += aiPurge.Count());
+  }
+
+  BENCHES("StackArraySort")
+  {
+    // Sorting 10M shuffled objects, restoring the shuffled pointers before every sort. The stacks
+    // don't own the objects, so the restore is a single memcpy.
+    const INDEX ctSort = 10000000;
+    INDEX* aiValues = new INDEX[ctSort];
+    String* astrValues = new String[ctSort];
+    for(INDEX i=0; i<ctSort; i++) {
+      aiValues[i] = rand();
+      astrValues[i] = strPrintF("item %08x", (unsigned int)rand());
+    }
+
+    StackArray<INDEX> aiSort;
+    StackArray<String> astrSort;
+    aiSort.sa_bOnlyPop = TRUE;
+    astrSort.sa_bOnlyPop = TRUE;
+    aiSort.Reserve(ctSort);
+    astrSort.Reserve(ctSort);
+    for(INDEX i=0; i<ctSort; i++) {
+      aiSort.Push(&aiValues[i]);
+      astrSort.Push(&astrValues[i]);
+    }
+    INDEX** apiShuffled = (INDEX**)malloc(sizeof(INDEX*) * ctSort);
+    String** apstrShuffled = (String**)malloc(sizeof(String*) * ctSort);
+    memcpy(apiShuffled, aiSort.sa_pItems, sizeof(INDEX*) * ctSort);
+    memcpy(apstrShuffled, astrSort.sa_pItems, sizeof(String*) * ctSort);
+
+    BENCH("StackArray<INDEX> restore 10M, for reference", 3,
+      memcpy(aiSort.sa_pItems, apiShuffled, sizeof(INDEX*) * ctSort);
+      g_iSink += aiSort[0]);
+
+    BENCH("StackArray<INDEX> Sort 10M", 1,
+      memcpy(aiSort.sa_pItems, apiShuffled, sizeof(INDEX*) * ctSort);
+      aiSort.Sort();
+      g_iSink += aiSort[0]);
+
+    BENCH("StackArray<INDEX> StableSort 10M", 1,
+      memcpy(aiSort.sa_pItems, apiShuffled, sizeof(INDEX*) * ctSort);
+      aiSort.StableSort();
+      g_iSink += aiSort[0]);
+
+    for(INDEX ctThreads=1; ctThreads<=16; ctThreads*=4) {
+      BENCH((const char*)strPrintF("StackArray<INDEX> ParallelSort 10M, %d threads", ctThreads), 1,
+        memcpy(aiSort.sa_pItems, apiShuffled, sizeof(INDEX*) * ctSort);
+        saParallelSort(aiSort, ctThreads);
+        g_iSink += aiSort[0]);
+    }
+
+    BENCH("StackArray<String> Sort 10M", 1,
+      memcpy(astrSort.sa_pItems, apstrShuffled, sizeof(String*) * ctSort);
+      astrSort.Sort();
+      g_iSink += astrSort[0].Length());
+
+    for(INDEX ctThreads=1; ctThreads<=16; ctThreads*=4) {
+      BENCH((const char*)strPrintF("StackArray<String> ParallelSort 10M, %d threads", ctThreads), 1,
+        memcpy(astrSort.sa_pItems, apstrShuffled, sizeof(String*) * ctSort);
+        saParallelSort(astrSort, ctThreads);
+        g_iSink += astrSort[0].Length());
+    }
+
+    // Looking up 1M values in the sorted stack, against a linear Find on a 10k slice of it
+    BENCH("StackArray<INDEX> BinarySearch 10M, 1M lookups", 1,
+      for(INDEX i=0; i<1000000; i++) {
+        g_iSink += aiSort.BinarySearch(aiValues[i]);
+      });
+
+    StackArray<INDEX> aiFind;
+    aiFind.sa_bOnlyPop = TRUE;
+    for(INDEX i=0; i<10000; i++) {
+      aiFind.Push(&aiValues[i]);
+    }
+    BENCH("StackArray<INDEX> Find 10k, 1k lookups", 1,
+      for(INDEX i=0; i<1000; i++) {
+        g_iSink += aiFind.Find(aiValues[i * 7]);
+      });
+
+    aiSort.PopAll();
+    astrSort.PopAll();
+    aiFind.PopAll();
+    free(apiShuffled);
+    free(apstrShuffled);
+    delete[] aiValues;
+    delete[] astrValues;
+  }
+
+  BENCHES("ThreadPool")
+  {
+    // Independent work over every object of 1M, serially and on pools of 1 up to 16 threads
+    StackArray<INDEX> aiWork;
+    for(INDEX i=0; i<1000000; i++) {
+      aiWork.Push() = i;
+    }
+    StackArray<INDEX> aiTransform;
+    for(INDEX i=0; i<100000; i++) {
+      aiTransform.Push() = i;
+    }
+    auto fExpensive = [](INDEX &i) { return (Hasher<INDEX>::Hash(i) & 7) == 0; };
+
+    BENCH("Serial FindAny miss 1M", 5,
+      g_iSink += aiWork.FindAny([&fExpensive](INDEX &i) { return fExpensive(i) && i < 0; }));
+
+    BENCH("Serial count 1M", 5,
+      INDEX ct = 0;
+      for(INDEX i=0; i<aiWork.Count(); i++) {
+        ct += fExpensive(aiWork[i]) ? 1 : 0;
+      }
+      g_iSink += ct);
+
+    INDEX ctMaxThreads = Max((INDEX)std::thread::hardware_concurrency(), (INDEX)16);
+    for(INDEX ctThreads=1; ctThreads<=ctMaxThreads; ctThreads*=2) {
+      ThreadPool pool(ctThreads);
+
+      BENCH((const char*)strPrintF("ParallelFindAny miss 1M, %d threads", ctThreads), 5,
+        g_iSink += saParallelFindAny(aiWork, [&fExpensive](INDEX &i) { return fExpensive(i) && i < 0; }, CTHREADPOOL_DEFAULT_GRAIN, pool));
+
+      BENCH((const char*)strPrintF("ParallelCount 1M, %d threads", ctThreads), 5,
+        g_iSink += saParallelCount(aiWork, fExpensive, CTHREADPOOL_DEFAULT_GRAIN, pool));
+
+      BENCH((const char*)strPrintF("ParallelForEach 1M, %d threads", ctThreads), 5,
+        saParallelForEach(aiWork, [](INDEX &i) { i = (INDEX)(Hasher<INDEX>::Hash(i) >> 40); }, CTHREADPOOL_DEFAULT_GRAIN, pool);
+        g_iSink += aiWork[0]);
+
+      BENCH((const char*)strPrintF("ParallelTransform to String 100k, %d threads", ctThreads), 5,
+        StackArray<String> astr;
+        saParallelTransform(aiTransform, astr, [](INDEX &i) { return strPrintF("%d", i); }, CTHREADPOOL_DEFAULT_GRAIN, pool);
+        g_iSink += astr.Count());
+    }
+
+    // Grain size trade-off: handing out chunks against spreading the work evenly
+    ThreadPool poolGrain(4);
+    for(INDEX ctGrain=16; ctGrain<=65536; ctGrain*=16) {
+      BENCH((const char*)strPrintF("ParallelCount 1M, 4 threads, grain %d", ctGrain), 5,
+        g_iSink += saParallelCount(aiWork, fExpensive, ctGrain, poolGrain));
+    }
+  }
+
+  BENCHES("Iterators")
+  {
+    // Summing 10M objects through an index and through range-for
+    StackArray<INDEX> aiSum;
+    aiSum.Reserve(10000000);
+    for(INDEX i=0; i<10000000; i++) {
+      aiSum.Push() = i & 0xFF;
+    }
+
+    BENCH("StackArray<INDEX> sum 10M through operator[]", 5,
+      INDEX iSum = 0;
+      for(INDEX i=0; i<aiSum.Count(); i++) {
+        iSum += aiSum[i];
+      }
+      g_iSink += iSum);
+
+    BENCH("StackArray<INDEX> sum 10M through range-for", 5,
+      INDEX iSum = 0;
+      for(INDEX i : aiSum) {
+        iSum += i;
+      }
+      g_iSink += iSum);
+
+    aiSum.Clear();
+    aiSum.ShrinkToFit();
+
+    Dictionary<INDEX, INDEX> dicSum;
+    for(INDEX i=0; i<10000000; i++) {
+      *dicSum.Push(i).value = i & 0xFF;
+    }
+
+    BENCH("Dictionary<INDEX, INDEX> sum 10M through GetKey/ValueByIndex", 5,
+      INDEX iSum = 0;
+      for(INDEX i=0; i<dicSum.Count(); i++) {
+        iSum += dicSum.GetKeyByIndex(i) ^ dicSum.GetValueByIndex(i);
+      }
+      g_iSink += iSum);
+
+    BENCH("Dictionary<INDEX, INDEX> sum 10M through range-for", 5,
+      INDEX iSum = 0;
+      for(DictionaryPair<INDEX, INDEX> pair : dicSum) {
+        iSum += *pair.key ^ *pair.value;
+      }
+      g_iSink += iSum);
+  }
+
+  BENCHES("ConcurrentArray")
+  {
+    // Threads pushing 1M objects between them, into a StackArray guarded by a Mutex and into a ConcurrentArray
+    const INDEX ctObjects = 1000000;
+    for(INDEX ctThreads=1; ctThreads<=8; ctThreads*=2) {
+      BENCH((const char*)strPrintF("StackArray with Mutex, %d threads push 1M", ctThreads), 5,
+        StackArray<int> ai;
+        Mutex mutex;
+        std::thread athWorkers[8];
+        for(INDEX iThread=0; iThread<ctThreads; iThread++) {
+          athWorkers[iThread] = std::thread([&ai, &mutex, ctThreads, ctObjects]() {
+            for(INDEX i=0; i<ctObjects / ctThreads; i++) {
+              MutexWait wait(mutex);
+              ai.Push((int*)NULL);
+            }
+          });
+        }
+        for(INDEX iThread=0; iThread<ctThreads; iThread++) {
+          athWorkers[iThread].join();
+        }
+        ai.PopAll();
+        g_iSink += ai.Count());
+
+      BENCH((const char*)strPrintF("ConcurrentArray, %d threads push 1M", ctThreads), 5,
+        ConcurrentArray<int> ai;
+        std::thread athWorkers[8];
+        for(INDEX iThread=0; iThread<ctThreads; iThread++) {
+          athWorkers[iThread] = std::thread([&ai, ctThreads, ctObjects]() {
+            for(INDEX i=0; i<ctObjects / ctThreads; i++) {
+              ai.Push(i);
+            }
+          });
+        }
+        for(INDEX iThread=0; iThread<ctThreads; iThread++) {
+          athWorkers[iThread].join();
+        }
+        g_iSink += ai.Count());
+    }
+
+    // Threads all reading the same 1M objects
+    StackArray<int> aiStack;
+    ConcurrentArray<int> aiConcurrent;
+    for(INDEX i=0; i<ctObjects; i++) {
+      aiStack.Push() = i;
+      aiConcurrent.Push(i);
+    }
+    for(INDEX ctThreads=1; ctThreads<=8; ctThreads*=2) {
+      BENCH((const char*)strPrintF("StackArray with Mutex, %d threads read 1M each", ctThreads), 5,
+        Mutex mutex;
+        std::thread athWorkers[8];
+        for(INDEX iThread=0; iThread<ctThreads; iThread++) {
+          athWorkers[iThread] = std::thread([&aiStack, &mutex, ctObjects]() {
+            INDEX iSum = 0;
+            for(INDEX i=0; i<ctObjects; i++) {
+              MutexWait wait(mutex);
+              iSum += aiStack[i];
+            }
+            g_iSink += iSum;
+          });
+        }
+        for(INDEX iThread=0; iThread<ctThreads; iThread++) {
+          athWorkers[iThread].join();
+        });
+
+      BENCH((const char*)strPrintF("ConcurrentArray, %d threads read 1M each", ctThreads), 5,
+        std::thread athWorkers[8];
+        for(INDEX iThread=0; iThread<ctThreads; iThread++) {
+          athWorkers[iThread] = std::thread([&aiConcurrent, ctObjects]() {
+            INDEX iSum = 0;
+            for(INDEX i=0; i<ctObjects; i++) {
+              iSum += aiConcurrent[i];
+            }
+            g_iSink += iSum;
+          });
+        }
+        for(INDEX iThread=0; iThread<ctThreads; iThread++) {
+          athWorkers[iThread].join();
+        });
+    }
+  }
+
+  BENCHES("Array")
+  {
+    // Bulk numbers and small records, stored as pointers to each element and stored in place
+    struct Particle
+    {
+      float x, y, z;
+      int iID;
+    };
+
+    BENCH("StackArray<int> push 100k", 100,
+      StackArray<int> ai;
+      for(INDEX i=0; i<100000; i++) {
+        ai.Push() = i;
+      }
+      g_iSink += ai.Count());
+
+    BENCH("Array<int> push 100k", 100,
+      Array<int> ai;
+      for(INDEX i=0; i<100000; i++) {
+        ai.Push(i);
+      }
+      g_iSink += ai.Count());
+
+    BENCH("Array<int> push 100k after Reserve", 100,
+      Array<int> ai;
+      ai.Reserve(100000);
+      for(INDEX i=0; i<100000; i++) {
+        ai.Push(i);
+      }
+      g_iSink += ai.Count());
+
+    BENCH("StackArray<Particle> push 100k", 100,
+      StackArray<Particle> ap;
+      for(INDEX i=0; i<100000; i++) {
+        Particle &p = ap.Push();
+        p.x = p.y = p.z = (float)i;
+        p.iID = i;
+      }
+      g_iSink += ap.Count());
+
+    BENCH("Array<Particle> push 100k", 100,
+      Array<Particle> ap;
+      for(INDEX i=0; i<100000; i++) {
+        Particle &p = ap.Push();
+        p.x = p.y = p.z = (float)i;
+        p.iID = i;
+      }
+      g_iSink += ap.Count());
+
+    StackArray<Particle> apStack;
+    Array<Particle> apArray;
+    for(INDEX i=0; i<1000000; i++) {
+      Particle p = { (float)i, (float)(i * 2), (float)(i * 3), i };
+      apStack.Push() = p;
+      apArray.Push(p);
+    }
+
+    // Shuffle the pointers around, like they end up after a while of pushing and popping
+    for(INDEX i=apStack.Count() - 1; i>0; i--) {
+      Swap(apStack.sa_pItems[i], apStack.sa_pItems[rand() % (i + 1)]);
+    }
+
+    BENCH("StackArray<Particle> sum 1M", 20,
+      float fSum = 0.0f;
+      INDEX ct = apStack.Count();
+      for(INDEX i=0; i<ct; i++) {
+        fSum += apStack[i].y;
+      }
+      g_iSink += (int)fSum);
+
+    BENCH("Array<Particle> sum 1M", 20,
+      float fSum = 0.0f;
+      INDEX ct = apArray.Count();
+      for(INDEX i=0; i<ct; i++) {
+        fSum += apArray[i].y;
+      }
+      g_iSink += (int)fSum);
+
+    BENCH("Array<Particle> copy 1M", 20,
+      Array<Particle> apCopy(apArray);
+      g_iSink += apCopy[iBench].iID);
+
+    BENCH("Array<String> push 10k", 100,
+      Array<String> astr;
+      for(INDEX i=0; i<10000; i++) {
+        astr.Push("short");
+      }
+      g_iSink += astr.Count());
+
+    BENCH("StackArray<String> push 10k", 100,
+      StackArray<String> astr;
+      for(INDEX i=0; i<10000; i++) {
+        astr.Push() = "short";
+      }
+      g_iSink += astr.Count());
+  }
+
+  BENCHES("Deque")
+  {
+    // Work queues of different lengths, taking jobs from the front and adding new ones at the back
+    for(INDEX ctQueued=100; ctQueued<=100000; ctQueued*=10) {
+      StackArray<int> aiStack;
+      Deque<int> aiDeque;
+      for(INDEX i=0; i<ctQueued; i++) {
+        aiStack.Push() = i;
+        aiDeque.Push(i);
+      }
+
+      BENCH((const char*)strPrintF("StackArray<int> queue of %d, 10k pop and push", ctQueued), 5,
+        for(INDEX i=0; i<10000; i++) {
+          int* piJob = aiStack.PopAt(0);
+          aiStack.Push(piJob);
+        }
+        g_iSink += aiStack[0]);
+
+      BENCH((const char*)strPrintF("Deque<int> queue of %d, 10k pop and push", ctQueued), 5,
+        for(INDEX i=0; i<10000; i++) {
+          int iJob = aiDeque.PopBegin();
+          aiDeque.Push(iJob);
+        }
+        g_iSink += aiDeque[0]);
+    }
+
+    BENCH("StackArray<int> PushBegin 10k", 20,
+      StackArray<int> ai;
+      for(INDEX i=0; i<10000; i++) {
+        ai.PushBegin() = i;
+      }
+      g_iSink += ai[0]);
+
+    BENCH("Deque<int> PushBegin 10k", 20,
+      Deque<int> ai;
+      for(INDEX i=0; i<10000; i++) {
+        ai.PushBegin(i);
+      }
+      g_iSink += ai[0]);
+
+    // Summing through a wrapped around deque, per index and per contiguous block
+    Deque<int> aiWrapped;
+    for(INDEX i=0; i<1000000; i++) {
+      aiWrapped.Push(i);
+    }
+    for(INDEX i=0; i<300000; i++) {
+      aiWrapped.Push(aiWrapped.PopBegin());
+    }
+
+    BENCH("Deque<int> sum 1M per index", 20,
+      int iSum = 0;
+      INDEX ct = aiWrapped.Count();
+      for(INDEX i=0; i<ct; i++) {
+        iSum += aiWrapped[i];
+      }
+      g_iSink += iSum);
+
+    BENCH("Deque<int> sum 1M per block", 20,
+      int iSum = 0;
+      aiWrapped.ForEachBlock([&iSum](int* pi, INDEX ct) {
+        for(INDEX i=0; i<ct; i++) {
+          iSum += pi[i];
+        }
+      });
+      g_iSink += iSum);
+  }
+
+  BENCHES("SmallArray")
+  {
+    // Arrays that only ever hold a handful of objects, like the parts of a short key
+    const INDEX ctIterations = 1000000;
+    String strKey = "cache:user:42:name";
+
+    BENCH("StackArray<String> split short key", ctIterations,
+      StackArray<String> astr;
+      strKey.Split(":", astr);
+      g_iSink += astr.Count());
+
+    BENCH("SmallArray<String, 8> split short key", ctIterations,
+      SmallArray<String, 8> astr;
+      strKey.Split(":", astr);
+      g_iSink += astr.Count());
+
+    BENCH("StackArray<int> push 4", ctIterations,
+      StackArray<int> ai;
+      for(INDEX i=0; i<4; i++) {
+        ai.Push() = i;
+      }
+      g_iSink += ai[3]);
+
+    BENCH("Array<int> push 4", ctIterations,
+      Array<int> ai;
+      for(INDEX i=0; i<4; i++) {
+        ai.Push(i);
+      }
+      g_iSink += ai[3]);
+
+    BENCH("SmallArray<int, 8> push 4", ctIterations,
+      SmallArray<int, 8> ai;
+      for(INDEX i=0; i<4; i++) {
+        ai.Push(i);
+      }
+      g_iSink += ai[3]);
+
+    BENCH("SmallArray<int, 8> push 32, spilling to the heap", ctIterations / 10,
+      SmallArray<int, 8> ai;
+      for(INDEX i=0; i<32; i++) {
+        ai.Push(i);
+      }
+      g_iSink += ai[31]);
+  }
+
+  return 0;
+}
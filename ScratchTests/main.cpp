@@ -1,4 +1,9 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <atomic>
+#include <locale.h>
+#include <thread>
 
 // This is so that we can access private fields for
 // checking their values in tests.
@@ -14,12 +19,61 @@
 #endif
 
 #include <Scratch.h>
+#include <CVectors.h>
 using namespace Scratch;
 
 static int g_iTestNumber = 1;
 static int g_iTestOK = 0;
 static int g_iTestFailed = 0;
 
+// Count allocations so tests can check that operations don't hit the heap. Atomic, since the
+// ThreadPool tests allocate from several threads at once.
+static std::atomic<int> g_ctAllocations(0);
+
+// Both forms of new allocate through here and both forms of delete free through CountedFree, so every
+// new is matched with the delete of its own form instead of one form calling into the other.
+static void* CountedAlloc(size_t size)
+{
+  g_ctAllocations++;
+  void* p = malloc(size > 0 ? size : 1);
+  if(p == NULL) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+static void CountedFree(void* p)
+{
+  free(p);
+}
+
+void* operator new(size_t size)
+{
+  return CountedAlloc(size);
+}
+
+void* operator new[](size_t size)
+{
+  return CountedAlloc(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t &) noexcept
+{
+  // used for the temporary buffer of std::stable_sort, and must be freed the same way
+  g_ctAllocations++;
+  return malloc(size > 0 ? size : 1);
+}
+
+void operator delete(void* p) noexcept
+{
+  CountedFree(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  CountedFree(p);
+}
+
 #if DEBUG
   #if WINDOWS
     #define TEST_BREAK() __asm { int 3 };
@@ -97,6 +151,30 @@ MAIN
     strFoo = "";
     TEST_PRIVATE(strFoo.str_szBuffer == String::str_szEmpty);
 
+    strFoo = "short string";
+    TEST_PRIVATE(strFoo.str_szBuffer == strFoo.str_acInline);
+    strFoo += " that grows too long";
+    TEST_PRIVATE(strFoo.IsHeapBuffer());
+    TEST(strFoo == "short string that grows too long");
+
+    String strSub = strFoo.SubString(6, 6);
+    TEST(strSub == "string");
+    TEST_PRIVATE(strSub.str_szBuffer == strSub.str_acInline);
+    TEST(strFoo.SubString(26, 100) == "o long");
+
+    strFoo = "";
+    strFoo.Reserve(100);
+    TEST(strFoo.Capacity() >= 100);
+    for(int i=0; i<100; i++) {
+      strFoo += 'x';
+    }
+    TEST(strFoo.Length() == 100);
+    TEST(strFoo.Capacity() >= 100);
+    strFoo = "abc";
+    strFoo.ShrinkToFit();
+    TEST(strFoo.Length() == 3 && strFoo.Capacity() < 100);
+    TEST_PRIVATE(strFoo.str_szBuffer == strFoo.str_acInline);
+
     int x = 5;
     int y = 10;
     strFoo.SetF("%d %d", x, y);
@@ -110,6 +188,31 @@ MAIN
     TEST(aParse.Count() == 3);
     TEST(aParse[0] == "5" && aParse[1] == "10" && aParse[2] == "5");
 
+    StackArray<String> astrArguments;
+    String(" run  --name \"Hello \\\"World\\\"\" \"a\"b\" c\\ d\t\"\" e\\").CommandLineSplit(astrArguments);
+    TEST(astrArguments.Count() == 7);
+    TEST(astrArguments[0] == "run" && astrArguments[1] == "--name");
+    TEST(astrArguments[2] == "Hello \"World\"");
+    TEST(astrArguments[3] == "a\"b");
+    TEST(astrArguments[4] == "c d");
+    TEST(astrArguments[5] == "");
+    TEST(astrArguments[6] == "e\\");
+
+    // Arguments without escapes are views on the string itself
+    {
+      String strCommand = "say \"two words\" \\\"quoted\\\" end";
+      const char* szCommand = strCommand;
+      bool bInPlace = true;
+      int ctAllocations = g_ctAllocations;
+      INDEX ctArguments = strCommand.CommandLineSplit([&](const StringView &strArgument) {
+        bInPlace &= (strArgument.Data() >= szCommand && strArgument.Data() < szCommand + strCommand.Length()) == (strArgument != "\"quoted\"");
+      });
+      TEST(ctArguments == 4);
+      TEST(bInPlace);
+      TEST(g_ctAllocations == ctAllocations);
+      TEST(String("  \t ").CommandLineSplit([](const StringView &) {}) == 0);
+    }
+
     strFoo = "     Foo  ";
     TEST(strFoo.Trim() == "Foo");
     TEST(strFoo.TrimLeft() == "Foo  ");
@@ -122,6 +225,46 @@ MAIN
 
     strFoo = "a a b b a";
     TEST(strFoo.Replace("b", "a") == "a a a a a");
+    TEST(strFoo.Replace("a", "") == "  b b ");
+    TEST(strFoo.Replace(" ", "") == "aabba");
+    TEST(strFoo.Replace("a a", "x") == "x b b a");
+    TEST(strFoo.Replace("c", "x") == strFoo);
+    TEST(strFoo.Replace("", "x") == strFoo);
+    TEST(String("aaa").Replace("a", "") == "");
+    TEST(String("ab").Replace("ab", "this replacement needs the heap") == "this replacement needs the heap");
+
+    StackArray<String> astrNeedles;
+    StackArray<String> astrReplaces;
+    astrNeedles.Push() = "{name}";   astrReplaces.Push() = "libscratch";
+    astrNeedles.Push() = "{author}"; astrReplaces.Push() = "Angelo";
+    astrNeedles.Push() = "{n}";      astrReplaces.Push() = "";
+    strFoo = "{name} by {author}{n}, {name}!{nam";
+    TEST(strFoo.ReplaceAll(astrNeedles, astrReplaces) == "libscratch by Angelo, libscratch!{nam");
+    TEST(String("no placeholders").ReplaceAll(astrNeedles, astrReplaces) == "no placeholders");
+
+    // The tables can be passed as const, and more matches than the first batch of slots still work
+    const StackArray<String> &astrConstNeedles = astrNeedles;
+    const StackArray<String> &astrConstReplaces = astrReplaces;
+    String strMany;
+    for(int i=0; i<200; i++) {
+      strMany += "{author}{n}";
+    }
+    strMany = strMany.ReplaceAll(astrConstNeedles, astrConstReplaces);
+    TEST(strMany.Length() == 200 * 6 && strMany.StartsWith("AngeloAngelo"));
+
+    // Leftmost match wins, then the longest one starting there
+    astrNeedles.Clear();
+    astrReplaces.Clear();
+    astrNeedles.Push() = "bcd";    astrReplaces.Push() = "1";
+    astrNeedles.Push() = "abcdef"; astrReplaces.Push() = "2";
+    astrNeedles.Push() = "ab";     astrReplaces.Push() = "3";
+    astrNeedles.Push() = "de";     astrReplaces.Push() = "4";
+    astrNeedles.Push() = "";       astrReplaces.Push() = "5";
+    TEST(String("abcdef abcdx bcde").ReplaceAll(astrNeedles, astrReplaces) == "2 3cdx 1e");
+    TEST(String("xabcde").ReplaceAll(astrNeedles, astrReplaces) == "x3c4");
+    TEST(String("abab").ReplaceAll(astrNeedles, astrReplaces) == "33");
+
+    strFoo = "a a b b a";
 
     TEST(strFoo.SubString(4, 3) == "b b");
 
@@ -140,6 +283,7 @@ MAIN
     TEST(strFoo.StartsWith("Baaa"));
     TEST(strFoo.EndsWith("aaaB"));
     TEST(!strFoo.EndsWith("Xaaa"));
+    TEST(String("abab").EndsWith("ab"));
 
     TEST_PRIVATE((const char*)strFoo == strFoo.str_szBuffer);
 
@@ -158,6 +302,641 @@ MAIN
     TEST(strFoo * 3 == "xxx");
 
     TEST(strPrintF("Hello %d %d", x, y) == "Hello 5 10");
+
+    TEST('<' + strFoo + '>' == "<x>");
+    TEST("<" + strFoo.ToUpper() + ">" == "<X>");
+
+    {
+      String strHeader = "Content-Type";
+      int ctAllocations = g_ctAllocations;
+      TEST(strHeader.EqualsIgnoreCase("content-TYPE") && !strHeader.EqualsIgnoreCase("content-typ"));
+      TEST(strHeader.CompareIgnoreCase("CONTENT-TYPE") == 0 && strHeader.CompareIgnoreCase("content-length") > 0);
+      TEST(strHeader.CompareIgnoreCase("content-typeS") < 0 && String("[").CompareIgnoreCase("a") < 0);
+      TEST(strHeader.StartsWithIgnoreCase("CONTENT-") && !strHeader.StartsWithIgnoreCase("Content-Types"));
+      TEST(strHeader.HashIgnoreCase() == String("content-type").HashIgnoreCase());
+      TEST(strHeader.HashIgnoreCase() != String("content-typf").HashIgnoreCase());
+      TEST(g_ctAllocations == ctAllocations);
+      strHeader.ToLowerInPlace();
+      TEST(strHeader == "content-type");
+      strHeader.ToUpperInPlace();
+      TEST(strHeader == "CONTENT-TYPE" && strHeader.ToLower() == "content-type");
+    }
+
+    String strLarge;
+    strLarge.Fill('x', 1000);
+    const char* szLarge = strLarge;
+    int ctAllocations = g_ctAllocations;
+    String strMoved(std::move(strLarge));
+    TEST(g_ctAllocations == ctAllocations);
+    TEST((const char*)strMoved == szLarge && strMoved.Length() == 1000);
+    TEST(strLarge.Length() == 0);
+    strFoo = std::move(strMoved);
+    TEST(g_ctAllocations == ctAllocations);
+    TEST((const char*)strFoo == szLarge);
+
+    strFoo = std::move(strFoo) + "!";
+    TEST(g_ctAllocations == ctAllocations + 1); // grows once, no copy of the left hand side
+    TEST(strFoo.Length() == 1001);
+
+    // Copies share the buffer until one of them changes
+    ctAllocations = g_ctAllocations;
+    String strCopy = strFoo;
+    String strAssigned;
+    strAssigned = strCopy;
+    TEST(g_ctAllocations == ctAllocations);
+    TEST((const char*)strCopy == (const char*)strFoo && (const char*)strAssigned == (const char*)strFoo);
+    strCopy[0] = 'y';
+    TEST(g_ctAllocations == ctAllocations + 1);
+    TEST(strCopy[0] == 'y' && strFoo[0] == 'x' && strAssigned[0] == 'x');
+    strAssigned += "?";
+    TEST(strAssigned.EndsWith("!?") && strFoo.EndsWith("x!") && strCopy.Length() == 1001);
+    strCopy = strFoo;
+    strCopy.Reserve(10);
+    TEST_PRIVATE(strCopy.str_szBuffer != strFoo.str_szBuffer);
+    strCopy = strFoo;
+    strCopy = "short";
+    strAssigned = strFoo;
+    strAssigned.Fill('z', 5);
+    TEST(strFoo.Length() == 1001 && strFoo[1000] == '!' && strCopy == "short" && strAssigned == "zzzzz");
+
+    StackArray<String> astrShared;
+    astrShared.Push() = strFoo;
+    astrShared.Push() = strFoo;
+    StackArray<String> astrCopy(astrShared);
+    astrCopy[1] += "?";
+    TEST(astrCopy[0] == strFoo && astrShared[1] == strFoo && astrCopy[1].EndsWith("!?"));
+
+    // References and pointers handed out by operator[] never write into a copy
+    String strOriginal;
+    strOriginal.Fill('a', 100);
+    char &cRef = strOriginal[0];
+    String strRefCopy(strOriginal);
+    cRef = 'X';
+    TEST(strOriginal[0] == 'X' && strRefCopy[0] == 'a');
+    char* pcWrite = &strOriginal[50];
+    String strPointerCopy;
+    strPointerCopy = strOriginal;
+    *pcWrite = 'Y';
+    TEST(strOriginal[50] == 'Y' && strPointerCopy[50] == 'a' && strRefCopy[50] == 'a');
+    const String &strConstOriginal = strPointerCopy;
+    String strConstCopy(strConstOriginal);
+    TEST(strConstOriginal[1] == 'a');
+    TEST((const char*)strConstCopy != (const char*)strOriginal);
+  }
+
+  TESTS("StringView")
+  {
+    String strLine = "  2015-06-01 [info] request served  ";
+    StringView strView = strLine.View().Trim();
+    TEST(strView == "2015-06-01 [info] request served");
+    TEST(strView.Data() == (const char*)strLine + 2);
+
+    TEST(strView.StartsWith("2015"));
+    TEST(strView.EndsWith("served"));
+    TEST(!strView.EndsWith("2015"));
+    TEST(strView.IndexOf('[') == 11);
+    TEST(strView.IndexOf("info") == 12);
+    TEST(strView.IndexOf("warning") == -1);
+    TEST(strView.IndexOfLast('e') == 30);
+    TEST(strView.IndexOfLast("se") == 26);
+    TEST(strView.Contains("request"));
+    TEST(strView.SubString(12, 4) == "info");
+    TEST(strView.SubString(26) == "served");
+    TEST(strView.SubString(100, 4).Length() == 0);
+    TEST(StringView("..x..").Trim('.') == "x");
+    TEST(StringView("..x..").TrimLeft('.') == "x..");
+    TEST(StringView("..x..").TrimRight('.') == "..x");
+
+    int ctAllocations = g_ctAllocations;
+    StringView astrParts[4];
+    INDEX ctParts = strView.Split(" ", [&astrParts](const StringView &strPart) {
+      astrParts[0] = astrParts[1];
+      astrParts[1] = astrParts[2];
+      astrParts[2] = strPart;
+    });
+    TEST(g_ctAllocations == ctAllocations);
+    TEST(ctParts == 4);
+    TEST(astrParts[1] == "request" && astrParts[2] == "served");
+
+    StringView strRemaining = "a;;b;";
+    StringView strPart;
+    TEST(strRemaining.SplitNext(";", strPart) && strPart == "a");
+    TEST(strRemaining.SplitNext(";", strPart) && strPart == "");
+    TEST(strRemaining.SplitNext(";", strPart) && strPart == "b");
+    TEST(strRemaining.SplitNext(";", strPart) && strPart == "");
+    TEST(!strRemaining.SplitNext(";", strPart));
+
+    String strCopy(strView.SubString(12, 4));
+    TEST(strCopy == "info");
+    TEST(strCopy == strView.SubString(12, 4));
+    TEST(strCopy != strView);
+    strCopy = strView.SubString(0, 10);
+    TEST(strCopy == "2015-06-01");
+    strCopy += strView.SubString(10, 7);
+    TEST(strCopy == "2015-06-01 [info]");
+  }
+
+  TESTS("StringBuilder")
+  {
+    StringBuilder sb;
+    TEST(sb.Length() == 0);
+    TEST(sb.ToString() == "");
+
+    String strName = "libscratch";
+    sb.Append("Hello ").Append(strName).Append(strName.View(3, 7)).Append('!');
+    sb += "";
+    sb += (const char*)NULL;
+    TEST(sb.Length() == 24);
+    TEST(sb.ToString() == "Hello libscratchscratch!");
+
+    // Lots of fragments end up spread over several chunks
+    String strExpected;
+    for(int i=0; i<10000; i++) {
+      sb += "0123456789";
+      sb += 'x';
+      strExpected += "0123456789";
+      strExpected += 'x';
+    }
+    TEST_PRIVATE(sb.sb_pFirst != sb.sb_pLast);
+    String strBuilt = sb.ToString();
+    TEST(strBuilt.Length() == 24 + 110000);
+    TEST(strBuilt.SubString(24) == strExpected);
+
+    // A fragment that is bigger than a chunk still fits
+    String strLarge;
+    strLarge.Fill('y', CSTRINGBUILDER_MAX_CHUNK_SIZE + 10);
+    sb += strLarge;
+    TEST(sb.Length() == strBuilt.Length() + strLarge.Length());
+
+    int ctAllocations = g_ctAllocations;
+    strBuilt = sb.ToString();
+    TEST(g_ctAllocations == ctAllocations + 1);
+    TEST(strBuilt.IndexOf('y') == 24 + 110000 && strBuilt.EndsWith("yyyy"));
+
+    StringBuilder sbMoved(std::move(sb));
+    TEST(sb.Length() == 0 && sbMoved.Length() == strBuilt.Length());
+    sb = std::move(sbMoved);
+    TEST(sb.ToString() == strBuilt);
+
+    sb.Clear();
+    TEST(sb.Length() == 0);
+    sb += "again";
+    TEST(sb.ToString() == "again");
+  }
+
+  TESTS("StringSearch")
+  {
+    // Build a haystack with plenty of near-misses for every kernel
+    char szHaystack[301];
+    for(int i=0; i<300; i++) {
+      szHaystack[i] = "abcab"[i % 5];
+    }
+    szHaystack[300] = '\0';
+    szHaystack[7] = 'x';
+    szHaystack[250] = 'x';
+    szHaystack[251] = 'y';
+    szHaystack[252] = 'z';
+
+    EStringSearchLevel esslBest = strSearchGetLevel();
+    for(int iLevel=ESSL_SCALAR; iLevel<=esslBest; iLevel++) {
+      strSearchSetLevel((EStringSearchLevel)iLevel);
+      printf("Search level %d\n", iLevel);
+
+      TEST(strFindChar(szHaystack, 300, 'x') == szHaystack + 7);
+      TEST(strFindChar(szHaystack, 7, 'x') == NULL);
+      TEST(strFindChar(szHaystack + 8, 292, 'z') == szHaystack + 252);
+      TEST(strFindCharLast(szHaystack, 300, 'x') == szHaystack + 250);
+      TEST(strFindCharLast(szHaystack, 250, 'x') == szHaystack + 7);
+      TEST(strFindCharLast(szHaystack, 300, 'q') == NULL);
+
+      TEST(strFind(szHaystack, 300, "xyz", 3) == szHaystack + 250);
+      TEST(strFind(szHaystack, 252, "xyz", 3) == NULL);
+      TEST(strFind(szHaystack, 300, "bcaba", 5) == szHaystack + 1);
+      TEST(strFind(szHaystack + 200, 100, "abcab", 5) == szHaystack + 200);
+      TEST(strFind(szHaystack, 300, "abcabd", 6) == NULL);
+      TEST(strFindLast(szHaystack, 300, "abcab", 5) == szHaystack + 295);
+      TEST(strFindLast(szHaystack, 250, "cab", 3) == szHaystack + 247);
+      TEST(strFindLast(szHaystack, 300, "xyz", 3) == szHaystack + 250);
+      TEST(strFindLast(szHaystack, 20, "xyz", 3) == NULL);
+
+      // Check every needle position against a plain loop
+      bool bAllFound = true;
+      for(int iLen=0; iLen<100; iLen++) {
+        for(int i=0; i<iLen; i++) {
+          char szBuffer[100];
+          memset(szBuffer, '.', iLen);
+          szBuffer[i] = '!';
+          szBuffer[iLen - 1 - (iLen - 1 - i) / 2] = '!';
+          int iFirst = i;
+          int iLast = iLen - 1 - (iLen - 1 - i) / 2;
+          bAllFound &= strFindChar(szBuffer, iLen, '!') == szBuffer + iFirst;
+          bAllFound &= strFindCharLast(szBuffer, iLen, '!') == szBuffer + iLast;
+          if(i + 1 < iLen) {
+            szBuffer[i + 1] = '?';
+            bAllFound &= strFind(szBuffer, iLen, "!?", 2) == szBuffer + i;
+            bAllFound &= strFindLast(szBuffer, iLen, "!?", 2) == szBuffer + i;
+          }
+        }
+      }
+      TEST(bAllFound);
+
+      // Case folding leaves everything but letters alone, including bytes from 0x80 up
+      char szMixed[] = "Hello, World! @[`{ \xC9\xE9 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz";
+      int iMixedLen = (int)strlen(szMixed);
+      char szFolded[sizeof(szMixed)];
+      strToLower(szFolded, szMixed, iMixedLen);
+      TEST(!memcmp(szFolded, "hello, world! @[`{ \xC9\xE9 0123456789 abcdefghijklmnopqrstuvwxyz abcdefghijklmnopqrstuvwxyz", iMixedLen));
+      strToUpper(szFolded, szMixed, iMixedLen);
+      TEST(!memcmp(szFolded, "HELLO, WORLD! @[`{ \xC9\xE9 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ ABCDEFGHIJKLMNOPQRSTUVWXYZ", iMixedLen));
+
+      // Check every mismatch position
+      bool bAllMismatches = true;
+      for(int iLen=0; iLen<100; iLen++) {
+        char szLower[100];
+        char szUpper[100];
+        for(int i=0; i<iLen; i++) {
+          szLower[i] = 'a' + i % 26;
+          szUpper[i] = 'A' + i % 26;
+        }
+        bAllMismatches &= strMismatchIgnoreCase(szLower, szUpper, iLen) == iLen;
+        for(int i=0; i<iLen; i++) {
+          szUpper[i] = '@';
+          bAllMismatches &= strMismatchIgnoreCase(szLower, szUpper, iLen) == i;
+          szUpper[i] = 'A' + i % 26;
+        }
+      }
+      TEST(bAllMismatches);
+    }
+    strSearchSetLevel(esslBest);
+
+    String strFoo = "one, two, three, two";
+    TEST(strFoo.IndexOf("two") == 5);
+    TEST(strFoo.IndexOfLast("two") == 17);
+    TEST(strFoo.IndexOf(',') == 3);
+    TEST(strFoo.IndexOfLast(',') == 15);
+    TEST(strFoo.Replace("two", "2") == "one, 2, three, 2");
+    TEST(strFoo.Replace("", "2") == strFoo);
+  }
+
+  TESTS("StringConvert")
+  {
+    String strFoo = "x=";
+    strFoo.AppendInt(-42);
+    strFoo += ' ';
+    strFoo.AppendUInt(18446744073709551615ULL);
+    strFoo += ' ';
+    strFoo.AppendHex(0xBEEF);
+    TEST(strFoo == "x=-42 18446744073709551615 beef");
+
+    strFoo = "";
+    strFoo.AppendInt(-9223372036854775807LL - 1);
+    TEST(strFoo == "-9223372036854775808");
+    strFoo = "";
+    strFoo.AppendInt(0);
+    TEST_PRIVATE(strFoo == "0" && strFoo.str_szBuffer == strFoo.str_acInline);
+
+    // Floats use the shortest form that reads back as the same value
+    strFoo = "";
+    strFoo.AppendDouble(0.1);
+    TEST(strFoo == "0.1");
+    strFoo = "";
+    strFoo.AppendDouble(0.1 + 0.2);
+    TEST(strFoo == "0.30000000000000004");
+    strFoo = "";
+    strFoo.AppendFloat(0.1f);
+    TEST(strFoo == "0.1");
+    strFoo = "";
+    strFoo.AppendFloat(1.0f / 3.0f);
+    TEST(strFoo == "0.33333334");
+
+    char acBuffer[STRINGCONVERT_MAX_CHARS];
+    TEST(String(acBuffer, 0, strFromDouble(acBuffer, 100.0)) == "100");
+    TEST(String(acBuffer, 0, strFromDouble(acBuffer, -1.5e-7)) == "-1.5e-7");
+    TEST(String(acBuffer, 0, strFromDouble(acBuffer, 1e21)) == "1e+21");
+    TEST(String(acBuffer, 0, strFromDouble(acBuffer, 1.7976931348623157e308)) == "1.7976931348623157e+308");
+    TEST(String(acBuffer, 0, strFromDouble(acBuffer, 5e-324)) == "5e-324");
+    TEST(String(acBuffer, 0, strFromDouble(acBuffer, -0.0)) == "-0");
+    TEST(String(acBuffer, 0, strFromDouble(acBuffer, 1.0 / 0.0)) == "inf");
+
+    // Every double we write has to read back exactly
+    double dValue = 1.0;
+    BOOL bAllRoundTrip = TRUE;
+    for(int i=0; i<2000; i++) {
+      dValue = dValue * -1.37 + 1.0 / (i + 3);
+      double dParsed = 0;
+      bAllRoundTrip &= strToDouble(acBuffer, strFromDouble(acBuffer, dValue), dParsed) && dParsed == dValue;
+    }
+    TEST(bAllRoundTrip);
+
+    int iValue = 0;
+    long long llValue = 0;
+    TEST(String("-123").ParseInt(iValue) && iValue == -123);
+    TEST(String("+7").ParseInt(iValue) && iValue == 7);
+    TEST(!String("2147483648").ParseInt(iValue));
+    TEST(String("2147483648").ParseInt(llValue) && llValue == 2147483648LL);
+    TEST(String("-9223372036854775808").ParseInt(llValue) && llValue == -9223372036854775807LL - 1);
+    TEST(!String("9223372036854775808").ParseInt(llValue));
+    TEST(!String("").ParseInt(iValue) && !String("-").ParseInt(iValue));
+    TEST(!String("12a").ParseInt(iValue) && !String(" 12").ParseInt(iValue));
+
+    float fValue = 0;
+    dValue = 0;
+    TEST(String("0.1").ParseFloat(dValue) && dValue == 0.1);
+    TEST(String("-2.5e3").ParseFloat(dValue) && dValue == -2500.0);
+    TEST(String("1.7976931348623157e308").ParseFloat(dValue) && dValue == 1.7976931348623157e308);
+    TEST(String("0.30000000000000004").ParseFloat(dValue) && dValue == 0.1 + 0.2);
+    TEST(String("3.14159").ParseFloat(fValue) && fValue == 3.14159f);
+    TEST(String("1e-50").ParseFloat(dValue) && dValue == 1e-50);
+    TEST(!String("1e400").ParseFloat(dValue));
+    TEST(!String("1.2.3").ParseFloat(dValue) && !String("1e").ParseFloat(dValue) && !String(".").ParseFloat(dValue));
+
+    // The numbers the C library parses don't depend on the decimal separator of the current locale
+    if(setlocale(LC_NUMERIC, "de_DE.UTF-8") != NULL || setlocale(LC_NUMERIC, "de_DE") != NULL) {
+      TEST(String("1.5e-50").ParseFloat(dValue) && dValue == 1.5e-50);
+      TEST(String("0.123456789012").ParseFloat(fValue) && fValue == 0.123456789012f);
+      setlocale(LC_NUMERIC, "C");
+    }
+
+    int ctAllocations = g_ctAllocations;
+    for(int i=0; i<100; i++) {
+      String("12345").ParseInt(iValue);
+      String("123.45").ParseFloat(dValue);
+    }
+    TEST(g_ctAllocations == ctAllocations);
+  }
+
+  TESTS("StringUtf8")
+  {
+    // Sequences that are valid, followed by ones that break a rule somewhere
+    const char* aszValid[] = { "", "abc", "\xC2\xA0", "\xDF\xBF", "\xE0\xA0\x80", "\xED\x9F\xBF", "\xEF\xBF\xBD", "\xF0\x90\x80\x80", "\xF4\x8F\xBF\xBF" };
+    const int actValidCodepoints[] = { 0, 3, 1, 1, 1, 1, 1, 1, 1 };
+    const char* aszInvalid[] = {
+      "\x80", "\xBF", "\xC0\xAF", "\xC1\xBF", "\xC2", "\xC2\x41", "\xE0\x9F\xBF", "\xE1\x80", "\xED\xA0\x80",
+      "\xF0\x8F\xBF\xBF", "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xF8\x88\x80\x80\x80", "\xFF", "\xF0\x90\x80",
+    };
+
+    EStringSearchLevel esslBest = strSearchGetLevel();
+    for(int iLevel=ESSL_SCALAR; iLevel<=esslBest; iLevel++) {
+      strSearchSetLevel((EStringSearchLevel)iLevel);
+      printf("Search level %d\n", iLevel);
+
+      // Put every sequence at every position of a buffer, so it lands on block boundaries too
+      bool bAllValid = true;
+      bool bAllInvalid = true;
+      bool bAllCounted = true;
+      char acBuffer[160];
+      for(int iPos=0; iPos<80; iPos++) {
+        for(int i=0; i<(int)(sizeof(aszValid) / sizeof(aszValid[0])); i++) {
+          int iSeqLen = (int)strlen(aszValid[i]);
+          memset(acBuffer, 'a', sizeof(acBuffer));
+          memcpy(acBuffer + iPos, aszValid[i], iSeqLen);
+          bAllValid &= strUtf8Validate(acBuffer, sizeof(acBuffer)) == sizeof(acBuffer);
+          bAllValid &= strUtf8Validate(acBuffer, iPos + iSeqLen) == iPos + iSeqLen;
+          bAllCounted &= strUtf8Count(acBuffer, sizeof(acBuffer)) == (int)sizeof(acBuffer) - iSeqLen + actValidCodepoints[i];
+        }
+        for(int i=0; i<(int)(sizeof(aszInvalid) / sizeof(aszInvalid[0])); i++) {
+          int iSeqLen = (int)strlen(aszInvalid[i]);
+          memset(acBuffer, 'a', sizeof(acBuffer));
+          memcpy(acBuffer + iPos, aszInvalid[i], iSeqLen);
+          bAllInvalid &= strUtf8Validate(acBuffer, sizeof(acBuffer)) == iPos;
+          bAllInvalid &= strUtf8Validate(acBuffer, iPos + iSeqLen) == iPos;
+        }
+      }
+      TEST(bAllValid);
+      TEST(bAllInvalid);
+      TEST(bAllCounted);
+
+      // Random mixes of valid and broken text have to agree with the scalar validator
+      bool bAllAgree = true;
+      unsigned int iSeed = 12345;
+      for(int iRound=0; iRound<2000; iRound++) {
+        int iLen = 0;
+        while(iLen < 150) {
+          iSeed = iSeed * 1103515245 + 12345;
+          unsigned int iRandom = iSeed >> 8;
+          if(iRandom % 64 == 0) {
+            acBuffer[iLen++] = (char)(iRandom >> 8);
+          } else {
+            iLen += strUtf8Encode(acBuffer + iLen, (iRandom >> 6) % ((iRandom & 3) == 0 ? 0x110000 : 0x800));
+          }
+        }
+        int iExpected = iLen;
+        for(int i=0; i<iLen; ) {
+          int iSize;
+          if(strUtf8Decode(acBuffer + i, iLen - i, iSize) == STRINGUTF8_REPLACEMENT && !(iSize == 3 && (UBYTE)acBuffer[i] == 0xEF)) {
+            iExpected = i;
+            break;
+          }
+          i += iSize;
+        }
+        bAllAgree &= strUtf8Validate(acBuffer, iLen) == iExpected;
+      }
+      TEST(bAllAgree);
+    }
+    strSearchSetLevel(esslBest);
+
+    // Every codepoint survives a round trip, surrogates and anything too large become the replacement
+    bool bRoundTrip = true;
+    for(unsigned int iCodepoint=0; iCodepoint<0x110000; iCodepoint++) {
+      char acEncoded[STRINGUTF8_MAX_BYTES];
+      int iSize = strUtf8Encode(acEncoded, iCodepoint);
+      int iDecodedSize;
+      unsigned int iExpected = (iCodepoint >= 0xD800 && iCodepoint <= 0xDFFF) ? STRINGUTF8_REPLACEMENT : iCodepoint;
+      bRoundTrip &= strUtf8Decode(acEncoded, iSize, iDecodedSize) == iExpected && iDecodedSize == iSize;
+      bRoundTrip &= strUtf8Previous(acEncoded, iSize) == 0;
+    }
+    TEST(bRoundTrip);
+    char acTooLarge[STRINGUTF8_MAX_BYTES];
+    TEST(strUtf8Encode(acTooLarge, 0x110000) == 3 && memcmp(acTooLarge, "\xEF\xBF\xBD", 3) == 0);
+
+    // String and StringView never split a character
+    String strText = "na\xC3\xAFve \xE6\x97\xA5\xE6\x9C\xAC \xF0\x9F\x98\x80!";
+    TEST(strText.IsValidUtf8());
+    TEST(strText.Length() == 19);
+    TEST(strText.Utf8Length() == 11);
+    TEST(strText.Utf8SubString(2, 3) == "\xC3\xAFve");
+    TEST(strText.Utf8SubString(6, 2) == "\xE6\x97\xA5\xE6\x9C\xAC");
+    TEST(strText.Utf8SubString(9) == "\xF0\x9F\x98\x80!");
+    TEST(strText.Utf8SubString(9, 100) == "\xF0\x9F\x98\x80!");
+    TEST(strText.Utf8SubString(11) == "");
+    TEST(strText.Utf8SubString(-1, 2) == "na");
+    TEST(strText.View().Utf8SubString(3, 0).Length() == 0);
+    TEST(!String("abc\xC3").IsValidUtf8());
+
+    String strSpaced = "\xE3\x80\x80 \t\xC2\xA0value\xE2\x80\x83\r\n";
+    TEST(strSpaced.Utf8Trim() == "value");
+    TEST(strSpaced.Utf8TrimLeft() == "value\xE2\x80\x83\r\n");
+    TEST(strSpaced.Utf8TrimRight() == "\xE3\x80\x80 \t\xC2\xA0value");
+    TEST(String("\xC2\xA0\xC2\xA0").Utf8Trim() == "");
+    TEST(String("\x80\xA0").Utf8TrimRight() == "\x80\xA0");
+
+    // Iterating hands out codepoints, and broken bytes one at a time
+    StringView strRemaining = "a\xC3\xA9\xF0\x9F\x98\x80\xE6\x97";
+    unsigned int aiCodepoints[8];
+    int ctCodepoints = 0;
+    while(ctCodepoints < 8 && strRemaining.NextCodepoint(aiCodepoints[ctCodepoints])) {
+      ctCodepoints++;
+    }
+    TEST(ctCodepoints == 5);
+    TEST(aiCodepoints[0] == 'a' && aiCodepoints[1] == 0xE9 && aiCodepoints[2] == 0x1F600);
+    TEST(aiCodepoints[3] == STRINGUTF8_REPLACEMENT && aiCodepoints[4] == STRINGUTF8_REPLACEMENT);
+
+    String strBuilt;
+    for(int i=0; i<ctCodepoints; i++) {
+      strBuilt.AppendCodepoint(aiCodepoints[i]);
+    }
+    TEST(strBuilt == "a\xC3\xA9\xF0\x9F\x98\x80\xEF\xBF\xBD\xEF\xBF\xBD");
+  }
+
+  TESTS("StringFormat")
+  {
+    String strName = "libscratch";
+    String strFoo = strFormat("%s has %d items at %f", strName, 42, 0.5);
+    TEST(strFoo == "libscratch has 42 items at 0.5");
+    strFoo.Format("[%5d|%-5d|%05d|%x|%X|%c|%%]", 42, 42, -42, 255u, 255u, 'z');
+    TEST(strFoo == "[   42|42   |-0042|ff|FF|z|%]");
+    strFoo.Format("%.3f %.1e %.2s %8s", 3.14159, 12345.0, "abc", "right");
+    TEST(strFoo == "3.142 1.2e+04 ab    right");
+    strFoo.Format("%x %d %u", -1, (short)-5, 18446744073709551615ULL);
+    TEST(strFoo == "ffffffff -5 18446744073709551615");
+
+    // Arguments are written as what they are, so mismatches can't crash at runtime
+    strFoo.Format("%s %d %s", 1.5f, "text");
+    TEST(strFoo == "1.5 text ");
+
+    // Formatting a string into itself
+    strFoo = "abc";
+    strFoo.AppendFormat("%s%20s", strFoo, strFoo);
+    TEST(strFoo == "abcabc                 abc");
+    strFoo.Format("<%s>", strFoo);
+    TEST(strFoo == "<abcabc                 abc>");
+
+    // Room for everything is reserved up front
+    int ctAllocations = g_ctAllocations;
+    strFoo = SCRATCH_FORMAT("%s [%s] %s:%d took %f ms", "2015-06-01 12:00:00", "info", "Scratch/CString.cpp", 1178, 0.25);
+    TEST(g_ctAllocations == ctAllocations + 1);
+    TEST(strFoo == "2015-06-01 12:00:00 [info] Scratch/CString.cpp:1178 took 0.25 ms");
+    SCRATCH_APPEND_FORMAT(strFoo, "!%c", '!');
+    TEST(strFoo.EndsWith("ms!!"));
+
+    // The checks behind SCRATCH_FORMAT, which fail the build instead of these tests
+    TEST(decltype(strFormatCheckerFor("", 1, "a"))::Check("%5d %-10s") == true);
+    TEST(decltype(strFormatCheckerFor("", 1, "a"))::Check("%s %d") == false);
+    TEST(decltype(strFormatCheckerFor("", 1))::Check("%d %d") == false);
+    TEST(decltype(strFormatCheckerFor("", 1, 2))::Check("%d%%") == false);
+    TEST(decltype(strFormatCheckerFor("", strName, 1.0f, 'c'))::Check("%%%s %.2f %c") == true);
+    TEST(decltype(strFormatCheckerFor("", 'a', 'b', 'c', 'd', 'e'))::Check("%d %i %u %x %X") == true);
+    TEST(decltype(strFormatCheckerFor(""))::Check("100%%") == true);
+    TEST(decltype(strFormatCheckerFor(""))::Check("%d") == false);
+
+    // Characters are written as their code by the integer placeholders, like printf does
+    TEST(SCRATCH_FORMAT("%d", 'a') == "97");
+    TEST(SCRATCH_FORMAT("%x %c", 'a', 98) == "61 b");
+
+    // Format strings without any arguments
+    TEST(SCRATCH_FORMAT("plain") == "plain");
+    TEST(SCRATCH_FORMAT("100%%") == "100%");
+    strFoo = "a";
+    SCRATCH_APPEND_FORMAT(strFoo, "b");
+    TEST(strFoo == "ab");
+  }
+
+  TESTS("StringPool")
+  {
+    StringPool sp;
+    String strKey = "hostname";
+    InternedString istrFoo = sp.Intern("hostname");
+    InternedString istrBar = sp.Intern(strKey);
+    InternedString istrOther = sp.Intern(strKey.View(0, 4));
+    TEST(istrFoo == istrBar && (const char*)istrFoo == (const char*)istrBar);
+    TEST(istrFoo != istrOther && istrOther == "host");
+    TEST(istrFoo == "hostname" && istrFoo != "host" && istrFoo.Length() == 8);
+    TEST(istrFoo.Hash() == istrBar.Hash() && sp.Count() == 2);
+    TEST(sp.Intern("") == InternedString() && InternedString().Length() == 0);
+    TEST(InternedString().Hash() == (unsigned int)hashBytes("", 0));
+
+    InternedString istrFound;
+    TEST(sp.Find("host", istrFound) && istrFound == istrOther);
+    TEST(!sp.Find("port", istrFound) && sp.Count() == 2);
+
+    // Enough strings to grow every shard a few times, each stored once
+    StackArray<InternedString> aistrKeys;
+    for(int i=0; i<5000; i++) {
+      aistrKeys.Push() = sp.Intern(strPrintF("key %d", i));
+    }
+    bool bSame = true;
+    for(int i=0; i<5000; i++) {
+      bSame &= sp.Intern(strPrintF("key %d", i)) == aistrKeys[i] && aistrKeys[i] == strPrintF("key %d", i);
+    }
+    TEST(bSame && sp.Count() == 5002);
+
+    String strBig;
+    strBig.Fill('x', 100000);
+    TEST(sp.Intern(strBig) == sp.Intern(strBig) && sp.Intern(strBig).Length() == 100000);
+
+    // Handles from the global pool
+    TEST(InternedString("global") == InternedString(String("global")));
+    TEST(InternedString("global") == StringPool::Global().Intern("global"));
+  }
+
+  TESTS("Hash")
+  {
+    String strKey = "configuration.network.hostname";
+    TEST(strKey.Hash() == hashBytes("configuration.network.hostname", 30));
+    TEST(strKey.Hash() == strKey.View().Hash() && Hasher<String>::Hash(strKey) == strKey.Hash());
+    TEST(Hasher<Filename>::Hash(Filename("foo/bar.c")) == String("foo/bar.c").Hash());
+    TEST(strKey.Hash() != strKey.View(0, 29).Hash() && String().Hash() != String("a").Hash());
+    TEST(strKey.Hash(1) != strKey.Hash(2) && strKey.Hash(1) == Hasher<String>::Hash(strKey, 1));
+    TEST(StringPool().Intern("").Hash() == (unsigned int)hashBytes("", 0));
+
+    // Every length takes a different path through the hash
+    char szMixed[200];
+    char szLower[200];
+    for(int i=0; i<200; i++) {
+      szMixed[i] = "aBcDeFgHiJkLmNoPqRsTuVwXyZ@[`{-0"[i % 32];
+      szLower[i] = "abcdefghijklmnopqrstuvwxyz@[`{-0"[i % 32];
+    }
+    bool bFoldedSame = true;
+    bool bAllDifferent = true;
+    for(int iLen=0; iLen<200; iLen++) {
+      bFoldedSame &= hashBytesIgnoreCase(szMixed, iLen) == hashBytes(szLower, iLen);
+      unsigned long long ulHash = hashBytes(szLower, iLen);
+      bAllDifferent &= ulHash != hashBytes(szLower, iLen + 1);
+      for(int i=0; i<iLen; i+=7) {
+        szLower[i] ^= 1;
+        bAllDifferent &= hashBytes(szLower, iLen) != ulHash;
+        szLower[i] ^= 1;
+      }
+    }
+    TEST(bFoldedSame && bAllDifferent);
+    TEST(String("Content-Type").HashIgnoreCase() == String("content-type").Hash());
+
+    TEST(Hasher<int>::Hash(42) == Hasher<long long>::Hash(42) && Hasher<int>::Hash(42) != Hasher<int>::Hash(43));
+    TEST(Hasher<unsigned int>::Hash(7, 1) != Hasher<unsigned int>::Hash(7, 2));
+    TEST(Hasher<Vector3f>::Hash(Vector3f(1, -0.0f, 3)) == Hasher<Vector3f>::Hash(Vector3f(1, 0, 3)));
+    TEST(Hasher<Vector3f>::Hash(Vector3f(1, 2, 3)) != Hasher<Vector3f>::Hash(Vector3f(3, 2, 1)));
+  }
+
+  TESTS("SyncString")
+  {
+    SyncString strFoo = "foo";
+    TEST(strFoo == "foo");
+    TEST(strFoo.Length() == 3);
+
+    strFoo += "bar";
+    strFoo += '!';
+    TEST(strFoo.Get() == "foobar!");
+
+    strFoo.Set("x");
+    TEST(strFoo != "foobar!");
+
+    strFoo.Access([](String &str) {
+      str *= 3;
+    });
+    TEST(strFoo == "xxx");
+
+    SyncString strBar = strFoo;
+    TEST(strBar == "xxx");
   }
 
   TESTS("Filename")
@@ -229,6 +1008,525 @@ MAIN
     TEST(!sa.Contains(25));
     TEST(sa.ContainsPointer(pNewInt));
     TEST(sa.ContainsAny([](int &i) { return i == 20; }));
+
+    StackArray<String> astrMoveFrom;
+    String strLarge;
+    strLarge.Fill('y', 1000);
+    int ctAllocations = g_ctAllocations;
+    astrMoveFrom.Push(std::move(strLarge));
+    TEST(g_ctAllocations == ctAllocations + 1); // only the new element, not its buffer
+    TEST(astrMoveFrom[0].Length() == 1000);
+
+    StackArray<String> astrMoveTo;
+    String* pstrFirst = &astrMoveFrom[0];
+    ctAllocations = g_ctAllocations;
+    astrMoveTo = std::move(astrMoveFrom);
+    TEST(g_ctAllocations == ctAllocations);
+    TEST(astrMoveTo.Count() == 1 && astrMoveFrom.Count() == 0);
+    TEST(&astrMoveTo[0] == pstrFirst);
+
+    // Slots are only allocated once something is pushed, and then grow geometrically
+    StackArray<int> aiSlots;
+    TEST(aiSlots.Capacity() == 0);
+    for(int i=0; i<1000; i++) {
+      aiSlots.Push() = i;
+    }
+    TEST(aiSlots.Capacity() >= 1000 && aiSlots.Capacity() < 2000);
+    aiSlots.PushBegin() = -1;
+    TEST(aiSlots[0] == -1 && aiSlots[1] == 0 && aiSlots[1000] == 999);
+    aiSlots.ShrinkToFit();
+    TEST(aiSlots.Capacity() == 1001 && aiSlots[1000] == 999);
+    aiSlots.Reserve(5000);
+    TEST(aiSlots.Capacity() == 5000 && aiSlots[500] == 499);
+    aiSlots.Clear();
+    aiSlots.ShrinkToFit();
+    TEST(aiSlots.Capacity() == 0);
+
+    // Removing many objects at once keeps the others in order and deletes the removed ones
+    StackArray<String> astrRemove;
+    for(int i=0; i<10; i++) {
+      astrRemove.Push() = strPrintF("a string that is too long to be stored inline %d", i);
+    }
+    int ctInstances = String::str_iInstances;
+    TEST(astrRemove.RemoveIf([](String &str) { return str.EndsWith("1") || str.EndsWith("4") || str.EndsWith("5"); }) == 3);
+    TEST(String::str_iInstances == ctInstances - 3);
+    TEST(astrRemove.Count() == 7 && astrRemove[1].EndsWith("2") && astrRemove[3].EndsWith("6"));
+    astrRemove.RemoveRange(1, 3);
+    TEST(String::str_iInstances == ctInstances - 6);
+    TEST(astrRemove.Count() == 4 && astrRemove[0].EndsWith("0") && astrRemove[1].EndsWith("7"));
+    astrRemove.RemoveRange(4, 0);
+    TEST(astrRemove.Count() == 4);
+    astrRemove.SwapRemoveAt(0);
+    TEST(String::str_iInstances == ctInstances - 7);
+    TEST(astrRemove.Count() == 3 && astrRemove[0].EndsWith("9") && astrRemove[2].EndsWith("8"));
+    astrRemove.SwapRemoveAt(2);
+    TEST(astrRemove.Count() == 2 && astrRemove[1].EndsWith("7"));
+    TEST(astrRemove.RemoveIf([](String &) { return false; }) == 0);
+    String* pstrPopped = astrRemove.PopAt(0);
+    TEST(pstrPopped->EndsWith("9"));
+    delete pstrPopped;
+    TEST(astrRemove.Count() == 1 && astrRemove[0].EndsWith("7"));
+
+    // Stacks that don't own their objects leave them alone
+    int aiOwned[4] = { 1, 2, 3, 4 };
+    StackArray<int> aiPointers;
+    aiPointers.sa_bOnlyPop = TRUE;
+    for(int i=0; i<4; i++) {
+      aiPointers.Push(&aiOwned[i]);
+    }
+    TEST(aiPointers.RemoveIf([](int &i) { return i % 2 == 0; }) == 2);
+    aiPointers.SwapRemoveAt(0);
+    TEST(aiPointers.Count() == 1 && aiPointers[0] == 3);
+
+    // Sorting moves the pointers, not the objects
+    StackArray<String> astrSort;
+    astrSort.Push() = "pear";
+    astrSort.Push() = "apple";
+    astrSort.Push() = "fig";
+    astrSort.Push() = "apples";
+    String* pstrApple = &astrSort[1];
+    astrSort.Sort();
+    TEST(astrSort[0] == "apple" && astrSort[1] == "apples" && astrSort[2] == "fig" && astrSort[3] == "pear");
+    TEST(&astrSort[0] == pstrApple);
+    TEST(astrSort.BinarySearch("fig") == 2);
+    TEST(astrSort.BinarySearch("grape") == -1);
+    TEST(astrSort.LowerBound("grape") == 3);
+    TEST(astrSort.LowerBound("zucchini") == 4);
+    astrSort.Sort([](const String &str1, const String &str2) { return str1.Length() > str2.Length(); });
+    TEST(astrSort[0] == "apples" && astrSort[3] == "fig");
+
+    // Stable sorting keeps equal objects in the order they were pushed
+    StackArray<String> astrStable;
+    astrStable.Push() = "bb";
+    astrStable.Push() = "a";
+    astrStable.Push() = "cc";
+    astrStable.Push() = "b";
+    astrStable.Push() = "aa";
+    auto fShorter = [](const String &str1, const String &str2) { return str1.Length() < str2.Length(); };
+    astrStable.StableSort(fShorter);
+    TEST(astrStable[0] == "a" && astrStable[1] == "b" && astrStable[2] == "bb" && astrStable[3] == "cc" && astrStable[4] == "aa");
+    TEST(astrStable.LowerBound("xx", fShorter) == 2);
+    TEST(astrStable.BinarySearch("xyz", fShorter) == -1);
+
+    // Sorting on multiple threads gives the same result as on one
+    StackArray<int> aiParallel, aiSerial;
+    srand(1234);
+    for(int i=0; i<100000; i++) {
+      int iValue = rand() % 50000;
+      aiParallel.Push() = iValue;
+      aiSerial.Push() = iValue;
+    }
+    aiSerial.Sort();
+    saParallelSort(aiParallel, 3);
+    bool bSame = aiParallel.Count() == aiSerial.Count();
+    for(int i=0; i<aiSerial.Count(); i++) {
+      bSame &= aiParallel[i] == aiSerial[i];
+    }
+    TEST(bSame);
+    ThreadPool poolSort(4);
+    saParallelSort(aiParallel, [](const int &i1, const int &i2) { return i1 > i2; }, 4, poolSort);
+    TEST(aiParallel[0] == aiSerial[99999] && aiParallel[99999] == aiSerial[0]);
+    TEST(aiParallel.BinarySearch(aiSerial[500], [](const int &i1, const int &i2) { return i1 > i2; }) != -1);
+
+    // Merges split into pieces still line up when most of the objects are equal
+    StackArray<int> aiTies, aiTiesSerial;
+    for(int i=0; i<100000; i++) {
+      int iValue = rand() % 3;
+      aiTies.Push() = iValue;
+      aiTiesSerial.Push() = iValue;
+    }
+    aiTiesSerial.Sort();
+    ThreadPool poolTies(7);
+    saParallelSort(aiTies, 7, poolTies);
+    bool bTiesSame = aiTies.Count() == aiTiesSerial.Count();
+    for(int i=0; i<aiTiesSerial.Count(); i++) {
+      bTiesSame &= aiTies[i] == aiTiesSerial[i];
+    }
+    TEST(bTiesSame);
+
+    // Range-for walks the objects in order, by reference
+    StackArray<int> aiRange;
+    int iRangeSum = 0;
+    for(int &i : aiRange) {
+      iRangeSum += i;
+    }
+    TEST(iRangeSum == 0 && aiRange.begin() == aiRange.end());
+    for(int i=1; i<=10; i++) {
+      aiRange.Push() = i;
+    }
+    for(int &i : aiRange) {
+      iRangeSum += i;
+      i *= 10;
+    }
+    TEST(iRangeSum == 55 && aiRange[0] == 10 && aiRange[9] == 100);
+    TEST(std::count_if(aiRange.begin(), aiRange.end(), [](int i) { return i > 50; }) == 5);
+    TEST(*std::find(aiRange.begin(), aiRange.end(), 70) == 70);
+    StackArray<String>::Iterator itSort = astrSort.begin();
+    TEST(itSort->Length() == 6 && (*itSort++) == "apples" && *itSort == astrSort[1]);
+  }
+
+  TESTS("Array")
+  {
+    Array<int> ai;
+    TEST(ai.Count() == 0 && ai.Capacity() == 0);
+
+    ai.Push() = 5;
+    TEST(ai.Count() == 1);
+    TEST(ai[0] == 5);
+
+    ai.PushBegin() = 10;
+    TEST(ai.Count() == 2);
+    TEST(ai[0] == 10 && ai[1] == 5);
+
+    ai.Push(15);
+    TEST(ai.Count() == 3);
+    TEST(ai[2] == 15);
+    TEST(&ai[2] == ai.Data() + 2);
+
+    TEST(ai.Pop() == 15);
+    TEST(ai.Count() == 2);
+    TEST(ai.PopAt(0) == 10);
+    TEST(ai.Count() == 1);
+    TEST(ai[0] == 5);
+
+    ai.Clear();
+    TEST(ai.Count() == 0 && ai.Capacity() > 0);
+
+    ai.Push(5);
+    ai.Push(10);
+    ai.Push(15);
+    ai.Push(20);
+    TEST(ai.Find(10) == 1);
+    TEST(ai.Find(25) == -1);
+    TEST(ai.FindAny([](int &i) { return i == 20; }) == 3);
+    TEST(ai.Contains(15));
+    TEST(!ai.Contains(25));
+    TEST(ai.ContainsAny([](int &i) { return i == 20; }));
+
+    // Growing keeps everything in order, and reserving up front means no more growing
+    Array<int> aiMany;
+    aiMany.Reserve(1000);
+    int* piFirst = aiMany.Data();
+    for(int i=0; i<1000; i++) {
+      aiMany.Push(i);
+    }
+    TEST(aiMany.Data() == piFirst && aiMany.Capacity() == 1000);
+    aiMany.Push(aiMany[0]);
+    bool bInOrder = aiMany.Count() == 1001 && aiMany[1000] == 0;
+    for(int i=0; i<1000; i++) {
+      bInOrder &= aiMany[i] == i;
+    }
+    TEST(bInOrder);
+
+    // Objects with constructors are moved around properly, and copies are deep
+    Array<String> astr;
+    for(int i=0; i<100; i++) {
+      astr.Push(strPrintF("a string that is too long to be stored inline %d", i));
+    }
+    astr.Push(astr[0]);
+    astr.PushBegin() = "first";
+    TEST(astr.Count() == 102);
+    TEST(astr[0] == "first" && astr[1] == "a string that is too long to be stored inline 0");
+    TEST(astr[101] == astr[1] && astr[100] == "a string that is too long to be stored inline 99");
+    TEST(astr.PopAt(1) == "a string that is too long to be stored inline 0");
+    TEST(astr[1] == "a string that is too long to be stored inline 1");
+    TEST(astr.Find("a string that is too long to be stored inline 50") == 50);
+
+    Array<String> astrCopy(astr);
+    astrCopy[0] = "changed";
+    TEST(astr[0] == "first" && astrCopy.Count() == astr.Count());
+
+    String* pstrFirst = &astrCopy[0];
+    Array<String> astrMoved;
+    astrMoved = std::move(astrCopy);
+    TEST(astrMoved.Count() == 101 && astrCopy.Count() == 0);
+    TEST(&astrMoved[0] == pstrFirst);
+
+    int ctInstances = String::str_iInstances;
+    astrMoved.Clear();
+    TEST(String::str_iInstances == ctInstances - 101);
+  }
+
+  TESTS("Deque")
+  {
+    Deque<int> ai;
+    TEST(ai.Count() == 0 && ai.Capacity() == 0);
+
+    ai.Push(5);
+    ai.PushBegin(10);
+    ai.Push() = 15;
+    ai.PushBegin() = 20;
+    TEST(ai.Count() == 4);
+    TEST(ai[0] == 20 && ai[1] == 10 && ai[2] == 5 && ai[3] == 15);
+
+    TEST(ai.PopBegin() == 20);
+    TEST(ai.Pop() == 15);
+    TEST(ai.Count() == 2);
+    TEST(ai[0] == 10 && ai[1] == 5);
+
+    TEST(ai.Find(5) == 1);
+    TEST(ai.Find(25) == -1);
+    TEST(ai.FindAny([](int &i) { return i == 10; }) == 0);
+    TEST(ai.Contains(10));
+    TEST(!ai.Contains(25));
+    TEST(ai.ContainsAny([](int &i) { return i == 5; }));
+
+    ai.Clear();
+    TEST(ai.Count() == 0 && ai.Capacity() > 0);
+
+    // Used as a queue the head walks around the memory, without growing it
+    INDEX ctSlots = ai.Capacity();
+    bool bInOrder = true;
+    for(int i=0; i<1000; i++) {
+      ai.Push(i);
+      ai.Push(i);
+      bInOrder &= ai.PopBegin() == i && ai.PopBegin() == i;
+    }
+    TEST(bInOrder && ai.Count() == 0 && ai.Capacity() == ctSlots);
+
+    // Growing while wrapped around keeps everything in order, and the blocks cover everything
+    for(int i=0; i<10; i++) {
+      ai.Push(i);
+    }
+    for(int i=1; i<=100; i++) {
+      ai.PushBegin(-i);
+    }
+    TEST(ai.Count() == 110 && ai[0] == -100 && ai[99] == -1 && ai[100] == 0 && ai[109] == 9);
+    bInOrder = true;
+    int iExpected = -100;
+    int ctBlocks = 0;
+    ai.ForEachBlock([&](int* pi, INDEX ct) {
+      ctBlocks++;
+      for(INDEX i=0; i<ct; i++) {
+        bInOrder &= pi[i] == iExpected++;
+      }
+    });
+    TEST(bInOrder && iExpected == 10 && ctBlocks >= 1 && ctBlocks <= 2);
+
+    ai.Clear();
+    ai.Push(1);
+    ai.PushBegin(0);
+    ctBlocks = 0;
+    ai.ForEachBlock([&](int*, INDEX) { ctBlocks++; });
+    TEST(ctBlocks == 2);
+
+    // Objects with constructors are moved around properly, and copies are deep
+    Deque<String> astr;
+    for(int i=0; i<50; i++) {
+      astr.Push(strPrintF("a string that is too long to be stored inline %d", i));
+      astr.PushBegin(strPrintF("a string that is too long to be stored inline %d", -i));
+    }
+    astr.Push(astr[0]);
+    TEST(astr.Count() == 101);
+    TEST(astr[0] == "a string that is too long to be stored inline -49");
+    TEST(astr[100] == astr[0] && astr[99] == "a string that is too long to be stored inline 49");
+    TEST(astr.PopBegin() == "a string that is too long to be stored inline -49");
+    TEST(astr.Find("a string that is too long to be stored inline 49") == 98);
+
+    Deque<String> astrCopy(astr);
+    astrCopy[0] = "changed";
+    TEST(astr[0] == "a string that is too long to be stored inline -48" && astrCopy.Count() == astr.Count());
+
+    String* pstrFirst = &astrCopy[0];
+    Deque<String> astrMoved;
+    astrMoved = std::move(astrCopy);
+    TEST(astrMoved.Count() == 100 && astrCopy.Count() == 0);
+    TEST(&astrMoved[0] == pstrFirst);
+
+    // Pushing one of our own objects into a full deque copies it before the memory moves
+    Deque<String> astrFull;
+    for(int i=0; i<16; i++) {
+      astrFull.Push(strPrintF("a string that is too long to be stored inline %d", i));
+    }
+    TEST(astrFull.Count() == astrFull.Capacity());
+    astrFull.PushBegin(astrFull[15]);
+    astrFull.Push(std::move(astrFull[1]));
+    TEST(astrFull[0] == "a string that is too long to be stored inline 15");
+    TEST(astrFull[17] == "a string that is too long to be stored inline 0" && astrFull.Count() == 18);
+
+    int ctInstances = String::str_iInstances;
+    astrMoved.Clear();
+    TEST(String::str_iInstances == ctInstances - 100);
+  }
+
+  TESTS("SmallArray")
+  {
+    // The first objects are stored inline, without allocating
+    SmallArray<int, 4> ai;
+    TEST(ai.Count() == 0 && ai.Capacity() == 4 && ai.IsInline());
+
+    int ctAllocations = g_ctAllocations;
+    ai.Push(5);
+    ai.Push() = 10;
+    ai.PushBegin() = 1;
+    ai.Push(15);
+    TEST(g_ctAllocations == ctAllocations && ai.IsInline());
+    TEST(ai.Count() == 4 && ai[0] == 1 && ai[1] == 5 && ai[3] == 15);
+
+    // Pushing past them moves everything to the heap
+    ai.Push(ai[0]);
+    TEST(!ai.IsInline() && ai.Count() == 5 && ai.Capacity() >= 5);
+    TEST(ai[0] == 1 && ai[4] == 1);
+
+    // Popping hands out new objects the caller deletes, like StackArray does
+    int* piPopped = ai.Pop();
+    TEST(*piPopped == 1);
+    delete piPopped;
+    piPopped = ai.PopAt(0);
+    TEST(*piPopped == 1);
+    ai.Push(piPopped);
+    TEST(ai.Count() == 4 && ai[0] == 5 && ai[3] == 1);
+    TEST(ai.RemoveIf([](int &i) { return i == 1; }) == 1);
+    TEST(ai.Count() == 3 && ai[0] == 5);
+    TEST(ai.FindPointer(&ai[2]) == 2 && !ai.ContainsPointer(&ctAllocations));
+
+    TEST(ai.Find(10) == 1);
+    TEST(ai.Find(25) == -1);
+    TEST(ai.FindAny([](int &i) { return i == 15; }) == 2);
+    TEST(ai.Contains(5));
+    TEST(!ai.Contains(25));
+    TEST(ai.ContainsAny([](int &i) { return i == 10; }));
+
+    // And shrinking moves them back when they fit
+    ai.ShrinkToFit();
+    TEST(ai.IsInline() && ai.Capacity() == 4 && ai[2] == 15);
+    int iSum = 0;
+    for(int i : ai) {
+      iSum += i;
+    }
+    TEST(iSum == 30);
+
+    // Objects with constructors are moved around properly, inline and on the heap
+    int ctInstances = String::str_iInstances;
+    {
+      SmallArray<String, 2> astr;
+      astr.Push("a string that is too long to be stored inline 0");
+      astr.Push("a string that is too long to be stored inline 1");
+      SmallArray<String, 2> astrInlineCopy(astr);
+      astrInlineCopy[0] = "changed";
+      TEST(astr[0] == "a string that is too long to be stored inline 0" && astrInlineCopy.IsInline());
+
+      SmallArray<String, 2> astrInlineMoved(std::move(astrInlineCopy));
+      TEST(astrInlineMoved.Count() == 2 && astrInlineCopy.Count() == 0);
+      TEST(astrInlineMoved[0] == "changed" && astrInlineMoved[1] == astr[1]);
+
+      for(int i=2; i<20; i++) {
+        astr.Push(strPrintF("a string that is too long to be stored inline %d", i));
+      }
+      astr.PushBegin() = "first";
+      TEST(astr.Count() == 21 && astr[0] == "first" && astr[20] == "a string that is too long to be stored inline 19");
+
+      String* pstrFirst = &astr[0];
+      SmallArray<String, 2> astrHeapMoved;
+      astrHeapMoved = std::move(astr);
+      TEST(&astrHeapMoved[0] == pstrFirst && astr.Count() == 0 && astr.IsInline());
+
+      astrHeapMoved = astrInlineMoved;
+      TEST(astrHeapMoved.Count() == 2 && astrHeapMoved[0] == "changed");
+      astrHeapMoved.ShrinkToFit();
+      TEST(astrHeapMoved.IsInline() && astrHeapMoved[1] == "a string that is too long to be stored inline 1");
+
+      // Removing keeps the order, and PopAll destroys the objects it can't hand back
+      astrHeapMoved.Push("a string that is too long to be stored inline 2");
+      TEST(astrHeapMoved.RemoveIf([](String &str) { return str == "changed"; }) == 1);
+      TEST(astrHeapMoved.Count() == 2 && astrHeapMoved[0] == "a string that is too long to be stored inline 1");
+      astrHeapMoved.PopAll();
+      TEST(astrHeapMoved.Count() == 0);
+    }
+    TEST(String::str_iInstances == ctInstances);
+
+    // Splitting into one gives the same parts as splitting into a StackArray
+    SmallArray<String, 4> astrParts;
+    String("host:8080").Split(":", astrParts);
+    TEST(astrParts.IsInline() && astrParts.Count() == 2 && astrParts[0] == "host" && astrParts[1] == "8080");
+
+    const char* aszSplit[] = { "", "a", "a,b", ",a,", "a,,b, c ,d, e " };
+    bool bSameParts = true;
+    for(int iSplit=0; iSplit<5; iSplit++) {
+      for(int iTrim=0; iTrim<2; iTrim++) {
+        StackArray<String> astrStack;
+        SmallArray<String, 2> astrSmall;
+        String(aszSplit[iSplit]).Split(",", astrStack, iTrim == 1);
+        String(aszSplit[iSplit]).Split(",", astrSmall, iTrim == 1);
+        bSameParts &= astrStack.Count() == astrSmall.Count();
+        for(int i=0; i<astrStack.Count() && i<astrSmall.Count(); i++) {
+          bSameParts &= astrStack[i] == astrSmall[i];
+        }
+      }
+    }
+    TEST(bSameParts);
+  }
+
+  TESTS("ConcurrentArray")
+  {
+    ConcurrentArray<int> ai;
+    TEST(ai.Count() == 0);
+
+    // The last segment ends at the largest index the array can hold, without its size overflowing
+    INDEX iLastOffset = 0;
+    TEST_PRIVATE(ConcurrentArray<int>::SegmentOf(CCONCURRENTARRAY_MAX_COUNT - 1, iLastOffset) == CCONCURRENTARRAY_SEGMENTS - 1);
+    TEST_PRIVATE(iLastOffset == ConcurrentArray<int>::SegmentSize(CCONCURRENTARRAY_SEGMENTS - 1) - 1 && iLastOffset > 0);
+
+    // Objects never move, even when the array grows past a bunch of segments
+    int &iFirst = ai.Push(0);
+    for(int i=1; i<10000; i++) {
+      ai.Push(i);
+    }
+    TEST(ai.Count() == 10000);
+    TEST(&ai[0] == &iFirst);
+    bool bInOrder = true;
+    for(int i=0; i<10000; i++) {
+      bInOrder &= ai[i] == i;
+    }
+    TEST(bInOrder);
+
+    ai.Clear();
+    TEST(ai.Count() == 0);
+    ai.Push() = 5;
+    TEST(ai.Count() == 1 && ai[0] == 5);
+
+    // Push from a bunch of threads while another one keeps reading everything that's ready
+    ConcurrentArray<String> astr;
+    const int ctThreads = 4;
+    const int ctPerThread = 5000;
+    std::atomic<bool> bReadsOK(true);
+    std::atomic<int> ctWritersDone(0);
+    std::thread thReader([&]() {
+      INDEX ctSeen = 0;
+      while(ctWritersDone.load() < ctThreads || ctSeen < astr.Count()) {
+        INDEX ctReady = astr.Count();
+        for(; ctSeen<ctReady; ctSeen++) {
+          if(!astr[ctSeen].StartsWith("writer ")) {
+            bReadsOK = false;
+          }
+        }
+        std::this_thread::yield();
+      }
+    });
+    std::thread athWriters[ctThreads];
+    for(int iThread=0; iThread<ctThreads; iThread++) {
+      athWriters[iThread] = std::thread([&astr, &ctWritersDone, iThread, ctPerThread]() {
+        for(int i=0; i<ctPerThread; i++) {
+          astr.Push(strPrintF("writer %d pushed a string that is too long to be inline %d", iThread, i));
+        }
+        ctWritersDone++;
+      });
+    }
+    for(int iThread=0; iThread<ctThreads; iThread++) {
+      athWriters[iThread].join();
+    }
+    thReader.join();
+    TEST(bReadsOK.load());
+    TEST(astr.Count() == ctThreads * ctPerThread);
+
+    // Every push made it in exactly once
+    bool bAllThere = true;
+    int aiNext[ctThreads] = { 0 };
+    for(INDEX i=0; i<astr.Count(); i++) {
+      int iThread = astr[i][7] - '0';
+      bAllThere &= astr[i] == strPrintF("writer %d pushed a string that is too long to be inline %d", iThread, aiNext[iThread]++);
+    }
+    TEST(bAllThere);
   }
 
   TESTS("Dictionary")
@@ -286,6 +1584,40 @@ MAIN
     dic["bar"] = 10;
     TEST(dic.GetKeyByIndex(0) == "foo");
     TEST(dic.GetValueByIndex(1) == 10);
+
+    Dictionary<String, String> dicMoveFrom;
+    dicMoveFrom.Add(String("key"), String("value"));
+    TEST(dicMoveFrom["key"] == "value");
+
+    Dictionary<String, String> dicMoveTo;
+    int ctAllocations = g_ctAllocations;
+    dicMoveTo = std::move(dicMoveFrom);
+    TEST(g_ctAllocations == ctAllocations);
+    TEST(dicMoveTo.Count() == 1 && dicMoveFrom.Count() == 0);
+    TEST(dicMoveTo["key"] == "value");
+
+    Dictionary<String, int> dicExpire;
+    for(int i=0; i<10; i++) {
+      dicExpire.Add(strPrintF("key%d", i), i);
+    }
+    TEST(dicExpire.RemoveIf([](String &strKey, int &iValue) { return iValue < 3 || strKey == "key5"; }) == 4);
+    TEST(dicExpire.Count() == 6 && !dicExpire.HasKey("key0") && !dicExpire.HasKey("key5"));
+    TEST(dicExpire.GetKeyByIndex(0) == "key3" && dicExpire.GetValueByIndex(2) == 6);
+    TEST_PRIVATE(dicExpire.dic_saKeys.sa_pItems[6] == NULL && dicExpire.dic_saValues.sa_pItems[9] == NULL);
+
+    // Range-for gives the keys and values together, in the order they were added
+    String strKeys;
+    int iValueSum = 0;
+    for(DictionaryPair<String, int> pair : dicExpire) {
+      strKeys += *pair.key;
+      iValueSum += *pair.value;
+      *pair.value = 0;
+    }
+    TEST(strKeys == "key3key4key6key7key8key9" && iValueSum == 37);
+    TEST(dicExpire["key9"] == 0);
+    Dictionary<String, int>::Iterator itPair = dicExpire.begin();
+    TEST(*itPair->key == "key3" && *(++itPair)->key == "key4");
+    TEST((std::is_same<std::iterator_traits<Dictionary<String, int>::Iterator>::iterator_category, std::input_iterator_tag>::value));
   }
 
   TESTS("FileStream")
@@ -324,6 +1656,34 @@ MAIN
     fsReader.Close();
   }
 
+  TESTS("MemoryStream")
+  {
+    MemoryStream ms;
+    ms << INDEX(5);
+    ms << String("test");
+    TEST(ms.Size() == sizeof(INDEX) + 5);
+
+    const UBYTE* pubBuffer = ms.strm_pubBuffer;
+    int ctAllocations = g_ctAllocations;
+    MemoryStream msMoved(std::move(ms));
+    TEST(g_ctAllocations == ctAllocations);
+    TEST(msMoved.strm_pubBuffer == pubBuffer && ms.strm_pubBuffer == NULL);
+    TEST(msMoved.Size() == sizeof(INDEX) + 5 && ms.Size() == 0);
+
+    MemoryStream msAssigned;
+    ctAllocations = g_ctAllocations;
+    msAssigned = std::move(msMoved);
+    TEST(g_ctAllocations == ctAllocations);
+    TEST(msAssigned.strm_pubBuffer == pubBuffer);
+
+    INDEX i;
+    String s;
+    msAssigned.Seek(0, SEEK_SET);
+    msAssigned >> i;
+    msAssigned >> s;
+    TEST(i == 5 && s == "test");
+  }
+
   TESTS("Mutex")
   {
     Mutex mutex;
@@ -344,6 +1704,70 @@ MAIN
     }
   }
 
+
+  TESTS("ThreadPool")
+  {
+    // Every index is handed out exactly once, in chunks no bigger than the grain
+    ThreadPool pool(4);
+    TEST(pool.ThreadCount() == 4);
+    std::atomic<int> aiVisited[1000];
+    for(int i=0; i<1000; i++) {
+      aiVisited[i] = 0;
+    }
+    std::atomic<int> ctChunks(0);
+    bool bSmallChunks = true;
+    pool.For(1000, 64, [&](INDEX iStart, INDEX iEnd) {
+      ctChunks++;
+      if(iEnd - iStart > 64) {
+        bSmallChunks = false;
+      }
+      for(INDEX i=iStart; i<iEnd; i++) {
+        aiVisited[i]++;
+      }
+    });
+    bool bOnce = true;
+    for(int i=0; i<1000; i++) {
+      bOnce &= aiVisited[i] == 1;
+    }
+    TEST(bOnce && bSmallChunks && ctChunks == 16);
+
+    // A range from inside a chunk runs on that thread instead of waiting on the pool
+    std::atomic<int> ctNested(0);
+    pool.For(8, 1, [&](INDEX, INDEX) {
+      pool.For(10, 2, [&](INDEX iStart, INDEX iEnd) {
+        ctNested += (int)(iEnd - iStart);
+      });
+    });
+    TEST(ctNested == 80);
+
+    StackArray<int> ai;
+    for(int i=0; i<100000; i++) {
+      ai.Push() = i;
+    }
+
+    saParallelForEach(ai, [](int &i) { i *= 2; }, 1000, pool);
+    TEST(ai[0] == 0 && ai[500] == 1000 && ai[99999] == 199998);
+
+    TEST(saParallelCount(ai, [](int &i) { return i % 6 == 0; }, 1000, pool) == 33334);
+    TEST(saParallelCount(ai, [](int &i) { return i < 0; }) == 0);
+
+    TEST(saParallelFindAny(ai, [](int &i) { return i > 150000; }, 100, pool) == 75001);
+    TEST(saParallelFindAny(ai, [](int &i) { return i % 2 == 1; }, 100, pool) == -1);
+    TEST(saParallelFindAny(ai, [](int &i) { return i == 0; }) == 0);
+
+    StackArray<String> astr;
+    saParallelTransform(ai, astr, [](int &i) { return strPrintF("%d", i); }, 1000, pool);
+    TEST(astr.Count() == 100000 && astr[0] == "0" && astr[12345] == "24690" && astr[99999] == "199998");
+
+    // Limiting the amount of threads still covers the whole range
+    std::atomic<INDEX> ctSum(0);
+    pool.For(1000, 10, [&](INDEX iStart, INDEX iEnd) { ctSum += iEnd - iStart; }, 2);
+    TEST(ctSum == 1000);
+
+    StackArray<int> aiEmpty;
+    TEST(saParallelFindAny(aiEmpty, [](int &) { return true; }) == -1);
+    TEST(saParallelCount(aiEmpty, [](int &) { return true; }) == 0);
+  }
   TESTS("Exception")
   {
     try {